@@ -0,0 +1,246 @@
+#ifndef CPPMATH_GEOMETRY_AABB_BATCH_HPP
+#define CPPMATH_GEOMETRY_AABB_BATCH_HPP
+
+#include <vector>
+#include "AABB.hpp"
+
+/*
+ * Moving AABBs stored as structure of arrays for batched sweeps.
+ * The batched sweeps test many pairs at once with the same slab test as
+ * sweep(AABB, vel, AABB, vel), but without branches, so compilers can
+ * vectorize the loops and test several pairs per instruction.
+ * A pair that doesn't collide within the time step gets an entry time of
+ * infinity. Results match the scalar sweep, including touching borders
+ * and pairs without relative movement. T must be a floating point type.
+ */
+
+namespace math
+{
+    template <typename T>
+    class AABBBatch
+    {
+        public:
+            AABBBatch() = default;
+            AABBBatch(size_t capacity);
+
+            void add(const AABB<T>& aabb, const Vec2<T>& vel = Vec2<T>());
+            void set(size_t i, const AABB<T>& aabb, const Vec2<T>& vel);
+            void clear();
+            void reserve(size_t capacity);
+
+            AABB<T> get(size_t i) const;
+            Vec2<T> getVelocity(size_t i) const;
+
+            size_t size() const;
+
+        public:
+            std::vector<T> x, y, w, h, vx, vy;
+    };
+
+    // Sweeps a[i] against b[i] for all i. Both batches must have the same
+    // size. Entry and exit times are written to near and far, far may be
+    // null.
+    // Existing content of near and far will be removed.
+    template <typename T>
+    void sweep(const AABBBatch<T>& a, const AABBBatch<T>& b, std::vector<T>* near, std::vector<T>* far = nullptr);
+
+    // Sweeps a single moving AABB against all AABBs of a batch.
+    // Existing content of near and far will be removed.
+    template <typename T>
+    void sweep(const AABB<T>& aabb, const Vec2<T>& vel, const AABBBatch<T>& others,
+               std::vector<T>* near, std::vector<T>* far = nullptr);
+}
+
+
+#include <limits>
+#include <algorithm>
+#include <cmath>
+#include <cassert>
+
+// Implementation
+namespace math
+{
+    namespace detail
+    {
+        const size_t sweepBlockSize = 64;
+
+        // Entry and exit time of a point moving by d through [min, max]
+        // along one axis. Like intersect(Line2, AABB), almost zero movement
+        // counts as none and the point is then inside if it lies in
+        // [min, max). Returns whether the point moves.
+        template <typename T>
+        inline bool sweepSlab(T p, T d, T min, T max, T* t0, T* t1)
+        {
+            // Only selects, no branches. Division by 0 gives infinity
+            // and is masked out.
+            const T inf = std::numeric_limits<T>::infinity();
+            const T inv = 1 / d;
+            const T ta = (min - p) * inv,
+                    tb = (max - p) * inv;
+            const bool moving = std::abs(d) >= epsilon<T>();
+            const bool inside = (p >= min) & (p < max);
+            const bool order = ta < tb;
+            const T lo = order ? ta : tb,
+                    hi = order ? tb : ta,
+                    in = inside ? -inf : inf;
+            *t0 = moving ? lo : in;
+            *t1 = moving ? hi : -in;
+            return moving;
+        }
+
+        // Same results as sweep(AABB, vel, AABB, vel): touching counts as a
+        // hit and pairs without relative movement never collide.
+        template <typename T>
+        inline void sweepBatched(T ax, T ay, T aw, T ah, T avx, T avy,
+                                 T bx, T by, T bw, T bh, T bvx, T bvy,
+                                 T* near, T* far)
+        {
+            // Move a's min corner through b grown by a's size
+            T x0, x1, y0, y1;
+            const bool movingx = sweepSlab(ax, avx - bvx, bx - aw, bx + bw, &x0, &x1),
+                       movingy = sweepSlab(ay, avy - bvy, by - ah, by + bh, &y0, &y1);
+
+            T t0 = x0 > y0 ? x0 : y0,
+              t1 = x1 < y1 ? x1 : y1;
+            t0 = t0 > 0 ? t0 : 0;
+            t1 = t1 < 1 ? t1 : 1;
+            const bool hit = (t0 <= t1) & (movingx | movingy);
+            *near = hit ? t0 : std::numeric_limits<T>::infinity();
+            *far = hit ? t1 : std::numeric_limits<T>::infinity();
+        }
+    }
+
+
+    template <typename T>
+    AABBBatch<T>::AABBBatch(size_t capacity)
+    {
+        reserve(capacity);
+    }
+
+    template <typename T>
+    void AABBBatch<T>::add(const AABB<T>& aabb, const Vec2<T>& vel)
+    {
+        x.push_back(aabb.x);
+        y.push_back(aabb.y);
+        w.push_back(aabb.w);
+        h.push_back(aabb.h);
+        vx.push_back(vel.x);
+        vy.push_back(vel.y);
+    }
+
+    template <typename T>
+    void AABBBatch<T>::set(size_t i, const AABB<T>& aabb, const Vec2<T>& vel)
+    {
+        x[i] = aabb.x;
+        y[i] = aabb.y;
+        w[i] = aabb.w;
+        h[i] = aabb.h;
+        vx[i] = vel.x;
+        vy[i] = vel.y;
+    }
+
+    template <typename T>
+    void AABBBatch<T>::clear()
+    {
+        x.clear();
+        y.clear();
+        w.clear();
+        h.clear();
+        vx.clear();
+        vy.clear();
+    }
+
+    template <typename T>
+    void AABBBatch<T>::reserve(size_t capacity)
+    {
+        x.reserve(capacity);
+        y.reserve(capacity);
+        w.reserve(capacity);
+        h.reserve(capacity);
+        vx.reserve(capacity);
+        vy.reserve(capacity);
+    }
+
+    template <typename T>
+    AABB<T> AABBBatch<T>::get(size_t i) const
+    {
+        return AABB<T>(x[i], y[i], w[i], h[i]);
+    }
+
+    template <typename T>
+    Vec2<T> AABBBatch<T>::getVelocity(size_t i) const
+    {
+        return Vec2<T>(vx[i], vy[i]);
+    }
+
+    template <typename T>
+    size_t AABBBatch<T>::size() const
+    {
+        return x.size();
+    }
+
+    template <typename T>
+    void sweep(const AABBBatch<T>& a, const AABBBatch<T>& b, std::vector<T>* near, std::vector<T>* far)
+    {
+        assert(near && "near is null");
+        assert(a.size() == b.size() && "batches differ in size");
+
+        const size_t n = a.size();
+        near->resize(n);
+        if (far)
+            far->resize(n);
+
+        // Results are written to local blocks first, so the compiler knows
+        // they don't alias the input.
+        T bnear[detail::sweepBlockSize], bfar[detail::sweepBlockSize];
+        for (size_t start = 0; start < n; start += detail::sweepBlockSize)
+        {
+            const size_t count = std::min(detail::sweepBlockSize, n - start);
+            const T *ax = &a.x[start], *ay = &a.y[start], *aw = &a.w[start], *ah = &a.h[start],
+                    *avx = &a.vx[start], *avy = &a.vy[start],
+                    *bx = &b.x[start], *by = &b.y[start], *bw = &b.w[start], *bh = &b.h[start],
+                    *bvx = &b.vx[start], *bvy = &b.vy[start];
+
+            for (size_t i = 0; i < count; ++i)
+                detail::sweepBatched(ax[i], ay[i], aw[i], ah[i], avx[i], avy[i],
+                                     bx[i], by[i], bw[i], bh[i], bvx[i], bvy[i], &bnear[i], &bfar[i]);
+
+            std::copy(bnear, bnear + count, near->begin() + start);
+            if (far)
+                std::copy(bfar, bfar + count, far->begin() + start);
+        }
+    }
+
+    template <typename T>
+    void sweep(const AABB<T>& aabb, const Vec2<T>& vel, const AABBBatch<T>& others,
+               std::vector<T>* near, std::vector<T>* far)
+    {
+        assert(near && "near is null");
+
+        const size_t n = others.size();
+        near->resize(n);
+        if (far)
+            far->resize(n);
+
+        const T ax = aabb.x, ay = aabb.y, aw = aabb.w, ah = aabb.h,
+                avx = vel.x, avy = vel.y;
+
+        T bnear[detail::sweepBlockSize], bfar[detail::sweepBlockSize];
+        for (size_t start = 0; start < n; start += detail::sweepBlockSize)
+        {
+            const size_t count = std::min(detail::sweepBlockSize, n - start);
+            const T *bx = &others.x[start], *by = &others.y[start], *bw = &others.w[start], *bh = &others.h[start],
+                    *bvx = &others.vx[start], *bvy = &others.vy[start];
+
+            for (size_t i = 0; i < count; ++i)
+                detail::sweepBatched(ax, ay, aw, ah, avx, avy,
+                                     bx[i], by[i], bw[i], bh[i], bvx[i], bvy[i], &bnear[i], &bfar[i]);
+
+            std::copy(bnear, bnear + count, near->begin() + start);
+            if (far)
+                std::copy(bfar, bfar + count, far->begin() + start);
+        }
+    }
+}
+
+#endif
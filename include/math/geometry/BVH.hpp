@@ -0,0 +1,476 @@
+#ifndef CPPMATH_GEOMETRY_BVH_HPP
+#define CPPMATH_GEOMETRY_BVH_HPP
+
+#include <vector>
+#include <cstdint>
+#include "Intersection.hpp"
+#include "AABB.hpp"
+
+/*
+ * A bounding volume hierarchy over a list of AABBs.
+ * The tree is built as a linear BVH (Karras, "Maximizing Parallelism in
+ * the Construction of BVHs, Octrees, and k-d Trees"): boxes are sorted
+ * by the Morton codes of their centers and every internal node is
+ * computed independently from the sorted codes, so the build runs in
+ * parallel in O(n).
+ * Nodes are stored in a flat array. For n boxes, nodes [0, n - 1) are
+ * internal nodes and nodes [n - 1, 2n - 1) are leaves. The root is
+ * always node 0.
+ * The tree's height is computed along with the bounding boxes. Traversals
+ * use a fixed-size stack on the stack if it is large enough, which is
+ * always the case for 32 bit Morton codes, and a heap stack otherwise.
+ * Query results are indices into the box list the tree was built from.
+ */
+
+namespace math
+{
+    template <typename T>
+    class BVH
+    {
+        public:
+            static const uint32_t npos = (uint32_t)-1;
+
+            struct Node
+            {
+                AABB<T> bbox;
+                uint32_t children[2];   // npos for leaves
+                uint32_t parent;        // npos for the root
+                uint32_t object;        // npos for internal nodes
+            };
+
+        public:
+            BVH();
+            BVH(const std::vector<AABB<T>>& boxes, size_t numthreads = 0);
+
+            // Rebuilds the tree using up to numthreads threads (0 = auto).
+            void build(const std::vector<AABB<T>>& boxes, size_t numthreads = 0);
+            void clear();
+
+            // Calls f for each box overlapping or touching the given area.
+            // Returning true breaks the loop.
+            // Callback signature: bool (size_t index)
+            template <typename F>
+            void query(const AABB<T>& range, F f) const;
+
+            // Same as above, but writes the results to out.
+            // Existing content of out will be removed.
+            void query(const AABB<T>& range, std::vector<size_t>* out) const;
+
+            // Finds all boxes containing the given point.
+            // Existing content of out will be removed.
+            void query(const Point2<T>& point, std::vector<size_t>* out) const;
+
+            // Returns the first box hit by a line in the same format as
+            // intersect(Line2, AABB).
+            Intersection<T> raycast(const Line2<T>& line, size_t* index = nullptr) const;
+
+            // Returns the first box hit by a moving AABB in the same format
+            // as sweep(AABB, Vec2, AABB).
+            Intersection<T> sweep(const AABB<T>& aabb, const Vec2<T>& vel, size_t* index = nullptr) const;
+
+            const std::vector<Node>& getNodes() const;
+
+            // Returns the amount of boxes.
+            size_t size() const;
+
+        protected:
+            // Traverses the tree depth-first, near child first.
+            // fnode(bbox) returns the entry time of a node or a negative
+            // value to skip it. fleaf(leaf) returns the hit time or a
+            // negative value. Nodes with an entry time >= the best time
+            // are skipped.
+            template <typename FNode, typename FLeaf>
+            void _traverseNearest(FNode fnode, FLeaf fleaf) const;
+
+            // Calls f(leaf) for all leaves overlapping or touching the
+            // area [min, max]. Returning true breaks the loop.
+            template <typename F>
+            void _query(const Vec2<T>& min, const Vec2<T>& max, F f) const;
+
+        protected:
+            // Traversal stack size that is kept on the stack
+            static const size_t localstacksize = 128;
+
+        protected:
+            std::vector<Node> _nodes;
+            size_t _size;
+            size_t _stacksize;
+    };
+}
+
+
+#include "morton.hpp"
+#include "intersect.hpp"
+#include "../threading.hpp"
+#include <atomic>
+#include <memory>
+#include <limits>
+#include <cassert>
+
+// Implementation
+namespace math
+{
+    namespace detail
+    {
+        inline int leadingZeros(uint32_t x)
+        {
+            if (x == 0)
+                return 32;
+#if defined(__GNUC__) || defined(__clang__)
+            return __builtin_clz(x);
+#else
+            int n = 0;
+            while (!(x & 0x80000000u))
+            {
+                x <<= 1;
+                ++n;
+            }
+            return n;
+#endif
+        }
+
+        // Length of the common prefix of the ith and jth key, using the
+        // indices as tie breaker. Returns -1 if j is out of range.
+        inline int bvhCommonPrefix(const std::vector<uint32_t>& codes, int i, int j)
+        {
+            if (j < 0 || j >= (int)codes.size())
+                return -1;
+            if (codes[i] == codes[j])
+                return 32 + leadingZeros(i ^ j);
+            return leadingZeros(codes[i] ^ codes[j]);
+        }
+    }
+
+
+    template <typename T>
+    const uint32_t BVH<T>::npos;
+
+    template <typename T>
+    const size_t BVH<T>::localstacksize;
+
+    template <typename T>
+    BVH<T>::BVH() :
+        _size(0),
+        _stacksize(0)
+    { }
+
+    template <typename T>
+    BVH<T>::BVH(const std::vector<AABB<T>>& boxes, size_t numthreads) :
+        _size(0),
+        _stacksize(0)
+    {
+        build(boxes, numthreads);
+    }
+
+    template <typename T>
+    void BVH<T>::build(const std::vector<AABB<T>>& boxes, size_t numthreads)
+    {
+        const int n = boxes.size();
+        _size = n;
+        _nodes.resize(n > 0 ? 2 * n - 1 : 0);
+        _stacksize = 1;
+        if (n == 0)
+            return;
+
+        // Sort by Morton codes of the box centers
+        Vec2<T> min = boxes[0].getCenter().asVector(),
+                max = min;
+        for (auto& box : boxes)
+        {
+            min = mins(min, box.getCenter().asVector());
+            max = maxs(max, box.getCenter().asVector());
+        }
+        const AABB<T> bounds(min.asPoint(), max - min);
+
+        std::vector<uint32_t> codes(n);
+        parallelFor(0, n, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i)
+                codes[i] = mortonCode(boxes[i], bounds);
+        }, numthreads, 4096);
+
+        std::vector<size_t> order;
+        radixSort(codes, &order, numthreads);
+        std::vector<uint32_t> sorted(n);
+        for (int i = 0; i < n; ++i)
+            sorted[i] = codes[order[i]];
+
+        const uint32_t leaves = n - 1;
+        _nodes[0].parent = npos;
+
+        parallelFor(0, n, [&](size_t begin, size_t end) {
+            for (size_t k = begin; k < end; ++k)
+            {
+                Node& leaf = _nodes[leaves + k];
+                leaf.bbox = boxes[order[k]];
+                leaf.children[0] = leaf.children[1] = npos;
+                leaf.object = order[k];
+            }
+        }, numthreads, 4096);
+
+        // Internal nodes
+        parallelFor(0, n - 1, [&](size_t begin, size_t end) {
+            for (int i = begin; i < (int)end; ++i)
+            {
+                // Direction of the range
+                int d = detail::bvhCommonPrefix(sorted, i, i + 1) - detail::bvhCommonPrefix(sorted, i, i - 1) > 0 ? 1 : -1;
+
+                // Upper bound of the range's length
+                int dmin = detail::bvhCommonPrefix(sorted, i, i - d);
+                int lmax = 2;
+                while (detail::bvhCommonPrefix(sorted, i, i + lmax * d) > dmin)
+                    lmax *= 2;
+
+                // Find the other end using binary search
+                int l = 0;
+                for (int t = lmax / 2; t >= 1; t /= 2)
+                    if (detail::bvhCommonPrefix(sorted, i, i + (l + t) * d) > dmin)
+                        l += t;
+                int j = i + l * d;
+
+                // Find the split position using binary search
+                int dnode = detail::bvhCommonPrefix(sorted, i, j);
+                int s = 0;
+                for (int div = 2, t = l; t > 1; div *= 2)
+                {
+                    t = (l + div - 1) / div;
+                    if (detail::bvhCommonPrefix(sorted, i, i + (s + t) * d) > dnode)
+                        s += t;
+                }
+                int split = i + s * d + std::min(d, 0);
+
+                Node& node = _nodes[i];
+                node.object = npos;
+                node.children[0] = std::min(i, j) == split ? leaves + split : split;
+                node.children[1] = std::max(i, j) == split + 1 ? leaves + split + 1 : split + 1;
+                _nodes[node.children[0]].parent = i;
+                _nodes[node.children[1]].parent = i;
+            }
+        }, numthreads, 4096);
+
+        // Bounding boxes and heights, bottom-up. The second child to arrive
+        // at a node computes its box and continues upwards.
+        std::unique_ptr<std::atomic<int>[]> visits(new std::atomic<int>[n]);
+        for (int i = 0; i < n; ++i)
+            visits[i].store(0, std::memory_order_relaxed);
+        std::vector<uint32_t> heights(2 * n - 1, 0);
+
+        parallelFor(0, n, [&](size_t begin, size_t end) {
+            for (size_t k = begin; k < end; ++k)
+            {
+                uint32_t cur = _nodes[leaves + k].parent;
+                while (cur != npos && visits[cur].fetch_add(1, std::memory_order_acq_rel) == 1)
+                {
+                    Node& node = _nodes[cur];
+                    const AABB<T>& a = _nodes[node.children[0]].bbox;
+                    const AABB<T>& b = _nodes[node.children[1]].bbox;
+                    Vec2<T> bmin = mins(a.pos, b.pos),
+                            bmax = maxs(a.pos + a.size, b.pos + b.size);
+                    node.bbox = AABB<T>(bmin.asPoint(), bmax - bmin);
+                    heights[cur] = 1 + std::max(heights[node.children[0]], heights[node.children[1]]);
+                    cur = node.parent;
+                }
+            }
+        }, numthreads, 4096);
+
+        // Depth-first traversals hold at most one sibling per level
+        _stacksize = heights[0] + 2;
+    }
+
+    template <typename T>
+    void BVH<T>::clear()
+    {
+        _nodes.clear();
+        _size = 0;
+        _stacksize = 0;
+    }
+
+    template <typename T>
+    template <typename F>
+    void BVH<T>::query(const AABB<T>& range, F f) const
+    {
+        _query(range.pos, range.pos + range.size, [&f](const Node& leaf) {
+            return f((size_t)leaf.object);
+        });
+    }
+
+    template <typename T>
+    template <typename F>
+    void BVH<T>::_query(const Vec2<T>& min, const Vec2<T>& max, F f) const
+    {
+        if (_nodes.empty())
+            return;
+
+        uint32_t local[localstacksize];
+        std::vector<uint32_t> heap;
+        uint32_t* stack = local;
+        if (_stacksize > localstacksize)
+        {
+            heap.resize(_stacksize);
+            stack = &heap[0];
+        }
+        size_t top = 0;
+        stack[top++] = 0;
+
+        while (top > 0)
+        {
+            const Node& node = _nodes[stack[--top]];
+            if (!(node.bbox.pos <= max && min <= node.bbox.pos + node.bbox.size))
+                continue;
+
+            if (node.object != npos)
+            {
+                if (f(node))
+                    return;
+            }
+            else
+            {
+                assert(top + 2 <= _stacksize && "BVH stack too small");
+                stack[top++] = node.children[1];
+                stack[top++] = node.children[0];
+            }
+        }
+    }
+
+    template <typename T>
+    void BVH<T>::query(const AABB<T>& range, std::vector<size_t>* out) const
+    {
+        assert(out && "out is null");
+        out->clear();
+        query(range, [out](size_t i) {
+            out->push_back(i);
+            return false;
+        });
+    }
+
+    template <typename T>
+    void BVH<T>::query(const Point2<T>& point, std::vector<size_t>* out) const
+    {
+        assert(out && "out is null");
+        out->clear();
+        _query(point.asVector(), point.asVector(), [&](const Node& leaf) {
+            if (intersect(leaf.bbox, point))
+                out->push_back(leaf.object);
+            return false;
+        });
+    }
+
+    template <typename T>
+    template <typename FNode, typename FLeaf>
+    void BVH<T>::_traverseNearest(FNode fnode, FLeaf fleaf) const
+    {
+        if (_nodes.empty())
+            return;
+
+        double best = std::numeric_limits<double>::infinity();
+        uint32_t local[localstacksize];
+        std::vector<uint32_t> heap;
+        uint32_t* stack = local;
+        if (_stacksize > localstacksize)
+        {
+            heap.resize(_stacksize);
+            stack = &heap[0];
+        }
+        size_t top = 0;
+        stack[top++] = 0;
+
+        while (top > 0)
+        {
+            const Node& node = _nodes[stack[--top]];
+
+            if (node.object != npos)
+            {
+                double t = fleaf(node);
+                if (t >= 0 && t < best)
+                    best = t;
+                continue;
+            }
+
+            double ta = fnode(_nodes[node.children[0]].bbox),
+                   tb = fnode(_nodes[node.children[1]].bbox);
+            uint32_t a = node.children[0],
+                     b = node.children[1];
+            if (tb >= 0 && (ta < 0 || tb < ta))
+            {
+                std::swap(a, b);
+                std::swap(ta, tb);
+            }
+
+            // Push the far child first, so the near one is visited first
+            assert(top + 2 <= _stacksize && "BVH stack too small");
+            if (tb >= 0 && tb < best)
+                stack[top++] = b;
+            if (ta >= 0 && ta < best)
+                stack[top++] = a;
+        }
+    }
+
+    template <typename T>
+    Intersection<T> BVH<T>::raycast(const Line2<T>& line, size_t* index) const
+    {
+        Intersection<T> best;
+
+        auto fnode = [&](const AABB<T>& bbox) {
+            auto isec = intersect(line, bbox);
+            return isec ? (double)isec.time : -1.0;
+        };
+
+        if (_nodes.empty() || fnode(_nodes[0].bbox) < 0)
+            return best;
+
+        _traverseNearest(fnode, [&](const Node& leaf) {
+            auto isec = intersect(line, leaf.bbox);
+            if (!isec || (best && isec.time >= best.time))
+                return -1.0;
+            best = isec;
+            if (index)
+                *index = leaf.object;
+            return (double)isec.time;
+        });
+        return best;
+    }
+
+    template <typename T>
+    Intersection<T> BVH<T>::sweep(const AABB<T>& aabb, const Vec2<T>& vel, size_t* index) const
+    {
+        Intersection<T> best;
+        if (vel.isZero())
+            return best;
+
+        // Sweeping a box is the same as casting its center against
+        // boxes extended by its size.
+        const Line2<T> line(aabb.getCenter(), vel, Segment);
+        auto fnode = [&](AABB<T> bbox) {
+            bbox.extend(aabb);
+            auto isec = intersect(line, bbox);
+            return isec ? (double)isec.time : -1.0;
+        };
+
+        if (_nodes.empty() || fnode(_nodes[0].bbox) < 0)
+            return best;
+
+        _traverseNearest(fnode, [&](const Node& leaf) {
+            auto isec = math::sweep(aabb, vel, leaf.bbox);
+            if (!isec || (best && isec.time >= best.time))
+                return -1.0;
+            best = isec;
+            if (index)
+                *index = leaf.object;
+            return (double)isec.time;
+        });
+        return best;
+    }
+
+    template <typename T>
+    const std::vector<typename BVH<T>::Node>& BVH<T>::getNodes() const
+    {
+        return _nodes;
+    }
+
+    template <typename T>
+    size_t BVH<T>::size() const
+    {
+        return _size;
+    }
+}
+
+#endif
@@ -0,0 +1,377 @@
+#ifndef CPPMATH_GEOMETRY_BITGRID_HPP
+#define CPPMATH_GEOMETRY_BITGRID_HPP
+
+#include <vector>
+#include <cstdint>
+#include "Intersection.hpp"
+#include "AABB.hpp"
+#include "Grid.hpp"
+
+/*
+ * A hierarchical occupancy bitmap.
+ * Cells are packed into 64-bit words of 8x8 cells. Each summary level
+ * stores one bit per word of the level below, set if that word is
+ * non-empty, again packed into 8x8 blocks, until a single word remains.
+ * Region and ray queries only descend into non-empty blocks, which makes
+ * them a cheap first filter before exact collision tests.
+ * The grid is anchored at (0, 0). Out-of-bounds cells are empty.
+ */
+
+namespace math
+{
+    class BitGrid
+    {
+        public:
+            BitGrid();
+            BitGrid(size_t w, size_t h);
+
+            // Resizes the grid and clears all cells.
+            void resize(size_t w, size_t h);
+            void clear();
+
+            // Sets all cells to the occupancy of the given grid's cells,
+            // i.e. whether they are non-zero. Resizes the grid if needed.
+            template <typename U>
+            void assign(const Grid<U>& grid);
+
+            void set(int x, int y, bool val = true);
+            bool get(int x, int y) const;
+
+            // Returns true if any cell inside the rectangle is set.
+            bool any(const AABBi& rect) const;
+
+            // Returns the amount of set cells inside the rectangle.
+            size_t count(const AABBi& rect) const;
+            size_t count() const;
+
+            size_t getWidth() const;
+            size_t getHeight() const;
+
+            // Returns the amount of levels, including the cell level.
+            size_t getLevelCount() const;
+
+            // Returns the word at position (x, y) of the given level.
+            uint64_t getWord(size_t level, int x, int y) const;
+
+        protected:
+            struct Level
+            {
+                std::vector<uint64_t> words;
+                int w, h;   // In words
+            };
+
+            // Calls f(word) for all non-empty level 0 words intersecting
+            // the rectangle, masked to the rectangle. Returns true if f
+            // returned true.
+            template <typename F>
+            bool _query(size_t level, int wx, int wy, const AABBi& rect, F f) const;
+
+        protected:
+            std::vector<Level> _levels;
+            size_t _w, _h;
+    };
+
+    // Returns true if any cell inside the rectangle is set.
+    inline bool intersect(const BitGrid& grid, const AABBi& rect);
+
+    // Returns the first set cell hit by a line segment, or an empty
+    // intersection if there is none.
+    // Same format as raycast(Grid, Vec2, Line2), but empty blocks are
+    // skipped as a whole.
+    template <typename T>
+    Intersection<T> raycast(const BitGrid& grid, const Vec2<T>& cellsize, const Line2<T>& segment,
+                            Point2i* cell = nullptr);
+}
+
+
+#include "gridtraversal.hpp"
+#include <algorithm>
+#include <cassert>
+
+// Implementation
+namespace math
+{
+    namespace detail
+    {
+        inline int popcount(uint64_t x)
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            return __builtin_popcountll(x);
+#else
+            x = x - ((x >> 1) & 0x5555555555555555ull);
+            x = (x & 0x3333333333333333ull) + ((x >> 2) & 0x3333333333333333ull);
+            x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0full;
+            return (x * 0x0101010101010101ull) >> 56;
+#endif
+        }
+
+        // Returns the mask of the bits [x0, x1] * [y0, y1] of an 8x8 word.
+        inline uint64_t bitRectMask(int x0, int y0, int x1, int y1)
+        {
+            uint64_t row = (0xffull >> (7 - x1)) & (0xffull << x0);
+            uint64_t rows = (~0ull >> (8 * (7 - y1))) & (~0ull << (8 * y0));
+            return (row * 0x0101010101010101ull) & rows;
+        }
+
+        // Returns the index of the lowest set bit. x must not be 0.
+        inline int lowestBit(uint64_t x)
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            return __builtin_ctzll(x);
+#else
+            return popcount((x & -x) - 1);
+#endif
+        }
+
+        // Walks the part [t0, t1] of a line segment through the bits of a
+        // level, restricted to the bits [min, max), and descends into the
+        // set ones.
+        template <typename T>
+        bool bitGridRaycast(const BitGrid& grid, const Line2d& line, const Vec2<T>& cellsize,
+                            size_t level, double t0, double t1, const Point2i& min, const Point2i& max,
+                            const Vec2<T>& parentnormal, Intersection<T>* hit, Point2i* cell);
+    }
+
+
+    inline BitGrid::BitGrid() :
+        _w(0), _h(0)
+    {
+        resize(0, 0);
+    }
+
+    inline BitGrid::BitGrid(size_t w, size_t h)
+    {
+        resize(w, h);
+    }
+
+    inline void BitGrid::resize(size_t w, size_t h)
+    {
+        _w = w;
+        _h = h;
+        _levels.clear();
+
+        int lw = std::max<int>(1, (w + 7) / 8),
+            lh = std::max<int>(1, (h + 7) / 8);
+        while (true)
+        {
+            Level l;
+            l.w = lw;
+            l.h = lh;
+            l.words.assign(lw * lh, 0);
+            _levels.push_back(std::move(l));
+
+            if (lw == 1 && lh == 1)
+                break;
+            lw = (lw + 7) / 8;
+            lh = (lh + 7) / 8;
+        }
+    }
+
+    inline void BitGrid::clear()
+    {
+        for (auto& l : _levels)
+            l.words.assign(l.words.size(), 0);
+    }
+
+    template <typename U>
+    void BitGrid::assign(const Grid<U>& grid)
+    {
+        if (grid.getWidth() != _w || grid.getHeight() != _h)
+            resize(grid.getWidth(), grid.getHeight());
+        else
+            clear();
+
+        // Fill the cell level directly, then rebuild the summaries
+        Level& base = _levels[0];
+        for (size_t y = 0; y < _h; ++y)
+            for (size_t x = 0; x < _w; ++x)
+                if (grid.at(x, y) != U())
+                    base.words[(y / 8) * base.w + x / 8] |= 1ull << ((y % 8) * 8 + x % 8);
+
+        for (size_t i = 1; i < _levels.size(); ++i)
+        {
+            const Level& child = _levels[i - 1];
+            Level& l = _levels[i];
+            for (int y = 0; y < child.h; ++y)
+                for (int x = 0; x < child.w; ++x)
+                    if (child.words[y * child.w + x])
+                        l.words[(y / 8) * l.w + x / 8] |= 1ull << ((y % 8) * 8 + x % 8);
+        }
+    }
+
+    inline void BitGrid::set(int x, int y, bool val)
+    {
+        if (x < 0 || y < 0 || (size_t)x >= _w || (size_t)y >= _h)
+            return;
+
+        for (auto& l : _levels)
+        {
+            uint64_t& word = l.words[(y / 8) * l.w + x / 8];
+            uint64_t bit = 1ull << ((y % 8) * 8 + x % 8);
+            bool wasempty = word == 0;
+
+            word = val ? word | bit : word & ~bit;
+
+            // Summaries only change if the word became (non-)empty
+            if (wasempty == (word == 0))
+                break;
+
+            val = word != 0;
+            x /= 8;
+            y /= 8;
+        }
+    }
+
+    inline bool BitGrid::get(int x, int y) const
+    {
+        if (x < 0 || y < 0 || (size_t)x >= _w || (size_t)y >= _h)
+            return false;
+        return getWord(0, x / 8, y / 8) & (1ull << ((y % 8) * 8 + x % 8));
+    }
+
+    inline bool BitGrid::any(const AABBi& rect) const
+    {
+        return _query(_levels.size() - 1, 0, 0, rect, [](uint64_t) { return true; });
+    }
+
+    inline size_t BitGrid::count(const AABBi& rect) const
+    {
+        size_t n = 0;
+        _query(_levels.size() - 1, 0, 0, rect, [&](uint64_t word) {
+            n += detail::popcount(word);
+            return false;
+        });
+        return n;
+    }
+
+    inline size_t BitGrid::count() const
+    {
+        return count(AABBi(0, 0, _w, _h));
+    }
+
+    template <typename F>
+    bool BitGrid::_query(size_t level, int wx, int wy, const AABBi& rect, F f) const
+    {
+        // Cells covered by a single bit at this level
+        int bitsize = 1;
+        for (size_t i = 0; i < level; ++i)
+            bitsize *= 8;
+
+        const int x0 = wx * 8 * bitsize,
+                  y0 = wy * 8 * bitsize;
+        if (rect.w <= 0 || rect.h <= 0 || rect.x + rect.w <= x0 || rect.y + rect.h <= y0)
+            return false;
+
+        int bx0 = std::max(0, (rect.x - x0) / bitsize),
+            by0 = std::max(0, (rect.y - y0) / bitsize),
+            bx1 = std::min(7, (rect.x + rect.w - 1 - x0) / bitsize),
+            by1 = std::min(7, (rect.y + rect.h - 1 - y0) / bitsize);
+        if (bx0 > 7 || by0 > 7)
+            return false;
+
+        uint64_t word = getWord(level, wx, wy) & detail::bitRectMask(bx0, by0, bx1, by1);
+        if (word == 0)
+            return false;
+
+        if (level == 0)
+            return f(word);
+
+        while (word)
+        {
+            int bit = detail::lowestBit(word);
+            word &= word - 1;
+            if (_query(level - 1, wx * 8 + bit % 8, wy * 8 + bit / 8, rect, f))
+                return true;
+        }
+        return false;
+    }
+
+    inline size_t BitGrid::getWidth() const
+    {
+        return _w;
+    }
+
+    inline size_t BitGrid::getHeight() const
+    {
+        return _h;
+    }
+
+    inline size_t BitGrid::getLevelCount() const
+    {
+        return _levels.size();
+    }
+
+    inline uint64_t BitGrid::getWord(size_t level, int x, int y) const
+    {
+        const Level& l = _levels[level];
+        if (x < 0 || y < 0 || x >= l.w || y >= l.h)
+            return 0;
+        return l.words[y * l.w + x];
+    }
+
+
+    template <typename T>
+    bool detail::bitGridRaycast(const BitGrid& grid, const Line2d& line, const Vec2<T>& cellsize,
+                                size_t level, double t0, double t1, const Point2i& min, const Point2i& max,
+                                const Vec2<T>& parentnormal, Intersection<T>* hit, Point2i* cell)
+    {
+        int bitsize = 1;
+        for (size_t i = 0; i < level; ++i)
+            bitsize *= 8;
+
+        const Line2d part(line.p + line.d * t0, line.d * (t1 - t0), Segment);
+        bool found = false;
+
+        traverseGrid(part, Vec2d(cellsize) * bitsize, [&](const Point2i& c, const Intersection<double>& isec) {
+            // Rounding errors may cause the walk to start in a neighbour or
+            // to end in a cell that is only touched
+            if (isec.times.x > 0 && isec.times.x >= 1 - 1e-9)
+                return true;
+            if (c.x < min.x || c.y < min.y || c.x >= max.x || c.y >= max.y)
+                return false;
+
+            if (!(grid.getWord(level, c.x / 8, c.y / 8) & (1ull << ((c.y % 8) * 8 + c.x % 8))))
+                return false;
+
+            Vec2<T> normal = isec.normal.isZero() ? parentnormal : Vec2<T>(isec.normal);
+            double tin = t0 + isec.times.x * (t1 - t0),
+                   tout = t0 + isec.times.y * (t1 - t0);
+
+            if (level > 0)
+            {
+                Point2i cmin(c.x * 8, c.y * 8);
+                found = bitGridRaycast(grid, line, cellsize, level - 1, tin, tout,
+                                       cmin, cmin + Vec2i(8, 8), normal, hit, cell);
+                return found;
+            }
+
+            *hit = Intersection<T>(Point2<T>(line.p + line.d * tin),
+                                   Point2<T>(line.p + line.d * tout),
+                                   Vec2<T>(tin, tout), normal);
+            if (cell)
+                *cell = c;
+            found = true;
+            return true;
+        });
+
+        return found;
+    }
+
+    inline bool intersect(const BitGrid& grid, const AABBi& rect)
+    {
+        return grid.any(rect);
+    }
+
+    template <typename T>
+    Intersection<T> raycast(const BitGrid& grid, const Vec2<T>& cellsize, const Line2<T>& segment,
+                            Point2i* cell)
+    {
+        Intersection<T> hit;
+        const Line2d line(Point2d(segment.p), Vec2d(segment.d), Segment);
+        detail::bitGridRaycast(grid, line, cellsize, grid.getLevelCount() - 1, 0, 1,
+                               Point2i(0, 0), Point2i(8, 8), Vec2<T>(), &hit, cell);
+        return hit;
+    }
+}
+
+#endif
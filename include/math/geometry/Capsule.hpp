@@ -0,0 +1,62 @@
+#ifndef CPPMATH_GEOMETRY_CAPSULE_HPP
+#define CPPMATH_GEOMETRY_CAPSULE_HPP
+
+#include "AABB.hpp"
+#include "Line2.hpp"
+
+/*
+ * A capsule is the set of points within radius of the segment a-b, i.e. a
+ * rectangle with half circles at both ends. If a and b are equal, it is a
+ * circle.
+ */
+
+namespace math
+{
+    template <class T>
+    class Capsule
+    {
+        public:
+            Capsule() : radius(0) {}
+            Capsule(const Point2<T>& a_, const Point2<T>& b_, T radius_) : a(a_), b(b_), radius(radius_) {}
+
+            Line2<T> getSegment() const;
+            Point2<T> getCenter() const;
+            AABB<T> getBBox() const;
+
+        public:
+            Point2<T> a, b;
+            T radius;
+    };
+
+    typedef Capsule<float> Capsulef;
+    typedef Capsule<double> Capsuled;
+}
+
+
+// Implementation
+namespace math
+{
+    template <class T>
+    Line2<T> Capsule<T>::getSegment() const
+    {
+        return Line2<T>(a, b, Segment);
+    }
+
+    template <class T>
+    Point2<T> Capsule<T>::getCenter() const
+    {
+        return a + (b - a) / 2;
+    }
+
+    template <class T>
+    AABB<T> Capsule<T>::getBBox() const
+    {
+        const Vec2<T> r(radius, radius);
+        AABB<T> box = AABB<T>::fromPoints(a, b);
+        box.pos -= r;
+        box.size += r * 2;
+        return box;
+    }
+}
+
+#endif
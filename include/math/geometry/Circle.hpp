@@ -0,0 +1,145 @@
+#ifndef CPPMATH_GEOMETRY_CIRCLE_HPP
+#define CPPMATH_GEOMETRY_CIRCLE_HPP
+
+#include "AABB.hpp"
+
+/*
+ * fromPoints() computes the minimum enclosing circle with Welzl's
+ * algorithm in its iterative move-to-front form. The points are shuffled
+ * first, which makes it run in expected O(n) for any input order.
+ */
+
+namespace math
+{
+    template <typename>
+    class AbstractPointSet;
+
+    template <class T>
+    class Circle
+    {
+        public:
+            Circle() : radius(0) {}
+            Circle(const Point2<T>& center_, T radius_) : center(center_), radius(radius_) {}
+            Circle(T x, T y, T radius_) : center(x, y), radius(radius_) {}
+
+            // Returns the smallest circle containing all points.
+            static Circle<T> fromPoints(const AbstractPointSet<T>& points);
+
+            AABB<T> getBBox() const;
+
+        public:
+            Point2<T> center;
+            T radius;
+    };
+
+    typedef Circle<float> Circlef;
+    typedef Circle<double> Circled;
+}
+
+
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
+// Implementation
+namespace math
+{
+    namespace detail
+    {
+        inline bool circleContains(const Point2d& center, double radius, const Point2d& p)
+        {
+            return (p - center).abs_sqr() <= radius * radius * (1 + 1e-12);
+        }
+
+        // Circle through three points, or the smallest circle through two
+        // of them if they are collinear.
+        inline void circleFrom3(const Point2d& a, const Point2d& b, const Point2d& c, Point2d* center, double* radius)
+        {
+            const Vec2d ab = b - a,
+                        ac = c - a;
+            const double d = 2 * ab.cross(ac);
+            if (d != 0)
+            {
+                const double ab2 = ab.abs_sqr(),
+                             ac2 = ac.abs_sqr();
+                *center = a + Vec2d(ac.y * ab2 - ab.y * ac2, ab.x * ac2 - ac.x * ab2) / d;
+                *radius = (a - *center).abs();
+                return;
+            }
+
+            const Point2d* pairs[][2] = { { &a, &b }, { &a, &c }, { &b, &c } };
+            *radius = -1;
+            for (auto& pair : pairs)
+            {
+                const double r = (*pair[1] - *pair[0]).abs() / 2;
+                if (r > *radius)
+                {
+                    *radius = r;
+                    *center = *pair[0] + (*pair[1] - *pair[0]) / 2;
+                }
+            }
+        }
+    }
+
+
+    template <class T>
+    Circle<T> Circle<T>::fromPoints(const AbstractPointSet<T>& points)
+    {
+        if (points.size() == 0)
+            return Circle<T>();
+
+        std::vector<Point2d> p(points.size());
+        for (size_t i = 0; i < p.size(); ++i)
+            p[i] = points.get(i);
+        std::shuffle(p.begin(), p.end(), std::minstd_rand());
+
+        Point2d c = p[0];
+        double r = 0;
+        for (size_t i = 1; i < p.size(); ++i)
+        {
+            if (detail::circleContains(c, r, p[i]))
+                continue;
+
+            // p[i] is on the boundary
+            c = p[i];
+            r = 0;
+            for (size_t j = 0; j < i; ++j)
+            {
+                if (detail::circleContains(c, r, p[j]))
+                    continue;
+
+                // p[i] and p[j] are on the boundary
+                c = p[i] + (p[j] - p[i]) / 2;
+                r = (p[j] - p[i]).abs() / 2;
+                for (size_t k = 0; k < j; ++k)
+                    if (!detail::circleContains(c, r, p[k]))
+                        detail::circleFrom3(p[i], p[j], p[k], &c, &r);
+            }
+        }
+
+        // Make sure rounding doesn't leave points outside
+        Circle<T> circle(Point2<T>(c), 0);
+        const Point2d center = circle.center;
+        for (auto& v : p)
+            r = std::max(r, (v - center).abs());
+        if (std::numeric_limits<T>::is_integer)
+            circle.radius = std::ceil(r);
+        else
+        {
+            circle.radius = r;
+            if (circle.radius < r)
+                circle.radius = std::nextafter(circle.radius, std::numeric_limits<T>::max());
+        }
+        return circle;
+    }
+
+    template <class T>
+    AABB<T> Circle<T>::getBBox() const
+    {
+        return AABB<T>(center - Vec2<T>(radius, radius), Vec2<T>(radius, radius) * 2);
+    }
+}
+
+#endif
@@ -0,0 +1,294 @@
+#ifndef CPPMATH_GEOMETRY_CONTACT_CACHE_HPP
+#define CPPMATH_GEOMETRY_CONTACT_CACHE_HPP
+
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "contact.hpp"
+
+/*
+ * Narrowphase cache exploiting temporal coherence between frames.
+ * Shapes are identified by user handles, e.g. broadphase handles. Their
+ * vertices are converted once and stored relative to the first vertex.
+ * When the shape's revision changes, see AbstractPointSet::getRevision(),
+ * the vertices are compared with the stored ones, so translated shapes
+ * only update their origin and are not converted again.
+ * For every pair the axis of the last SAT query is stored, together with
+ * the supporting vertex of the other shape. As long as the pair stays
+ * separated, this axis usually still separates it in the next frame.
+ * The support is then found by walking from the cached vertex, so the
+ * query takes O(1) for small movements.
+ * Otherwise the SAT query walks along both polygons: the supporting vertex
+ * of an edge is found by walking from the previous edge's one, starting
+ * at the vertices cached for the pair, and the incident edge is found by
+ * walking from the last manifold's one. This takes O(n + m) instead of
+ * O(n * m).
+ * Results are the same as calling collide() directly, up to rounding of
+ * the local coordinates.
+ */
+
+namespace math
+{
+    template <typename T>
+    class ContactCache
+    {
+        public:
+            typedef size_t Handle;
+
+        public:
+            // Same as collide(a, b) for convex polygons with handles ha and
+            // hb, but uses and updates the cached data.
+            // Shapes without revision tracking are reread on every call.
+            Manifold<T> collide(Handle ha, const AbstractPointSet<T>& a, Handle hb, const AbstractPointSet<T>& b);
+
+            // Removes a shape and all its pairs.
+            void remove(Handle handle);
+            void clear();
+
+            size_t getShapeCount() const;
+            size_t getPairCount() const;
+
+        protected:
+            struct Shape
+            {
+                const AbstractPointSet<T>* pol;
+                size_t revision;
+                std::vector<Vec2d> shape;   // Input vertices relative to the first one
+                detail::ContactPolygon polygon;
+            };
+
+            // Last axis and features of a pair, relative to the pair's
+            // lower handle
+            struct Pair
+            {
+                bool flip;          // Axis is an edge of the higher handle's shape
+                size_t edge;
+                size_t support;     // Supporting vertex of the other shape
+                size_t walk[2];     // Supporting vertices for the lower and higher handle's first edge
+                size_t incident;    // Incident edge of the last manifold
+            };
+
+            struct PairHash
+            {
+                size_t operator()(const std::pair<Handle, Handle>& key) const
+                {
+                    const size_t h = std::hash<Handle>()(key.first);
+                    return h ^ (std::hash<Handle>()(key.second) + 0x9e3779b9 + (h << 6) + (h >> 2));
+                }
+            };
+
+            const detail::ContactPolygon& _getShape(Handle handle, const AbstractPointSet<T>& pol);
+
+        protected:
+            std::unordered_map<Handle, Shape> _shapes;
+            std::unordered_map<std::pair<Handle, Handle>, Pair, PairHash> _pairs;
+    };
+}
+
+
+#include <limits>
+#include <cmath>
+#include <cassert>
+
+// Implementation
+namespace math
+{
+    namespace detail
+    {
+        // Returns the separation of b along a's given edge normal.
+        // The supporting vertex is searched starting at support, which
+        // is updated.
+        inline double contactEdgeSeparation(const ContactPolygon& a, size_t edge, const ContactPolygon& b, size_t* support)
+        {
+            const Vec2d n = a.normals[edge];
+            const Point2d v = a.points[edge] - (b.origin - a.origin);
+            const size_t m = b.points.size();
+
+            size_t k = *support;
+            double s = n.dot(b.points[k] - v);
+            for (size_t steps = 0; steps < m; ++steps)
+            {
+                const size_t next = (k + 1) % m,
+                             prev = (k + m - 1) % m;
+                const double sn = n.dot(b.points[next] - v),
+                             sp = n.dot(b.points[prev] - v);
+
+                if (sn < s)
+                {
+                    k = next;
+                    s = sn;
+                }
+                else if (sp < s)
+                {
+                    k = prev;
+                    s = sp;
+                }
+                else if (sn == s && sp == s)
+                {
+                    // Inside a flat run of vertices, which might be the
+                    // maximum instead of the minimum.
+                    for (size_t j = 0; j < m; ++j)
+                    {
+                        const double d = n.dot(b.points[j] - v);
+                        if (d < s)
+                        {
+                            s = d;
+                            k = j;
+                        }
+                    }
+                    break;
+                }
+                else
+                    break;
+            }
+
+            *support = k;
+            return s;
+        }
+
+        // Same as contactMaxSeparation(), but walks from the supporting
+        // vertex of one edge to the next one's. walk is the supporting
+        // vertex to start with for a's first edge and is updated.
+        inline double contactWalkSeparation(const ContactPolygon& a, const ContactPolygon& b,
+                                            size_t* edge, size_t* support, size_t* walk)
+        {
+            size_t k = *walk < b.points.size() ? *walk : 0;
+            double best = -std::numeric_limits<double>::infinity();
+            for (size_t i = 0; i < a.points.size(); ++i)
+            {
+                const double s = contactEdgeSeparation(a, i, b, &k);
+                if (i == 0)
+                    *walk = k;
+                if (s > best)
+                {
+                    best = s;
+                    *edge = i;
+                    *support = k;
+                }
+            }
+            return best;
+        }
+    }
+
+
+    template <typename T>
+    Manifold<T> ContactCache<T>::collide(Handle ha, const AbstractPointSet<T>& a, Handle hb, const AbstractPointSet<T>& b)
+    {
+        assert(ha != hb && "a shape can't collide with itself");
+
+        const detail::ContactPolygon& pa = _getShape(ha, a);
+        const detail::ContactPolygon& pb = _getShape(hb, b);
+        if (pa.points.size() < 3 || pb.points.size() < 3)
+            return Manifold<T>();
+
+        // Pairs are stored with the lower handle first
+        const bool swapped = hb < ha;
+        const size_t none = (size_t)-1;
+        Pair& pair = _pairs.insert(std::make_pair(
+                    swapped ? std::make_pair(hb, ha) : std::make_pair(ha, hb),
+                    Pair{ false, 0, 0, { 0, 0 }, none })).first->second;
+
+        // Test the last axis first
+        {
+            const bool owner = pair.flip != swapped;    // true: b owns the axis
+            const detail::ContactPolygon& ref = owner ? pb : pa;
+            const detail::ContactPolygon& inc = owner ? pa : pb;
+            if (pair.edge < ref.points.size() && pair.support < inc.points.size()
+                    && detail::contactEdgeSeparation(ref, pair.edge, inc, &pair.support) > 0)
+                return Manifold<T>();
+        }
+
+        size_t edgea, edgeb, supporta, supportb;
+        const double sa = detail::contactWalkSeparation(pa, pb, &edgea, &supportb, &pair.walk[swapped]);
+        if (sa > 0)
+        {
+            pair.flip = swapped;
+            pair.edge = edgea;
+            pair.support = supportb;
+            return Manifold<T>();
+        }
+
+        const double sb = detail::contactWalkSeparation(pb, pa, &edgeb, &supporta, &pair.walk[!swapped]);
+        pair.flip = sb > sa ? !swapped : swapped;
+        pair.edge = sb > sa ? edgeb : edgea;
+        pair.support = sb > sa ? supporta : supportb;
+
+        if (sb > 0)
+            return Manifold<T>();
+
+        return detail::contactOverlap<T>(pa, edgea, sa, pb, edgeb, sb, &pair.incident);
+    }
+
+    template <typename T>
+    const detail::ContactPolygon& ContactCache<T>::_getShape(Handle handle, const AbstractPointSet<T>& pol)
+    {
+        Shape& shape = _shapes[handle];
+        const size_t revision = pol.getRevision();
+        if (shape.pol == &pol && revision != 0 && shape.revision == revision)
+            return shape.polygon;
+
+        const size_t n = pol.size();
+        const Vec2d origin = n > 0 ? Vec2d(pol.get(0).asVector()) : Vec2d();
+        shape.pol = &pol;
+        shape.revision = revision;
+
+        // Keep the converted polygon if the shape was only translated,
+        // allowing for rounding of the relative positions.
+        bool same = shape.shape.size() == n;
+        for (size_t i = 0; same && i < n; ++i)
+        {
+            const Vec2d p(pol.get(i).asVector()),
+                        d = (p - origin) - shape.shape[i];
+            const double slack = detail::boundsSlack<T>(std::abs(p.x) + std::abs(p.y)
+                                                        + std::abs(origin.x) + std::abs(origin.y));
+            same = std::abs(d.x) <= slack && std::abs(d.y) <= slack;
+        }
+
+        if (!same)
+        {
+            shape.shape.resize(n);
+            for (size_t i = 0; i < n; ++i)
+                shape.shape[i] = Vec2d(pol.get(i).asVector()) - origin;
+
+            detail::contactRead(pol, &shape.polygon);
+            for (auto& p : shape.polygon.points)
+                p -= origin;
+        }
+        shape.polygon.origin = origin;
+        return shape.polygon;
+    }
+
+    template <typename T>
+    void ContactCache<T>::remove(Handle handle)
+    {
+        _shapes.erase(handle);
+        for (auto it = _pairs.begin(); it != _pairs.end();)
+        {
+            if (it->first.first == handle || it->first.second == handle)
+                it = _pairs.erase(it);
+            else
+                ++it;
+        }
+    }
+
+    template <typename T>
+    void ContactCache<T>::clear()
+    {
+        _shapes.clear();
+        _pairs.clear();
+    }
+
+    template <typename T>
+    size_t ContactCache<T>::getShapeCount() const
+    {
+        return _shapes.size();
+    }
+
+    template <typename T>
+    size_t ContactCache<T>::getPairCount() const
+    {
+        return _pairs.size();
+    }
+}
+
+#endif
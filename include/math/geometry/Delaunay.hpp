@@ -0,0 +1,827 @@
+#ifndef CPPMATH_GEOMETRY_DELAUNAY_HPP
+#define CPPMATH_GEOMETRY_DELAUNAY_HPP
+
+#include <vector>
+#include <cstdint>
+#include "PointSet.hpp"
+
+/*
+ * Constrained Delaunay triangulation.
+ * Points are triangulated with the sweep-hull algorithm (Sinclair,
+ * "S-hull", in the variant used by Delaunator) in O(n log n): points are
+ * inserted in order of their distance to a seed triangle, each new point
+ * is connected to the visible part of the convex hull and the Delaunay
+ * condition is restored by edge flips.
+ * Constrained edges are inserted afterwards by flipping away all edges
+ * crossing them (Sloan, "A fast algorithm for generating constrained
+ * Delaunay triangulations"), followed by a local Delaunay restore.
+ *
+ * The result is an indexed mesh in half-edge form: triangle t consists
+ * of the indices 3t, 3t + 1 and 3t + 2 in getTriangles(). Halfedge e
+ * goes from vertex getTriangles()[e] to the next vertex of its triangle,
+ * getHalfedges()[e] is the opposite halfedge in the adjacent triangle or
+ * npos on the convex hull.
+ * Triangles are wound counter-clockwise in a y-down system (clockwise in
+ * a y-up system).
+ */
+
+namespace math
+{
+    template <typename T>
+    class AbstractPolygon;
+
+    template <typename T>
+    class Delaunay
+    {
+        public:
+            static const size_t npos = (size_t)-1;
+
+        public:
+            Delaunay();
+            Delaunay(const AbstractPointSet<T>& points);
+
+            // Triangulates a set of points. Duplicate points are merged,
+            // triangles always refer to the first occurrence.
+            // If all points are collinear, no triangles are generated.
+            void triangulate(const AbstractPointSet<T>& points);
+
+            // Triangulates the vertices of the given polygons and inserts
+            // their segments as constrained edges. Vertex indices are
+            // assigned in order, i.e. the vertices of the second polygon
+            // start at the first polygon's size.
+            void triangulate(const std::vector<const AbstractPolygon<T>*>& polygons);
+
+            // Enforces an edge between the ith and jth point.
+            // Points lying exactly on the edge split it into multiple
+            // constrained edges. Returns false if the edge would cross an
+            // existing constrained edge, in which case it is not inserted.
+            bool addConstraint(size_t i, size_t j);
+
+            // Returns true if the halfedge is part of a constrained edge.
+            bool isConstrained(size_t halfedge) const;
+
+            // Returns the halfedge going from point i to point j, the one
+            // from j to i if the edge is on the convex hull, or npos if
+            // there is no such edge.
+            size_t findEdge(size_t i, size_t j) const;
+
+            const std::vector<size_t>&    getTriangles() const;
+            const std::vector<size_t>&    getHalfedges() const;
+            const std::vector<Point2<T>>& getPoints() const;
+
+            // Writes all triangles as a triangle list, as used by
+            // intersectTriangles().
+            void toTriangles(AbstractPointSet<T>* out) const;
+
+            // Returns the amount of triangles.
+            size_t size() const;
+
+        protected:
+            void   _triangulate();
+            size_t _addTriangle(size_t a, size_t b, size_t c, size_t ab, size_t bc, size_t ca);
+            void   _link(size_t a, size_t b);
+            size_t _legalize(size_t a);
+            void   _flip(size_t a);
+            bool   _isFlippable(size_t a) const;
+            bool   _isDelaunay(size_t a) const;
+            bool   _insertConstraint(size_t a, size_t b, size_t* split);
+
+        protected:
+            std::vector<Point2<T>> _points;
+            std::vector<Point2d> _coords;       // Points as double
+            std::vector<size_t> _remap;         // Point -> first duplicate
+            std::vector<size_t> _triangles;
+            std::vector<size_t> _halfedges;
+            std::vector<uint8_t> _constrained;
+            std::vector<size_t> _vertexedge;    // Point -> outgoing halfedge
+
+            // Convex hull state during construction
+            std::vector<size_t> _hullprev, _hullnext, _hulltri, _hullhash;
+            size_t _hullstart;
+            Point2d _center;
+            std::vector<size_t> _legalizestack; // Reused by _legalize()
+    };
+}
+
+
+#include "Polygon.hpp"
+#include <algorithm>
+#include <numeric>
+#include <limits>
+#include <cassert>
+
+// Implementation
+namespace math
+{
+    namespace detail
+    {
+        // Positive if a, b, c are wound clockwise in a y-up system.
+        inline double delaunayOrient(const Point2d& a, const Point2d& b, const Point2d& c)
+        {
+            return (a.y - c.y) * (b.x - c.x) - (a.x - c.x) * (b.y - c.y);
+        }
+
+        // True if p lies inside the circumcircle of a, b, c.
+        inline bool delaunayInCircle(const Point2d& a, const Point2d& b, const Point2d& c, const Point2d& p)
+        {
+            const double dx = a.x - p.x, dy = a.y - p.y,
+                         ex = b.x - p.x, ey = b.y - p.y,
+                         fx = c.x - p.x, fy = c.y - p.y;
+            const double ap = dx * dx + dy * dy,
+                         bp = ex * ex + ey * ey,
+                         cp = fx * fx + fy * fy;
+            return dx * (ey * cp - bp * fy) - dy * (ex * cp - bp * fx) + ap * (ex * fy - ey * fx) < 0;
+        }
+
+        // Squared circumradius and circumcenter of a, b, c.
+        inline double delaunayCircumradius(const Point2d& a, const Point2d& b, const Point2d& c, Point2d* center = nullptr)
+        {
+            const double dx = b.x - a.x, dy = b.y - a.y,
+                         ex = c.x - a.x, ey = c.y - a.y;
+            const double bl = dx * dx + dy * dy,
+                         cl = ex * ex + ey * ey,
+                         d = 0.5 / (dx * ey - dy * ex);
+            const double x = (ey * bl - dy * cl) * d,
+                         y = (dx * cl - ex * bl) * d;
+            if (center)
+                *center = Point2d(a.x + x, a.y + y);
+            return x * x + y * y;
+        }
+
+        // Monotonic in the angle of (dx, dy), in [0, 1].
+        inline double pseudoAngle(double dx, double dy)
+        {
+            const double p = dx / (std::abs(dx) + std::abs(dy));
+            return (dy > 0 ? 3 - p : 1 + p) / 4;
+        }
+
+        inline size_t delaunayNext(size_t e) { return e % 3 == 2 ? e - 2 : e + 1; }
+        inline size_t delaunayPrev(size_t e) { return e % 3 == 0 ? e + 2 : e - 1; }
+    }
+
+
+    template <typename T>
+    const size_t Delaunay<T>::npos;
+
+    template <typename T>
+    Delaunay<T>::Delaunay() :
+        _hullstart(0)
+    { }
+
+    template <typename T>
+    Delaunay<T>::Delaunay(const AbstractPointSet<T>& points) :
+        _hullstart(0)
+    {
+        triangulate(points);
+    }
+
+    template <typename T>
+    void Delaunay<T>::triangulate(const AbstractPointSet<T>& points)
+    {
+        _points.resize(points.size());
+        for (size_t i = 0; i < _points.size(); ++i)
+            _points[i] = points.get(i);
+        _triangulate();
+    }
+
+    template <typename T>
+    void Delaunay<T>::triangulate(const std::vector<const AbstractPolygon<T>*>& polygons)
+    {
+        _points.clear();
+        for (auto pol : polygons)
+            for (size_t i = 0; i < pol->size(); ++i)
+                _points.push_back(pol->get(i));
+        _triangulate();
+
+        size_t base = 0;
+        for (auto pol : polygons)
+        {
+            const size_t n = pol->size();
+            for (size_t i = 1; i < n; ++i)
+                addConstraint(base + i - 1, base + i);
+            if (pol->getFillType() != Open && n > 2)
+                addConstraint(base + n - 1, base);
+            base += n;
+        }
+    }
+
+    template <typename T>
+    void Delaunay<T>::_triangulate()
+    {
+        const double inf = std::numeric_limits<double>::infinity();
+        const size_t n = _points.size();
+
+        _triangles.clear();
+        _halfedges.clear();
+        _constrained.clear();
+        _coords.resize(n);
+        _remap.resize(n);
+        _vertexedge.assign(n, npos);
+
+        for (size_t i = 0; i < n; ++i)
+            _coords[i] = _points[i];
+
+        // Merge duplicates
+        std::vector<size_t> ids(n);
+        std::iota(ids.begin(), ids.end(), 0);
+        std::sort(ids.begin(), ids.end(), [this](size_t a, size_t b) {
+            const Point2d& p = _coords[a];
+            const Point2d& q = _coords[b];
+            return p.x != q.x ? p.x < q.x : p.y != q.y ? p.y < q.y : a < b;
+        });
+        for (size_t k = 0; k < n; ++k)
+            _remap[ids[k]] = k > 0 && _coords[ids[k]] == _coords[ids[k - 1]] ? _remap[ids[k - 1]] : ids[k];
+        ids.erase(std::remove_if(ids.begin(), ids.end(), [this](size_t i) { return _remap[i] != i; }), ids.end());
+
+        if (ids.size() < 3)
+            return;
+
+        // Seed triangle: the point closest to the center, its nearest
+        // neighbour and the point forming the smallest circumcircle.
+        Vec2d min = _coords[ids[0]].asVector(),
+              max = min;
+        for (size_t i : ids)
+        {
+            min = mins(min, _coords[i].asVector());
+            max = maxs(max, _coords[i].asVector());
+        }
+        const Point2d c = ((min + max) / 2.0).asPoint();
+
+        size_t i0 = npos, i1 = npos, i2 = npos;
+        double mindist = inf;
+        for (size_t i : ids)
+        {
+            double d = (_coords[i] - c).abs_sqr();
+            if (d < mindist)
+            {
+                i0 = i;
+                mindist = d;
+            }
+        }
+
+        mindist = inf;
+        for (size_t i : ids)
+        {
+            double d = (_coords[i] - _coords[i0]).abs_sqr();
+            if (i != i0 && d < mindist)
+            {
+                i1 = i;
+                mindist = d;
+            }
+        }
+
+        double minradius = inf;
+        for (size_t i : ids)
+        {
+            if (i == i0 || i == i1)
+                continue;
+            double r = detail::delaunayCircumradius(_coords[i0], _coords[i1], _coords[i]);
+            if (r < minradius)
+            {
+                i2 = i;
+                minradius = r;
+            }
+        }
+
+        // All points collinear
+        if (minradius == inf)
+            return;
+
+        if (detail::delaunayOrient(_coords[i0], _coords[i1], _coords[i2]) < 0)
+            std::swap(i1, i2);
+
+        detail::delaunayCircumradius(_coords[i0], _coords[i1], _coords[i2], &_center);
+
+        // Sort by distance from the seed circle's center
+        std::vector<double> dists(n);
+        for (size_t i : ids)
+            dists[i] = (_coords[i] - _center).abs_sqr();
+        std::sort(ids.begin(), ids.end(), [&dists](size_t a, size_t b) {
+            return dists[a] != dists[b] ? dists[a] < dists[b] : a < b;
+        });
+
+        const size_t hashsize = std::max<size_t>(1, std::ceil(std::sqrt((double)ids.size())));
+        auto hashkey = [&](const Point2d& p) {
+            return (size_t)std::floor(detail::pseudoAngle(p.x - _center.x, p.y - _center.y) * hashsize) % hashsize;
+        };
+
+        _hullprev.assign(n, npos);
+        _hullnext.assign(n, npos);
+        _hulltri.assign(n, npos);
+        _hullhash.assign(hashsize, npos);
+
+        _hullstart = i0;
+        _hullnext[i0] = _hullprev[i2] = i1;
+        _hullnext[i1] = _hullprev[i0] = i2;
+        _hullnext[i2] = _hullprev[i1] = i0;
+        _hulltri[i0] = 0;
+        _hulltri[i1] = 1;
+        _hulltri[i2] = 2;
+        _hullhash[hashkey(_coords[i0])] = i0;
+        _hullhash[hashkey(_coords[i1])] = i1;
+        _hullhash[hashkey(_coords[i2])] = i2;
+
+        const size_t maxtriangles = 2 * ids.size() - 5;
+        _triangles.reserve(maxtriangles * 3);
+        _halfedges.reserve(maxtriangles * 3);
+        _addTriangle(i0, i1, i2, npos, npos, npos);
+
+        for (size_t i : ids)
+        {
+            if (i == i0 || i == i1 || i == i2)
+                continue;
+
+            const Point2d& p = _coords[i];
+
+            // Find a visible edge on the convex hull using the hash
+            size_t start = 0;
+            for (size_t j = 0, key = hashkey(p); j < hashsize; ++j)
+            {
+                start = _hullhash[(key + j) % hashsize];
+                if (start != npos && start != _hullnext[start])
+                    break;
+            }
+
+            start = _hullprev[start];
+            size_t e = start, q;
+            while (q = _hullnext[e], detail::delaunayOrient(p, _coords[e], _coords[q]) >= 0)
+            {
+                e = q;
+                if (e == start)
+                {
+                    e = npos;
+                    break;
+                }
+            }
+
+            // Nearly collinear with the hull
+            if (e == npos)
+                continue;
+
+            // Add the first triangle from the point
+            size_t t = _addTriangle(e, i, _hullnext[e], npos, npos, _hulltri[e]);
+            _hulltri[i] = _legalize(t + 2);
+            _hulltri[e] = t;
+
+            // Walk forward through the hull
+            size_t next = _hullnext[e];
+            while (q = _hullnext[next], detail::delaunayOrient(p, _coords[next], _coords[q]) < 0)
+            {
+                t = _addTriangle(next, i, q, _hulltri[i], npos, _hulltri[next]);
+                _hulltri[i] = _legalize(t + 2);
+                _hullnext[next] = next; // Mark as removed
+                next = q;
+            }
+
+            // Walk backward from the other side
+            if (e == start)
+            {
+                while (q = _hullprev[e], detail::delaunayOrient(p, _coords[q], _coords[e]) < 0)
+                {
+                    t = _addTriangle(q, i, e, npos, _hulltri[e], _hulltri[q]);
+                    _legalize(t + 2);
+                    _hulltri[q] = t;
+                    _hullnext[e] = e;
+                    e = q;
+                }
+            }
+
+            _hullstart = _hullprev[i] = e;
+            _hullnext[e] = _hullprev[next] = i;
+            _hullnext[i] = next;
+
+            _hullhash[hashkey(p)] = i;
+            _hullhash[hashkey(_coords[e])] = e;
+        }
+
+        _constrained.assign(_triangles.size(), 0);
+        for (size_t e = 0; e < _triangles.size(); ++e)
+            _vertexedge[_triangles[e]] = e;
+
+        _hullprev.clear();
+        _hullnext.clear();
+        _hulltri.clear();
+        _hullhash.clear();
+    }
+
+    template <typename T>
+    size_t Delaunay<T>::_addTriangle(size_t a, size_t b, size_t c, size_t ab, size_t bc, size_t ca)
+    {
+        const size_t t = _triangles.size();
+        _triangles.push_back(a);
+        _triangles.push_back(b);
+        _triangles.push_back(c);
+        _halfedges.resize(t + 3);
+        _link(t, ab);
+        _link(t + 1, bc);
+        _link(t + 2, ca);
+        return t;
+    }
+
+    template <typename T>
+    void Delaunay<T>::_link(size_t a, size_t b)
+    {
+        _halfedges[a] = b;
+        if (b != npos)
+            _halfedges[b] = a;
+    }
+
+    // Flips edges until the Delaunay condition is met.
+    // Returns the halfedge that replaced a's previous edge.
+    template <typename T>
+    size_t Delaunay<T>::_legalize(size_t a)
+    {
+        std::vector<size_t>& stack = _legalizestack;
+        stack.clear();
+        size_t ar = 0;
+
+        while (true)
+        {
+            const size_t b = _halfedges[a];
+            const size_t a0 = a - a % 3;
+            ar = a0 + (a + 2) % 3;
+
+            if (b == npos || _isDelaunay(a))
+            {
+                if (stack.empty())
+                    break;
+                a = stack.back();
+                stack.pop_back();
+                continue;
+            }
+
+            const size_t b0 = b - b % 3,
+                         bl = b0 + (b + 2) % 3,
+                         br = b0 + (b + 1) % 3;
+
+            // The flip moves the hull edge at bl to a
+            if (_halfedges[bl] == npos)
+            {
+                size_t e = _hullstart;
+                do
+                {
+                    if (_hulltri[e] == bl)
+                    {
+                        _hulltri[e] = a;
+                        break;
+                    }
+                    e = _hullprev[e];
+                } while (e != _hullstart);
+            }
+
+            _flip(a);
+            stack.push_back(br);
+        }
+
+        return ar;
+    }
+
+    template <typename T>
+    bool Delaunay<T>::_isDelaunay(size_t a) const
+    {
+        const size_t b = _halfedges[a];
+        if (b == npos)
+            return true;
+
+        const size_t a0 = a - a % 3,
+                     b0 = b - b % 3;
+        const size_t p0 = _triangles[a0 + (a + 2) % 3],
+                     pr = _triangles[a],
+                     pl = _triangles[a0 + (a + 1) % 3],
+                     p1 = _triangles[b0 + (b + 2) % 3];
+        return !detail::delaunayInCircle(_coords[p0], _coords[pr], _coords[pl], _coords[p1]);
+    }
+
+    // Flips the edge shared by the triangles (pr, pl, p0) and (pl, pr, p1)
+    // to p0-p1. Halfedge a is reused for p1-pl, its twin for p0-pr and
+    // the new diagonal is formed by the halfedges ar and bl.
+    template <typename T>
+    void Delaunay<T>::_flip(size_t a)
+    {
+        const size_t b = _halfedges[a];
+        const size_t a0 = a - a % 3,
+                     b0 = b - b % 3;
+        const size_t al = a0 + (a + 1) % 3,
+                     ar = a0 + (a + 2) % 3,
+                     bl = b0 + (b + 2) % 3,
+                     br = b0 + (b + 1) % 3;
+        const size_t p0 = _triangles[ar],
+                     pr = _triangles[a],
+                     pl = _triangles[al],
+                     p1 = _triangles[bl];
+
+        _triangles[a] = p1;
+        _triangles[b] = p0;
+
+        const size_t hbl = _halfedges[bl],
+                     har = _halfedges[ar];
+        _link(a, hbl);
+        _link(b, har);
+        _link(ar, bl);
+
+        if (!_constrained.empty())
+        {
+            _constrained[a] = _constrained[bl];
+            _constrained[b] = _constrained[ar];
+            _constrained[ar] = _constrained[bl] = 0;
+
+            _vertexedge[p0] = ar;
+            _vertexedge[pr] = br;
+            _vertexedge[pl] = al;
+            _vertexedge[p1] = bl;
+        }
+    }
+
+    // True if the two triangles sharing the halfedge form a strictly
+    // convex quad, i.e. the edge can be flipped.
+    template <typename T>
+    bool Delaunay<T>::_isFlippable(size_t a) const
+    {
+        const size_t b = _halfedges[a];
+        if (b == npos)
+            return false;
+
+        const size_t a0 = a - a % 3,
+                     b0 = b - b % 3;
+        const Point2d& p0 = _coords[_triangles[a0 + (a + 2) % 3]];
+        const Point2d& pr = _coords[_triangles[a]];
+        const Point2d& pl = _coords[_triangles[a0 + (a + 1) % 3]];
+        const Point2d& p1 = _coords[_triangles[b0 + (b + 2) % 3]];
+
+        double s1 = detail::delaunayOrient(p0, p1, pr),
+               s2 = detail::delaunayOrient(p0, p1, pl);
+        return (s1 > 0 && s2 < 0) || (s1 < 0 && s2 > 0);
+    }
+
+    template <typename T>
+    size_t Delaunay<T>::findEdge(size_t i, size_t j) const
+    {
+        if (i >= _remap.size() || j >= _remap.size())
+            return npos;
+
+        i = _remap[i];
+        j = _remap[j];
+        const size_t start = _vertexedge[i];
+        if (start == npos)
+            return npos;
+
+        // Rotate around i in both directions, in case i is on the hull
+        // Hull edges only exist in one direction, so incoming edges are
+        // checked, too.
+        auto check = [&](size_t e) {
+            if (_triangles[detail::delaunayNext(e)] == j)
+                return e;
+            if (_triangles[detail::delaunayPrev(e)] == j)
+                return detail::delaunayPrev(e);
+            return npos;
+        };
+
+        size_t e = start;
+        do
+        {
+            if (check(e) != npos)
+                return check(e);
+            e = _halfedges[detail::delaunayPrev(e)];
+        } while (e != npos && e != start);
+
+        if (e == npos)
+        {
+            e = start;
+            while (_halfedges[e] != npos)
+            {
+                e = detail::delaunayNext(_halfedges[e]);
+                if (check(e) != npos)
+                    return check(e);
+            }
+        }
+
+        return npos;
+    }
+
+    template <typename T>
+    bool Delaunay<T>::addConstraint(size_t i, size_t j)
+    {
+        assert(i < _points.size() && j < _points.size() && "index out of range");
+
+        i = _remap[i];
+        j = _remap[j];
+        while (i != j && _vertexedge[i] != npos)
+        {
+            size_t split = npos;
+            if (!_insertConstraint(i, j, &split))
+                return false;
+            if (split == npos)
+                break;
+            i = split;
+        }
+        return true;
+    }
+
+    // Inserts the constraint a-b or the part a-split, if a point lies on it.
+    template <typename T>
+    bool Delaunay<T>::_insertConstraint(size_t a, size_t b, size_t* split)
+    {
+        using namespace detail;
+
+        const Point2d& pa = _coords[a];
+        const Point2d& pb = _coords[b];
+        const Vec2d dir = pb - pa;
+
+        // True if point v lies on the segment a-b
+        auto onSegment = [&](size_t v) {
+            return delaunayOrient(pa, pb, _coords[v]) == 0 && dir.dot(_coords[v] - pa) > 0;
+        };
+
+        auto markConstrained = [&](size_t e) {
+            _constrained[e] = 1;
+            if (_halfedges[e] != npos)
+                _constrained[_halfedges[e]] = 1;
+        };
+
+        // Find the triangle around a that is entered by the segment
+        std::vector<std::pair<size_t, size_t>> crossed;
+        size_t h = npos;
+        {
+            size_t start = _vertexedge[a], e = start;
+            bool reversed = false;
+            while (true)
+            {
+                const size_t v1 = _triangles[delaunayNext(e)],
+                             v2 = _triangles[delaunayPrev(e)];
+
+                if (v1 == b || onSegment(v1))
+                {
+                    markConstrained(e);
+                    *split = v1 == b ? npos : v1;
+                    return true;
+                }
+                if (v2 == b || onSegment(v2))
+                {
+                    markConstrained(delaunayPrev(e));
+                    *split = v2 == b ? npos : v2;
+                    return true;
+                }
+
+                if (delaunayOrient(pa, _coords[v1], pb) > 0 && delaunayOrient(pa, _coords[v2], pb) < 0)
+                {
+                    h = delaunayNext(e);
+                    break;
+                }
+
+                // Rotate around a, switching direction at the hull
+                size_t next;
+                if (!reversed)
+                {
+                    next = _halfedges[delaunayPrev(e)];
+                    if (next == npos)
+                    {
+                        reversed = true;
+                        next = start;
+                    }
+                }
+                else
+                    next = _halfedges[e] == npos ? npos : delaunayNext(_halfedges[e]);
+
+                if (next == npos || (!reversed && next == start))
+                    return false;
+                e = next;
+            }
+        }
+
+        // Walk along the segment and collect the crossed edges
+        *split = npos;
+        while (true)
+        {
+            if (_constrained[h])
+                return false;
+
+            const size_t u = _triangles[h],
+                         v = _triangles[delaunayNext(h)];
+            crossed.push_back(std::make_pair(u, v));
+
+            const size_t g = _halfedges[h];
+            if (g == npos)
+                return false;
+
+            const size_t w = _triangles[delaunayPrev(g)];
+            if (w == b)
+                break;
+            if (onSegment(w))
+            {
+                *split = w;
+                break;
+            }
+
+            // g goes from v to u, continue with the edge on the other
+            // side of the segment than w
+            const double sw = delaunayOrient(pa, pb, _coords[w]),
+                         su = delaunayOrient(pa, pb, _coords[u]);
+            h = (sw > 0) == (su > 0) ? delaunayPrev(g) : delaunayNext(g);
+        }
+
+        const size_t end = *split != npos ? *split : b;
+        const Point2d& pend = _coords[end];
+
+        auto crosses = [&](size_t u, size_t v) {
+            if (u == a || u == end || v == a || v == end)
+                return false;
+            double s1 = delaunayOrient(pa, pend, _coords[u]),
+                   s2 = delaunayOrient(pa, pend, _coords[v]),
+                   s3 = delaunayOrient(_coords[u], _coords[v], pa),
+                   s4 = delaunayOrient(_coords[u], _coords[v], pend);
+            return ((s1 > 0 && s2 < 0) || (s1 < 0 && s2 > 0)) && ((s3 > 0 && s4 < 0) || (s3 < 0 && s4 > 0));
+        };
+
+        // Flip crossing edges until none are left
+        std::vector<std::pair<size_t, size_t>> created;
+        size_t attempts = 0;
+        const size_t maxattempts = crossed.size() * crossed.size() * 4 + 16;
+        for (size_t k = 0; k < crossed.size(); ++k)
+        {
+            const size_t e = findEdge(crossed[k].first, crossed[k].second);
+            assert(e != npos && "crossed edge vanished");
+
+            if (!_isFlippable(e))
+            {
+                if (++attempts > maxattempts)
+                    return false;
+                crossed.push_back(crossed[k]);
+                continue;
+            }
+
+            _flip(e);
+
+            // ar is now the new diagonal
+            const size_t ar = e - e % 3 + (e + 2) % 3;
+            const size_t p = _triangles[ar],
+                         q = _triangles[delaunayNext(ar)];
+            if (crosses(p, q))
+                crossed.push_back(std::make_pair(p, q));
+            else
+                created.push_back(std::make_pair(p, q));
+        }
+
+        markConstrained(findEdge(a, end));
+
+        // Restore the Delaunay condition around the new edges
+        bool swapped = true;
+        while (swapped)
+        {
+            swapped = false;
+            for (auto& edge : created)
+            {
+                const size_t e = findEdge(edge.first, edge.second);
+                if (e == npos || _constrained[e] || _isDelaunay(e) || !_isFlippable(e))
+                    continue;
+
+                _flip(e);
+                const size_t ar = e - e % 3 + (e + 2) % 3;
+                edge = std::make_pair(_triangles[ar], _triangles[delaunayNext(ar)]);
+                swapped = true;
+            }
+        }
+
+        return true;
+    }
+
+    template <typename T>
+    bool Delaunay<T>::isConstrained(size_t halfedge) const
+    {
+        return _constrained[halfedge];
+    }
+
+    template <typename T>
+    const std::vector<size_t>& Delaunay<T>::getTriangles() const
+    {
+        return _triangles;
+    }
+
+    template <typename T>
+    const std::vector<size_t>& Delaunay<T>::getHalfedges() const
+    {
+        return _halfedges;
+    }
+
+    template <typename T>
+    const std::vector<Point2<T>>& Delaunay<T>::getPoints() const
+    {
+        return _points;
+    }
+
+    template <typename T>
+    void Delaunay<T>::toTriangles(AbstractPointSet<T>* out) const
+    {
+        assert(out && "out is null");
+        out->clear();
+        for (size_t i : _triangles)
+            out->add(_points[i]);
+    }
+
+    template <typename T>
+    size_t Delaunay<T>::size() const
+    {
+        return _triangles.size() / 3;
+    }
+}
+
+#endif
@@ -0,0 +1,119 @@
+#ifndef CPPMATH_GRID_HPP
+#define CPPMATH_GRID_HPP
+
+#include <vector>
+#include <cstddef>
+
+/*
+ * A dense, row-major 2D array.
+ * Used for occupancy maps, tile maps and sampled scalar fields.
+ */
+
+namespace math
+{
+    template <typename T>
+    class Grid
+    {
+        public:
+            typedef typename std::vector<T>::reference reference;
+            typedef typename std::vector<T>::const_reference const_reference;
+
+        public:
+            Grid();
+            Grid(size_t w, size_t h, const T& val = T());
+
+            void resize(size_t w, size_t h, const T& val = T());
+            void fill(const T& val);
+
+            // Returns true if (x, y) is a valid cell.
+            bool contains(int x, int y) const;
+
+            reference       at(size_t x, size_t y);
+            const_reference at(size_t x, size_t y) const;
+
+            // Returns the value at (x, y) or def if (x, y) is out of bounds.
+            T get(int x, int y, const T& def = T()) const;
+
+            size_t getWidth() const;
+            size_t getHeight() const;
+            size_t size() const;
+
+        protected:
+            std::vector<T> _data;
+            size_t _w, _h;
+    };
+}
+
+
+// Implementation
+namespace math
+{
+    template <typename T>
+    Grid<T>::Grid() :
+        _w(0), _h(0)
+    { }
+
+    template <typename T>
+    Grid<T>::Grid(size_t w, size_t h, const T& val) :
+        _data(w * h, val),
+        _w(w), _h(h)
+    { }
+
+    template <typename T>
+    void Grid<T>::resize(size_t w, size_t h, const T& val)
+    {
+        _data.assign(w * h, val);
+        _w = w;
+        _h = h;
+    }
+
+    template <typename T>
+    void Grid<T>::fill(const T& val)
+    {
+        _data.assign(_data.size(), val);
+    }
+
+    template <typename T>
+    bool Grid<T>::contains(int x, int y) const
+    {
+        return x >= 0 && y >= 0 && (size_t)x < _w && (size_t)y < _h;
+    }
+
+    template <typename T>
+    typename Grid<T>::reference Grid<T>::at(size_t x, size_t y)
+    {
+        return _data[y * _w + x];
+    }
+
+    template <typename T>
+    typename Grid<T>::const_reference Grid<T>::at(size_t x, size_t y) const
+    {
+        return _data[y * _w + x];
+    }
+
+    template <typename T>
+    T Grid<T>::get(int x, int y, const T& def) const
+    {
+        return contains(x, y) ? at(x, y) : def;
+    }
+
+    template <typename T>
+    size_t Grid<T>::getWidth() const
+    {
+        return _w;
+    }
+
+    template <typename T>
+    size_t Grid<T>::getHeight() const
+    {
+        return _h;
+    }
+
+    template <typename T>
+    size_t Grid<T>::size() const
+    {
+        return _data.size();
+    }
+}
+
+#endif
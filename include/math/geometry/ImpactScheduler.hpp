@@ -0,0 +1,368 @@
+#ifndef CPPMATH_GEOMETRY_IMPACT_SCHEDULER_HPP
+#define CPPMATH_GEOMETRY_IMPACT_SCHEDULER_HPP
+
+#include <vector>
+#include "LooseQuadtree.hpp"
+
+/*
+ * Continuous collision detection for moving AABBs, processing all impacts
+ * of a time step in time order.
+ * Every object is stored in a loose quadtree with its swept bounds for the
+ * rest of the step, so only objects whose paths may cross are tested.
+ * The time of impact of a pair is found by sweeping one object with the
+ * relative velocity against the other, and all impacts are kept in a
+ * priority queue. Objects keep their own local time and are only moved
+ * to the current time when they are involved in an impact, so an impact
+ * costs O(log n) plus the tests of the two objects' new candidate pairs.
+ * Events are stamped with the objects' velocity revisions, events of
+ * objects whose velocity changed since are skipped when they come up.
+ * If an impact is not resolved by the callback, i.e. the objects still
+ * approach each other, both objects are stopped. When the maximum number
+ * of impacts is reached, all objects are stopped at the time of the next
+ * impact. Hence, objects never pass through each other.
+ */
+
+namespace math
+{
+    template <typename T>
+    class ImpactScheduler
+    {
+        public:
+            typedef size_t Handle;
+
+        public:
+            ImpactScheduler();
+            ImpactScheduler(const AABB<T>& bounds, size_t maxdepth = 8);
+
+            // Sets the area of the broadphase and removes all objects.
+            void reset(const AABB<T>& bounds, size_t maxdepth = 8);
+            void clear();
+
+            Handle add(const AABB<T>& aabb, const Vec2<T>& vel = Vec2<T>());
+            void   remove(Handle handle);
+
+            // Can be called from inside the impact callback, the new
+            // velocity then applies from the time of impact on.
+            void           setVelocity(Handle handle, const Vec2<T>& vel);
+            const Vec2<T>& getVelocity(Handle handle) const;
+
+            // Returns the AABB at the current time.
+            AABB<T> get(Handle handle) const;
+
+            // Moves all objects by their velocity and calls the callback
+            // for every impact in time order. Objects must not be added or
+            // removed from inside the callback.
+            // time is in [0, 1] and the normal points from b towards a.
+            // Callback signature: void (Handle a, Handle b, T time, const Vec2<T>& normal)
+            // Returns the time the objects were moved to, which is less
+            // than 1 if maxevents impacts were processed before the end.
+            template <typename F>
+            T step(F f, size_t maxevents = 256);
+
+            // Returns the amount of objects.
+            size_t size() const;
+
+        protected:
+            struct Object
+            {
+                AABB<T> aabb;       // At local time
+                Vec2<T> vel;
+                T time;
+                size_t stamp;
+                typename LooseQuadtree<T>::Handle node;
+                bool alive;
+            };
+
+            struct Event
+            {
+                T time;
+                Handle a, b;
+                size_t stampa, stampb;
+                Vec2<T> normal;
+
+                bool operator>(const Event& other) const
+                {
+                    return time > other.time;
+                }
+            };
+
+            AABB<T> _getAt(Handle handle, T time) const;
+            AABB<T> _getSwept(Handle handle) const;
+            void    _advance(Handle handle, T time);
+
+            // Updates the swept bounds of an object and schedules impacts
+            // with all objects, or only with higher handles.
+            void _schedule(Handle handle, bool higheronly);
+            bool _findImpact(Handle a, Handle b, Event* event) const;
+
+        protected:
+            LooseQuadtree<T> _tree;
+            std::vector<Object> _objects;
+            std::vector<Handle> _owners;    // Tree handle -> object
+            std::vector<Handle> _freeobjects;
+            std::vector<Event> _events;
+            std::vector<typename LooseQuadtree<T>::Handle> _candidates;
+            size_t _size;
+            T _now;
+    };
+}
+
+
+#include <algorithm>
+#include <functional>
+#include <cassert>
+
+// Implementation
+namespace math
+{
+    template <typename T>
+    ImpactScheduler<T>::ImpactScheduler() :
+        _size(0),
+        _now(0)
+    { }
+
+    template <typename T>
+    ImpactScheduler<T>::ImpactScheduler(const AABB<T>& bounds, size_t maxdepth) :
+        ImpactScheduler()
+    {
+        reset(bounds, maxdepth);
+    }
+
+    template <typename T>
+    void ImpactScheduler<T>::reset(const AABB<T>& bounds, size_t maxdepth)
+    {
+        _tree.reset(bounds, maxdepth);
+        _objects.clear();
+        _owners.clear();
+        _freeobjects.clear();
+        _events.clear();
+        _size = 0;
+        _now = 0;
+    }
+
+    template <typename T>
+    void ImpactScheduler<T>::clear()
+    {
+        reset(_tree.getBounds());
+    }
+
+    template <typename T>
+    typename ImpactScheduler<T>::Handle ImpactScheduler<T>::add(const AABB<T>& aabb, const Vec2<T>& vel)
+    {
+        Handle handle;
+        if (!_freeobjects.empty())
+        {
+            handle = _freeobjects.back();
+            _freeobjects.pop_back();
+        }
+        else
+        {
+            handle = _objects.size();
+            _objects.push_back(Object());
+        }
+
+        Object& obj = _objects[handle];
+        obj.aabb = aabb;
+        obj.vel = vel;
+        obj.time = _now;
+        obj.stamp = 0;
+        obj.alive = true;
+        obj.node = _tree.insert(_getSwept(handle));
+        if (_owners.size() <= obj.node)
+            _owners.resize(obj.node + 1);
+        _owners[obj.node] = handle;
+        ++_size;
+        return handle;
+    }
+
+    template <typename T>
+    void ImpactScheduler<T>::remove(Handle handle)
+    {
+        assert(handle < _objects.size() && _objects[handle].alive && "invalid handle");
+        Object& obj = _objects[handle];
+        _tree.remove(obj.node);
+        obj.alive = false;
+        ++obj.stamp;
+        _freeobjects.push_back(handle);
+        --_size;
+    }
+
+    template <typename T>
+    void ImpactScheduler<T>::setVelocity(Handle handle, const Vec2<T>& vel)
+    {
+        _advance(handle, _now);
+        _objects[handle].vel = vel;
+        ++_objects[handle].stamp;
+        _schedule(handle, false);
+    }
+
+    template <typename T>
+    const Vec2<T>& ImpactScheduler<T>::getVelocity(Handle handle) const
+    {
+        return _objects[handle].vel;
+    }
+
+    template <typename T>
+    AABB<T> ImpactScheduler<T>::get(Handle handle) const
+    {
+        return _getAt(handle, _now);
+    }
+
+    template <typename T>
+    size_t ImpactScheduler<T>::size() const
+    {
+        return _size;
+    }
+
+    template <typename T>
+    template <typename F>
+    T ImpactScheduler<T>::step(F f, size_t maxevents)
+    {
+        _now = 0;
+        _events.clear();
+        for (Handle i = 0; i < _objects.size(); ++i)
+        {
+            if (_objects[i].alive)
+            {
+                _objects[i].time = 0;
+                _tree.update(_objects[i].node, _getSwept(i));
+            }
+        }
+        for (Handle i = 0; i < _objects.size(); ++i)
+            if (_objects[i].alive)
+                _schedule(i, true);
+
+        T end = 1;
+        size_t processed = 0;
+        while (!_events.empty())
+        {
+            std::pop_heap(_events.begin(), _events.end(), std::greater<Event>());
+            const Event event = _events.back();
+            _events.pop_back();
+
+            const Object& a = _objects[event.a];
+            const Object& b = _objects[event.b];
+            if (a.stamp != event.stampa || b.stamp != event.stampb)
+                continue;
+
+            if (processed == maxevents)
+            {
+                end = event.time;
+                break;
+            }
+            ++processed;
+
+            _now = event.time;
+            _advance(event.a, _now);
+            _advance(event.b, _now);
+            f(event.a, event.b, event.time, event.normal);
+
+            // Stop both if they still approach each other
+            Event next;
+            if (_findImpact(event.a, event.b, &next) && next.time <= _now)
+            {
+                setVelocity(event.a, Vec2<T>());
+                setVelocity(event.b, Vec2<T>());
+            }
+        }
+
+        // Move everything to the end of the step
+        _now = 0;
+        _events.clear();
+        for (Handle i = 0; i < _objects.size(); ++i)
+        {
+            if (_objects[i].alive)
+            {
+                _advance(i, end);
+                _objects[i].time = 0;
+            }
+        }
+        return end;
+    }
+
+    template <typename T>
+    AABB<T> ImpactScheduler<T>::_getAt(Handle handle, T time) const
+    {
+        const Object& obj = _objects[handle];
+        AABB<T> aabb = obj.aabb;
+        aabb.pos += obj.vel * (time - obj.time);
+        return aabb;
+    }
+
+    template <typename T>
+    AABB<T> ImpactScheduler<T>::_getSwept(Handle handle) const
+    {
+        const Object& obj = _objects[handle];
+        const AABB<T> from = _getAt(handle, std::max(_now, obj.time)),
+                      to = _getAt(handle, 1);
+        const Vec2<T> min = mins(from.pos, to.pos),
+                      max = maxs(from.pos + from.size, to.pos + to.size);
+        return AABB<T>(min.asPoint(), max - min);
+    }
+
+    template <typename T>
+    void ImpactScheduler<T>::_advance(Handle handle, T time)
+    {
+        Object& obj = _objects[handle];
+        obj.aabb = _getAt(handle, time);
+        obj.time = time;
+    }
+
+    template <typename T>
+    void ImpactScheduler<T>::_schedule(Handle handle, bool higheronly)
+    {
+        _tree.update(_objects[handle].node, _getSwept(handle));
+        _tree.query(_getSwept(handle), &_candidates);
+
+        Event event;
+        for (auto node : _candidates)
+        {
+            const Handle other = _owners[node];
+            if (other == handle || (higheronly && other < handle))
+                continue;
+
+            if (_findImpact(handle, other, &event))
+            {
+                _events.push_back(event);
+                std::push_heap(_events.begin(), _events.end(), std::greater<Event>());
+            }
+        }
+    }
+
+    template <typename T>
+    bool ImpactScheduler<T>::_findImpact(Handle a, Handle b, Event* event) const
+    {
+        const Object& oa = _objects[a];
+        const Object& ob = _objects[b];
+        const Vec2<T> vel = (oa.vel - ob.vel) * (1 - _now);
+        if (vel.x == 0 && vel.y == 0)
+            return false;
+
+        const AABB<T> boxa = _getAt(a, _now),
+                      boxb = _getAt(b, _now);
+        auto isec = sweep(boxa, vel, boxb);
+        if (!isec)
+            return false;
+
+        // Touching or overlapping already, only an impact if they move
+        // closer along the axis of least penetration.
+        if (isec.near <= 0)
+        {
+            const auto contact = intersect(boxa, boxb);
+            if (contact)
+                isec.normal = contact.normal;
+            if (isec.normal.dot(vel) >= 0)
+                return false;
+        }
+
+        event->time = _now + isec.near * (1 - _now);
+        event->a = a;
+        event->b = b;
+        event->stampa = oa.stamp;
+        event->stampb = ob.stamp;
+        event->normal = isec.normal;
+        return true;
+    }
+}
+
+#endif
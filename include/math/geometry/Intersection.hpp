@@ -14,7 +14,17 @@ namespace math
         LinexAABB,
         AABBxAABB,
         SweptAABBxAABB,
-        SweptAABBxLine
+        SweptAABBxLine,
+        LinexConvex,
+        SweptAABBxConvex,
+        LinexCircle,
+        LinexCapsule,
+        CirclexShape,
+        CapsulexShape,
+        SweptCirclexShape,
+        SweptCapsulexShape,
+        LinexOBB,
+        OBBxOBB
     };
 
     template <class T>
@@ -24,7 +34,7 @@ namespace math
             Intersection() : type(None) {}
             Intersection(IntersectionType type_) : type(type_) {}
 
-            // AABB vs AABB
+            // AABB vs AABB / OBB vs OBB / Circle or Capsule vs Shape
             Intersection(const Vec2<T>& d, const Vec2<T>& normal_) :
                 type(AABBxAABB), normal(normal_), delta(d) {}
 
@@ -32,7 +42,8 @@ namespace math
             Intersection(const Point2<T>& p_, const Vec2<T>& times_, const Vec2<T>& normal_) :
                 type(LinexLine), normal(normal_), times(times_), p(p_) {}
 
-            // Line vs AABB / Swept AABB vs AABB
+            // Line vs AABB / Swept AABB vs AABB / Line vs Convex / Line vs OBB /
+            // Line vs Circle or Capsule / Swept Circle or Capsule vs Shape
             Intersection(const Point2<T>& p1, const Point2<T>& p2, const Vec2<T>& times_, const Vec2<T>& normal_) :
                 type(LinexAABB), normal(normal_), times(times_), seg(p1, p2, Segment) {}
 
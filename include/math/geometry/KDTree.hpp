@@ -0,0 +1,283 @@
+#ifndef CPPMATH_GEOMETRY_KDTREE_HPP
+#define CPPMATH_GEOMETRY_KDTREE_HPP
+
+#include <vector>
+#include <cstdint>
+#include "PointSet.hpp"
+#include "../threading.hpp"
+
+/*
+ * A static 2D k-d tree for point queries.
+ * The tree is stored as a flat array without child pointers: the node
+ * of a range [begin, end) is its median element (begin + end) / 2, the
+ * left and right subtrees are the ranges before and after it. Each
+ * internal node splits along the axis of greater extent. Small ranges
+ * are scanned linearly.
+ * Query results are the indices of the points in the point set the tree
+ * was built from. The tree does not track changes of the point set.
+ */
+
+namespace math
+{
+    template <typename T>
+    class KDTree
+    {
+        public:
+            KDTree();
+            KDTree(const AbstractPointSet<T>& points, size_t numthreads = 0);
+
+            // Rebuilds the tree using up to numthreads threads (0 = auto).
+            void build(const AbstractPointSet<T>& points, size_t numthreads = 0);
+            void clear();
+
+            // Returns the index of the closest point or (size_t)-1 if the
+            // tree is empty. If sqrdist is not null, the squared distance
+            // is written to it.
+            size_t findNearest(const Point2<T>& p, T* sqrdist = nullptr) const;
+
+            // Finds the k closest points, sorted by distance, and writes
+            // their indices and squared distances to the given buffers,
+            // which must have room for k elements.
+            // Returns the amount of points found, i.e. min(k, size()).
+            size_t findNearest(const Point2<T>& p, size_t k, size_t* indices, T* sqrdists) const;
+
+            // Finds all points within the given radius (inclusive).
+            // Existing content of out will be removed.
+            void findInRadius(const Point2<T>& p, T radius, std::vector<size_t>* out) const;
+
+            // Finds all points inside the AABB, following the same rules
+            // as intersect(AABB, Point2).
+            // Existing content of out will be removed.
+            void findInRange(const AABB<T>& range, std::vector<size_t>* out) const;
+
+            size_t size() const;
+
+        protected:
+            struct Node
+            {
+                Point2<T> p;
+                size_t index;
+                uint8_t axis;
+            };
+
+            void _build(size_t begin, size_t end, size_t numthreads);
+
+            void _findNearest(size_t begin, size_t end, const Point2<T>& p, size_t k,
+                              size_t* indices, T* sqrdists, size_t* found) const;
+
+            template <typename F>
+            void _findInRange(size_t begin, size_t end, const Vec2<T>& min, const Vec2<T>& max, F f) const;
+
+        protected:
+            std::vector<Node> _nodes;
+    };
+}
+
+
+#include <algorithm>
+#include <thread>
+#include <cassert>
+
+#ifndef CPPMATH_KDTREE_LEAF_SIZE
+#define CPPMATH_KDTREE_LEAF_SIZE 8
+#endif
+
+// Implementation
+namespace math
+{
+    template <typename T>
+    KDTree<T>::KDTree()
+    { }
+
+    template <typename T>
+    KDTree<T>::KDTree(const AbstractPointSet<T>& points, size_t numthreads)
+    {
+        build(points, numthreads);
+    }
+
+    template <typename T>
+    void KDTree<T>::build(const AbstractPointSet<T>& points, size_t numthreads)
+    {
+        _nodes.resize(points.size());
+        for (size_t i = 0; i < _nodes.size(); ++i)
+        {
+            _nodes[i].p = points.get(i);
+            _nodes[i].index = i;
+            _nodes[i].axis = 0;
+        }
+        _build(0, _nodes.size(), getThreadCount(numthreads));
+    }
+
+    template <typename T>
+    void KDTree<T>::clear()
+    {
+        _nodes.clear();
+    }
+
+    template <typename T>
+    void KDTree<T>::_build(size_t begin, size_t end, size_t numthreads)
+    {
+        if (end - begin <= CPPMATH_KDTREE_LEAF_SIZE)
+            return;
+
+        Vec2<T> min = _nodes[begin].p.asVector(),
+                max = min;
+        for (size_t i = begin + 1; i < end; ++i)
+        {
+            min = mins(min, _nodes[i].p.asVector());
+            max = maxs(max, _nodes[i].p.asVector());
+        }
+
+        const size_t mid = (begin + end) / 2;
+        const uint8_t axis = max.x - min.x >= max.y - min.y ? 0 : 1;
+
+        std::nth_element(_nodes.begin() + begin, _nodes.begin() + mid, _nodes.begin() + end,
+                [axis](const Node& a, const Node& b) { return a.p[axis] < b.p[axis]; });
+        _nodes[mid].axis = axis;
+
+        // Only split off threads for large enough subtrees
+        if (numthreads > 1 && end - begin > 4096)
+        {
+            std::thread t(&KDTree<T>::_build, this, mid + 1, end, numthreads / 2);
+            _build(begin, mid, numthreads - numthreads / 2);
+            t.join();
+        }
+        else
+        {
+            _build(begin, mid, 1);
+            _build(mid + 1, end, 1);
+        }
+    }
+
+    template <typename T>
+    size_t KDTree<T>::findNearest(const Point2<T>& p, T* sqrdist) const
+    {
+        size_t index;
+        T dist;
+        if (findNearest(p, 1, &index, &dist) == 0)
+            return (size_t)-1;
+        if (sqrdist)
+            *sqrdist = dist;
+        return index;
+    }
+
+    template <typename T>
+    size_t KDTree<T>::findNearest(const Point2<T>& p, size_t k, size_t* indices, T* sqrdists) const
+    {
+        assert(indices && "indices is null");
+        assert(sqrdists && "sqrdists is null");
+
+        size_t found = 0;
+        if (k > 0)
+            _findNearest(0, _nodes.size(), p, k, indices, sqrdists, &found);
+        return found;
+    }
+
+    template <typename T>
+    void KDTree<T>::_findNearest(size_t begin, size_t end, const Point2<T>& p, size_t k,
+                                 size_t* indices, T* sqrdists, size_t* found) const
+    {
+        // Inserts a node into the sorted result buffers
+        auto consider = [&](const Node& node) {
+            T d = (node.p - p).abs_sqr();
+            if (*found == k && d >= sqrdists[k - 1])
+                return;
+
+            size_t i = *found < k ? (*found)++ : k - 1;
+            for (; i > 0 && sqrdists[i - 1] > d; --i)
+            {
+                sqrdists[i] = sqrdists[i - 1];
+                indices[i] = indices[i - 1];
+            }
+            sqrdists[i] = d;
+            indices[i] = node.index;
+        };
+
+        if (end - begin <= CPPMATH_KDTREE_LEAF_SIZE)
+        {
+            for (size_t i = begin; i < end; ++i)
+                consider(_nodes[i]);
+            return;
+        }
+
+        const size_t mid = (begin + end) / 2;
+        const Node& node = _nodes[mid];
+        const T diff = p[node.axis] - node.p[node.axis];
+
+        consider(node);
+
+        // Visit the near side first, then the far side only if the
+        // splitting plane is closer than the current k-th distance.
+        if (diff < 0)
+            _findNearest(begin, mid, p, k, indices, sqrdists, found);
+        else
+            _findNearest(mid + 1, end, p, k, indices, sqrdists, found);
+
+        if (*found < k || diff * diff < sqrdists[k - 1])
+        {
+            if (diff < 0)
+                _findNearest(mid + 1, end, p, k, indices, sqrdists, found);
+            else
+                _findNearest(begin, mid, p, k, indices, sqrdists, found);
+        }
+    }
+
+    template <typename T>
+    void KDTree<T>::findInRadius(const Point2<T>& p, T radius, std::vector<size_t>* out) const
+    {
+        assert(out && "out is null");
+        out->clear();
+
+        const T r2 = radius * radius;
+        const Vec2<T> r(radius, radius);
+        _findInRange(0, _nodes.size(), p.asVector() - r, p.asVector() + r, [&](const Node& node) {
+            if ((node.p - p).abs_sqr() <= r2)
+                out->push_back(node.index);
+        });
+    }
+
+    template <typename T>
+    void KDTree<T>::findInRange(const AABB<T>& range, std::vector<size_t>* out) const
+    {
+        assert(out && "out is null");
+        out->clear();
+
+        const Vec2<T> min = range.pos,
+                      max = range.pos + range.size;
+        _findInRange(0, _nodes.size(), min, max, [&](const Node& node) {
+            if (node.p.asVector() >= min && node.p.asVector() < max)
+                out->push_back(node.index);
+        });
+    }
+
+    // Calls f for all nodes that might be inside [min, max].
+    template <typename T>
+    template <typename F>
+    void KDTree<T>::_findInRange(size_t begin, size_t end, const Vec2<T>& min, const Vec2<T>& max, F f) const
+    {
+        if (end - begin <= CPPMATH_KDTREE_LEAF_SIZE)
+        {
+            for (size_t i = begin; i < end; ++i)
+                f(_nodes[i]);
+            return;
+        }
+
+        const size_t mid = (begin + end) / 2;
+        const Node& node = _nodes[mid];
+        const T split = node.p[node.axis];
+
+        f(node);
+        if (min[node.axis] <= split)
+            _findInRange(begin, mid, min, max, f);
+        if (max[node.axis] >= split)
+            _findInRange(mid + 1, end, min, max, f);
+    }
+
+    template <typename T>
+    size_t KDTree<T>::size() const
+    {
+        return _nodes.size();
+    }
+}
+
+#endif
@@ -0,0 +1,200 @@
+#ifndef MATH_LODPOLYGON_HPP
+#define MATH_LODPOLYGON_HPP
+
+#include <vector>
+#include "OffsetPolygon.hpp"
+
+/*
+ * An OffsetPolygon that additionally caches simplified versions of itself.
+ * Level 0 is the polygon itself, level i > 0 is simplified with the
+ * Visvalingam-Whyatt algorithm using the (i - 1)th area tolerance.
+ * All levels are computed in a single O(n log n) pass and are lazily
+ * rebuilt by getLevel() when a vertex changed, hence they are mutable and
+ * getLevel() is not thread-safe. Moving the polygon or changing its fill
+ * type or normal direction updates the levels directly.
+ */
+
+namespace math
+{
+    template <typename T>
+    class LODPolygon : public OffsetPolygon<T>
+    {
+        public:
+            LODPolygon();
+            LODPolygon(const std::vector<double>& tolerances);
+            virtual ~LODPolygon() {}
+
+            // Sets the area tolerances for each level, sorted ascending.
+            // If maxvertices is not empty, it specifies the maximum amount of
+            // vertices per level (0 = unlimited).
+            void setTolerances(const std::vector<double>& tolerances,
+                               const std::vector<size_t>& maxvertices = std::vector<size_t>());
+
+            // Returns the number of levels, including level 0.
+            size_t getLevelCount() const;
+
+            // Returns the polygon at the given level of detail.
+            // Levels beyond the last one return the last one.
+            const AbstractPolygon<T>& getLevel(size_t level) const;
+
+            virtual void setFillType(FillType filltype) override;
+            virtual void setNormalDir(NormalDirection ndir) override;
+
+        protected:
+            virtual void _add(const Point2<T>& point)          override;
+            virtual void _edit(size_t i, const Point2<T>& p)   override;
+            virtual void _insert(size_t i, const Point2<T>& p) override;
+            virtual void _remove(size_t i)                     override;
+            virtual void _clear()                              override;
+
+            virtual void _onVertexChanged() override;
+
+            // Rebuilds the levels, called lazily from getLevel()
+            void _updateLevels() const;
+
+        protected:
+            std::vector<double> _tolerances;
+            std::vector<size_t> _maxvertices;
+            // Lazily rebuilt cache
+            mutable std::vector<OffsetPolygon<T>> _levels;
+            mutable bool _lodsdirty;
+    };
+}
+
+
+#include "simplify.hpp"
+
+// Implementation
+namespace math
+{
+    template <typename T>
+    LODPolygon<T>::LODPolygon() :
+        _lodsdirty(true)
+    { }
+
+    template <typename T>
+    LODPolygon<T>::LODPolygon(const std::vector<double>& tolerances) :
+        _lodsdirty(true)
+    {
+        setTolerances(tolerances);
+    }
+
+    template <typename T>
+    void LODPolygon<T>::setTolerances(const std::vector<double>& tolerances,
+                                      const std::vector<size_t>& maxvertices)
+    {
+        _tolerances = tolerances;
+        _maxvertices = maxvertices;
+        _maxvertices.resize(_tolerances.size(), 0);
+        _levels.resize(_tolerances.size());
+        _lodsdirty = true;
+    }
+
+    template <typename T>
+    size_t LODPolygon<T>::getLevelCount() const
+    {
+        return _tolerances.size() + 1;
+    }
+
+    template <typename T>
+    const AbstractPolygon<T>& LODPolygon<T>::getLevel(size_t level) const
+    {
+        if (level == 0 || _levels.empty())
+            return *this;
+
+        if (_lodsdirty)
+        {
+            _updateLevels();
+            _lodsdirty = false;
+        }
+
+        return _levels[std::min(level, _levels.size()) - 1];
+    }
+
+    template <typename T>
+    void LODPolygon<T>::setFillType(FillType filltype)
+    {
+        // Open polygons keep their end points, closed ones don't
+        if ((filltype == Open) != (this->_filltype == Open))
+            _lodsdirty = true;
+        OffsetPolygon<T>::setFillType(filltype);
+        for (auto& pol : _levels)
+            pol.setFillType(filltype);
+    }
+
+    template <typename T>
+    void LODPolygon<T>::setNormalDir(NormalDirection ndir)
+    {
+        OffsetPolygon<T>::setNormalDir(ndir);
+        for (auto& pol : _levels)
+            pol.setNormalDir(ndir);
+    }
+
+    template <typename T>
+    void LODPolygon<T>::_onVertexChanged()
+    {
+        OffsetPolygon<T>::_onVertexChanged();
+
+        // Vertex edits rebuild the levels anyway
+        if (!_lodsdirty)
+            for (auto& pol : _levels)
+                pol.setOffset(this->_offset);
+    }
+
+    template <typename T>
+    void LODPolygon<T>::_updateLevels() const
+    {
+        std::vector<double> importance;
+        std::vector<size_t> rank;
+        detail::visvalingamImportance(this->_vertices, this->_filltype != Open, &importance, &rank);
+
+        for (size_t i = 0; i < _levels.size(); ++i)
+        {
+            // Vertices are stored relative to the offset
+            OffsetPolygon<T>& pol = _levels[i];
+            pol.setOffset(Vec2<T>());
+            detail::filterByImportance(this->_vertices, importance, rank,
+                                       _tolerances[i], _maxvertices[i], &pol);
+            pol.setOffset(this->_offset);
+            pol.setFillType(this->_filltype);
+            pol.setNormalDir(this->_ndir);
+        }
+    }
+
+    template <typename T>
+    void LODPolygon<T>::_add(const Point2<T>& point)
+    {
+        OffsetPolygon<T>::_add(point);
+        _lodsdirty = true;
+    }
+
+    template <typename T>
+    void LODPolygon<T>::_edit(size_t i, const Point2<T>& p)
+    {
+        OffsetPolygon<T>::_edit(i, p);
+        _lodsdirty = true;
+    }
+
+    template <typename T>
+    void LODPolygon<T>::_insert(size_t i, const Point2<T>& p)
+    {
+        OffsetPolygon<T>::_insert(i, p);
+        _lodsdirty = true;
+    }
+
+    template <typename T>
+    void LODPolygon<T>::_remove(size_t i)
+    {
+        OffsetPolygon<T>::_remove(i);
+        _lodsdirty = true;
+    }
+
+    template <typename T>
+    void LODPolygon<T>::_clear()
+    {
+        OffsetPolygon<T>::_clear();
+        _lodsdirty = true;
+    }
+}
+
+#endif
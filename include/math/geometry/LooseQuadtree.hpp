@@ -0,0 +1,483 @@
+#ifndef CPPMATH_GEOMETRY_LOOSE_QUADTREE_HPP
+#define CPPMATH_GEOMETRY_LOOSE_QUADTREE_HPP
+
+#include <vector>
+#include <cstdint>
+#include "Intersection.hpp"
+#include "AABB.hpp"
+
+/*
+ * A loose quadtree storing AABBs of arbitrary size.
+ * Each node's bounds are extended by a looseness factor, so an object is
+ * stored in the node at the depth matching its size that contains its
+ * center. Hence, objects never straddle node borders and the node of an
+ * object can be computed directly from its AABB.
+ * Nodes and objects are kept in pools and objects are identified by
+ * handles, which remain valid until the object is removed.
+ * Moving an object that stays inside its node's loose bounds is O(1),
+ * otherwise it is O(depth).
+ * Objects outside the tree's bounds are stored in the root node.
+ */
+
+namespace math
+{
+    template <typename T>
+    class LooseQuadtree
+    {
+        public:
+            typedef size_t Handle;
+            static const Handle invalid = (Handle)-1;
+
+        public:
+            LooseQuadtree();
+            LooseQuadtree(const AABB<T>& bounds, size_t maxdepth = 8, T looseness = 2);
+
+            // Sets the covered area and removes all objects.
+            // looseness is the size of a node's loose bounds relative to its
+            // actual size and must be > 1.
+            void reset(const AABB<T>& bounds, size_t maxdepth = 8, T looseness = 2);
+            void clear();
+
+            Handle insert(const AABB<T>& aabb);
+            void   update(Handle handle, const AABB<T>& aabb);
+            void   move(Handle handle, const Vec2<T>& offset);
+            void   remove(Handle handle);
+
+            const AABB<T>& get(Handle handle) const;
+
+            // Calls f for each object overlapping or touching the given area.
+            // Returning true breaks the loop.
+            // Callback signature: bool (Handle handle, const AABB<T>& aabb)
+            template <typename F>
+            void query(const AABB<T>& range, F f) const;
+
+            // Same as above, but writes the results to out.
+            // Existing content of out will be removed.
+            void query(const AABB<T>& range, std::vector<Handle>* out) const;
+
+            // Finds all objects containing the given point.
+            // Existing content of out will be removed.
+            void query(const Point2<T>& point, std::vector<Handle>* out) const;
+
+            // Returns the first object hit by a line in the same format as
+            // intersect(Line2, AABB).
+            Intersection<T> raycast(const Line2<T>& line, Handle* handle = nullptr) const;
+
+            // Returns the amount of objects.
+            size_t size() const;
+
+            const AABB<T>& getBounds() const;
+
+        protected:
+            typedef uint32_t Index;
+            static const Index npos = (Index)-1;
+
+            struct Node
+            {
+                Index children[4];
+                Index parent;
+                Index first;    // First object
+                Index count;    // Amount of objects in this node
+                uint8_t depth;
+                int x, y;       // Cell coordinates at this depth
+            };
+
+            struct Object
+            {
+                AABB<T> aabb;
+                Index node;
+                Index prev, next;
+            };
+
+            // Computes the node cell for an AABB.
+            void _locate(const AABB<T>& aabb, int* depth, int* x, int* y) const;
+
+            // Returns the loose bounds of a node as min and max corners.
+            void _getLooseBounds(const Node& node, Vec2<T>* min, Vec2<T>* max) const;
+
+            Index _allocNode(Index parent, int depth, int x, int y);
+            void  _link(Index obj, int depth, int x, int y);
+            void  _unlink(Index obj);
+
+            template <typename F>
+            bool _query(Index node, const Vec2<T>& min, const Vec2<T>& max, F& f) const;
+
+            void _raycast(Index node, const Line2<T>& line, Intersection<T>* best, Handle* handle) const;
+
+        protected:
+            AABB<T> _bounds;
+            size_t _maxdepth;
+            T _looseness;
+            size_t _size;
+            std::vector<Node> _nodes;
+            std::vector<Object> _objects;
+            Index _freenodes, _freeobjects;
+    };
+}
+
+
+#include "intersect.hpp"
+#include <cmath>
+#include <cassert>
+
+// Implementation
+namespace math
+{
+    template <typename T>
+    const typename LooseQuadtree<T>::Handle LooseQuadtree<T>::invalid;
+
+    template <typename T>
+    const typename LooseQuadtree<T>::Index LooseQuadtree<T>::npos;
+
+    template <typename T>
+    LooseQuadtree<T>::LooseQuadtree()
+    {
+        reset(AABB<T>(0, 0, 1, 1), 0);
+    }
+
+    template <typename T>
+    LooseQuadtree<T>::LooseQuadtree(const AABB<T>& bounds, size_t maxdepth, T looseness)
+    {
+        reset(bounds, maxdepth, looseness);
+    }
+
+    template <typename T>
+    void LooseQuadtree<T>::reset(const AABB<T>& bounds, size_t maxdepth, T looseness)
+    {
+        assert(looseness > 1 && "looseness must be > 1");
+        assert(maxdepth < 31 && "maxdepth too large");
+        _bounds = bounds;
+        _maxdepth = maxdepth;
+        _looseness = looseness;
+        clear();
+    }
+
+    template <typename T>
+    void LooseQuadtree<T>::clear()
+    {
+        _nodes.clear();
+        _objects.clear();
+        _freenodes = _freeobjects = npos;
+        _size = 0;
+        _allocNode(npos, 0, 0, 0);
+    }
+
+    template <typename T>
+    typename LooseQuadtree<T>::Handle LooseQuadtree<T>::insert(const AABB<T>& aabb)
+    {
+        Index obj;
+        if (_freeobjects != npos)
+        {
+            obj = _freeobjects;
+            _freeobjects = _objects[obj].next;
+        }
+        else
+        {
+            obj = _objects.size();
+            _objects.push_back(Object());
+        }
+
+        _objects[obj].aabb = aabb;
+
+        int depth, x, y;
+        _locate(aabb, &depth, &x, &y);
+        _link(obj, depth, x, y);
+        ++_size;
+        return obj;
+    }
+
+    template <typename T>
+    void LooseQuadtree<T>::update(Handle handle, const AABB<T>& aabb)
+    {
+        assert(handle < _objects.size() && _objects[handle].node != npos && "invalid handle");
+
+        Object& obj = _objects[handle];
+        const Node& node = _nodes[obj.node];
+        obj.aabb = aabb;
+
+        int depth, x, y;
+        _locate(aabb, &depth, &x, &y);
+        if (depth == node.depth && x == node.x && y == node.y)
+            return;
+
+        // Stay in the current node as long as it fits into its loose bounds
+        if (obj.node != 0)
+        {
+            Vec2<T> min, max;
+            _getLooseBounds(node, &min, &max);
+            if (min <= aabb.pos && aabb.pos + aabb.size <= max)
+                return;
+        }
+
+        _unlink(handle);
+        _link(handle, depth, x, y);
+    }
+
+    template <typename T>
+    void LooseQuadtree<T>::move(Handle handle, const Vec2<T>& offset)
+    {
+        AABB<T> aabb = get(handle);
+        aabb.pos += offset;
+        update(handle, aabb);
+    }
+
+    template <typename T>
+    void LooseQuadtree<T>::remove(Handle handle)
+    {
+        assert(handle < _objects.size() && _objects[handle].node != npos && "invalid handle");
+        _unlink(handle);
+        _objects[handle].next = _freeobjects;
+        _freeobjects = handle;
+        --_size;
+    }
+
+    template <typename T>
+    const AABB<T>& LooseQuadtree<T>::get(Handle handle) const
+    {
+        assert(handle < _objects.size() && _objects[handle].node != npos && "invalid handle");
+        return _objects[handle].aabb;
+    }
+
+    template <typename T>
+    void LooseQuadtree<T>::_locate(const AABB<T>& aabb, int* depth, int* x, int* y) const
+    {
+        *depth = *x = *y = 0;
+
+        Point2<T> center = aabb.getCenter();
+        if (!intersect(_bounds, center))
+            return;
+
+        // Deepest level whose loose bounds can still hold the object
+        // when its center lies inside the cell.
+        const double slack = _looseness - 1;
+        double cw = _bounds.w, ch = _bounds.h;
+        while ((size_t)*depth < _maxdepth && aabb.w <= cw / 2 * slack && aabb.h <= ch / 2 * slack)
+        {
+            ++*depth;
+            cw /= 2;
+            ch /= 2;
+        }
+
+        const int n = 1 << *depth;
+        *x = std::min(n - 1, (int)((center.x - _bounds.x) / cw));
+        *y = std::min(n - 1, (int)((center.y - _bounds.y) / ch));
+    }
+
+    template <typename T>
+    void LooseQuadtree<T>::_getLooseBounds(const Node& node, Vec2<T>* min, Vec2<T>* max) const
+    {
+        const double scale = 1.0 / (1 << node.depth);
+        const Vec2d size = Vec2d(_bounds.size) * scale,
+                    pad = size * ((_looseness - 1) / 2.0),
+                    pos = Vec2d(_bounds.pos) + Vec2d(node.x, node.y) * size;
+        *min = Vec2<T>(pos - pad);
+        *max = Vec2<T>(pos + size + pad);
+    }
+
+    template <typename T>
+    typename LooseQuadtree<T>::Index LooseQuadtree<T>::_allocNode(Index parent, int depth, int x, int y)
+    {
+        Index i;
+        if (_freenodes != npos)
+        {
+            i = _freenodes;
+            _freenodes = _nodes[i].parent;
+        }
+        else
+        {
+            i = _nodes.size();
+            _nodes.push_back(Node());
+        }
+
+        Node& node = _nodes[i];
+        std::fill(node.children, node.children + 4, npos);
+        node.parent = parent;
+        node.first = npos;
+        node.count = 0;
+        node.depth = depth;
+        node.x = x;
+        node.y = y;
+        return i;
+    }
+
+    template <typename T>
+    void LooseQuadtree<T>::_link(Index obj, int depth, int x, int y)
+    {
+        // Walk down from the root, creating nodes as needed
+        Index cur = 0;
+        for (int d = 1; d <= depth; ++d)
+        {
+            int shift = depth - d;
+            int cx = x >> shift,
+                cy = y >> shift;
+            int child = (cx & 1) + (cy & 1) * 2;
+
+            Index next = _nodes[cur].children[child];
+            if (next == npos)
+            {
+                next = _allocNode(cur, d, cx, cy);
+                _nodes[cur].children[child] = next;
+            }
+            cur = next;
+        }
+
+        Node& node = _nodes[cur];
+        Object& o = _objects[obj];
+        o.node = cur;
+        o.prev = npos;
+        o.next = node.first;
+        if (node.first != npos)
+            _objects[node.first].prev = obj;
+        node.first = obj;
+        ++node.count;
+    }
+
+    template <typename T>
+    void LooseQuadtree<T>::_unlink(Index obj)
+    {
+        Object& o = _objects[obj];
+        Index cur = o.node;
+
+        if (o.prev != npos)
+            _objects[o.prev].next = o.next;
+        else
+            _nodes[cur].first = o.next;
+        if (o.next != npos)
+            _objects[o.next].prev = o.prev;
+        --_nodes[cur].count;
+        o.node = npos;
+
+        // Release empty leaves
+        while (cur != 0)
+        {
+            Node& node = _nodes[cur];
+            if (node.count > 0)
+                break;
+            for (int i = 0; i < 4; ++i)
+                if (node.children[i] != npos)
+                    return;
+
+            Index parent = node.parent;
+            Node& p = _nodes[parent];
+            for (int i = 0; i < 4; ++i)
+                if (p.children[i] == cur)
+                    p.children[i] = npos;
+
+            node.parent = _freenodes;
+            _freenodes = cur;
+            cur = parent;
+        }
+    }
+
+    template <typename T>
+    template <typename F>
+    void LooseQuadtree<T>::query(const AABB<T>& range, F f) const
+    {
+        _query(0, range.pos, range.pos + range.size, f);
+    }
+
+    template <typename T>
+    template <typename F>
+    bool LooseQuadtree<T>::_query(Index i, const Vec2<T>& min, const Vec2<T>& max, F& f) const
+    {
+        const Node& node = _nodes[i];
+
+        // The root may contain objects outside its bounds
+        if (i != 0)
+        {
+            Vec2<T> nmin, nmax;
+            _getLooseBounds(node, &nmin, &nmax);
+            if (!(nmin <= max && min <= nmax))
+                return false;
+        }
+
+        for (Index o = node.first; o != npos; o = _objects[o].next)
+        {
+            const AABB<T>& aabb = _objects[o].aabb;
+            if (aabb.pos <= max && min <= aabb.pos + aabb.size && f((Handle)o, aabb))
+                return true;
+        }
+
+        for (int c = 0; c < 4; ++c)
+            if (node.children[c] != npos && _query(node.children[c], min, max, f))
+                return true;
+        return false;
+    }
+
+    template <typename T>
+    void LooseQuadtree<T>::query(const AABB<T>& range, std::vector<Handle>* out) const
+    {
+        assert(out && "out is null");
+        out->clear();
+        query(range, [out](Handle h, const AABB<T>&) {
+            out->push_back(h);
+            return false;
+        });
+    }
+
+    template <typename T>
+    void LooseQuadtree<T>::query(const Point2<T>& point, std::vector<Handle>* out) const
+    {
+        assert(out && "out is null");
+        out->clear();
+
+        auto f = [&](Handle h, const AABB<T>& aabb) {
+            if (intersect(aabb, point))
+                out->push_back(h);
+            return false;
+        };
+        _query(0, point.asVector(), point.asVector(), f);
+    }
+
+    template <typename T>
+    Intersection<T> LooseQuadtree<T>::raycast(const Line2<T>& line, Handle* handle) const
+    {
+        Intersection<T> best;
+        _raycast(0, line, &best, handle);
+        return best;
+    }
+
+    template <typename T>
+    void LooseQuadtree<T>::_raycast(Index i, const Line2<T>& line, Intersection<T>* best, Handle* handle) const
+    {
+        const Node& node = _nodes[i];
+
+        if (i != 0)
+        {
+            Vec2<T> min, max;
+            _getLooseBounds(node, &min, &max);
+            auto isec = intersect(line, AABB<T>(min.asPoint(), max - min));
+            if (!isec || (*best && isec.time >= best->time))
+                return;
+        }
+
+        for (Index o = node.first; o != npos; o = _objects[o].next)
+        {
+            auto isec = intersect(line, _objects[o].aabb);
+            if (isec && (!*best || isec.time < best->time))
+            {
+                *best = isec;
+                if (handle)
+                    *handle = o;
+            }
+        }
+
+        for (int c = 0; c < 4; ++c)
+            if (node.children[c] != npos)
+                _raycast(node.children[c], line, best, handle);
+    }
+
+    template <typename T>
+    size_t LooseQuadtree<T>::size() const
+    {
+        return _size;
+    }
+
+    template <typename T>
+    const AABB<T>& LooseQuadtree<T>::getBounds() const
+    {
+        return _bounds;
+    }
+}
+
+#endif
@@ -0,0 +1,40 @@
+#ifndef CPPMATH_MANIFOLD_HPP
+#define CPPMATH_MANIFOLD_HPP
+
+#include <cstdint>
+#include "Vector.hpp"
+#include "Point2.hpp"
+
+namespace math
+{
+    template <class T>
+    struct ContactPoint
+    {
+        Point2<T> p;    // Deepest point of the incident shape
+        T depth;        // Penetration depth along the normal, >= 0
+        uint32_t id;    // Feature id, stays the same as long as the same
+                        // features are in contact
+    };
+
+    // Contact manifold of two overlapping convex shapes a and b.
+    // Like Intersection's AABB vs AABB normal, the normal points from b
+    // towards a, i.e. moving a by normal * depth resolves a contact.
+    template <class T>
+    class Manifold
+    {
+        public:
+            Manifold() : count(0) {}
+
+            operator bool() const
+            {
+                return count > 0;
+            }
+
+        public:
+            Vec2<T> normal;
+            ContactPoint<T> points[2];
+            size_t count;
+    };
+}
+
+#endif
@@ -0,0 +1,210 @@
+#ifndef CPPMATH_GEOMETRY_OBB_HPP
+#define CPPMATH_GEOMETRY_OBB_HPP
+
+#include "AABB.hpp"
+
+/*
+ * An oriented bounding box, i.e. a rectangle rotated around its center.
+ * axis is the unit direction of the box's local x axis, the local y axis
+ * is axis rotated by 90 degrees (axis.right()). halfsize is the extent
+ * along both local axes.
+ * fromPoints() fits the box of minimum area with rotating calipers: one
+ * side of the minimum box is collinear with an edge of the convex hull,
+ * so the calipers walk along all hull edges while advancing the vertices
+ * that are extreme in the other three directions. This takes O(n log n)
+ * for the hull and O(h) for the calipers.
+ * OBBs are meant for floating point types.
+ */
+
+namespace math
+{
+    template <typename>
+    class AbstractPointSet;
+
+    template <class T>
+    class OBB
+    {
+        public:
+            OBB();
+            OBB(const Point2<T>& center_, const Vec2<T>& halfsize_, const Vec2<T>& axis_ = Vec2<T>(1, 0));
+            OBB(const AABB<T>& aabb);
+
+            // Fits the box of minimum area around the given points.
+            static OBB<T> fromPoints(const AbstractPointSet<T>& points);
+
+        public:
+            Vec2<T> getAxisY() const;
+
+            // Writes the 4 corners to out, in the same winding as the
+            // corners of an AABB.
+            void getCorners(Point2<T>* out) const;
+
+            AABB<T> getBBox() const;
+            T getArea() const;
+
+        public:
+            Point2<T> center;
+            Vec2<T> halfsize;
+            Vec2<T> axis;
+    };
+
+    typedef OBB<float> OBBf;
+    typedef OBB<double> OBBd;
+}
+
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+// Implementation
+namespace math
+{
+    namespace detail
+    {
+        // Convex hull with Andrew's monotone chain. The result has the
+        // same winding as AABB corners and contains no collinear points.
+        inline void obbHull(std::vector<Point2d>* points)
+        {
+            auto& p = *points;
+            std::sort(p.begin(), p.end(), [](const Point2d& a, const Point2d& b) {
+                return a.x != b.x ? a.x < b.x : a.y < b.y;
+            });
+            p.erase(std::unique(p.begin(), p.end()), p.end());
+            if (p.size() < 3)
+                return;
+
+            std::vector<Point2d> hull(2 * p.size());
+            size_t k = 0;
+            for (size_t i = 0; i < p.size(); ++i)
+            {
+                while (k >= 2 && (hull[k - 1] - hull[k - 2]).cross(p[i] - hull[k - 2]) <= 0)
+                    --k;
+                hull[k++] = p[i];
+            }
+            for (size_t i = p.size() - 1, lower = k + 1; i-- > 0;)
+            {
+                while (k >= lower && (hull[k - 1] - hull[k - 2]).cross(p[i] - hull[k - 2]) <= 0)
+                    --k;
+                hull[k++] = p[i];
+            }
+            hull.resize(k - 1);
+            p.swap(hull);
+        }
+    }
+
+
+    template <class T>
+    OBB<T>::OBB() :
+        axis(1, 0)
+    { }
+
+    template <class T>
+    OBB<T>::OBB(const Point2<T>& center_, const Vec2<T>& halfsize_, const Vec2<T>& axis_) :
+        center(center_),
+        halfsize(halfsize_),
+        axis(axis_)
+    { }
+
+    template <class T>
+    OBB<T>::OBB(const AABB<T>& aabb) :
+        center(aabb.getCenter()),
+        halfsize(aabb.size / 2),
+        axis(1, 0)
+    { }
+
+    template <class T>
+    OBB<T> OBB<T>::fromPoints(const AbstractPointSet<T>& points)
+    {
+        std::vector<Point2d> hull(points.size());
+        for (size_t i = 0; i < hull.size(); ++i)
+            hull[i] = points.get(i);
+        detail::obbHull(&hull);
+
+        const size_t n = hull.size();
+        if (n == 0)
+            return OBB<T>();
+        if (n == 1)
+            return OBB<T>(Point2<T>(hull[0]), Vec2<T>());
+        if (n == 2)
+        {
+            // Collinear points
+            const Vec2d d = hull[1] - hull[0];
+            return OBB<T>(Point2<T>(hull[0] + d / 2), Vec2<T>(d.abs() / 2, 0), Vec2<T>(d.normalized()));
+        }
+
+        // Extreme vertices in direction of the edge (right), away from it
+        // (top) and against it (left)
+        size_t right = 0, top = 0, left = 0;
+        double minarea = -1;
+        OBB<T> best;
+        for (size_t i = 0; i < n; ++i)
+        {
+            const Point2d p = hull[i];
+            const Vec2d u = (hull[(i + 1) % n] - p).normalized(),
+                        v = u.right();
+            auto proju = [&](size_t k) { return u.dot(hull[k % n] - p); };
+            auto projv = [&](size_t k) { return v.dot(hull[k % n] - p); };
+
+            if (i == 0)
+                right = 1;
+            while (proju(right + 1) > proju(right))
+                right = (right + 1) % n;
+            if (i == 0)
+                top = right;
+            while (projv(top + 1) > projv(top))
+                top = (top + 1) % n;
+            if (i == 0)
+                left = top;
+            while (proju(left + 1) < proju(left))
+                left = (left + 1) % n;
+
+            const double minu = proju(left),
+                         maxu = proju(right),
+                         height = projv(top),
+                         area = (maxu - minu) * height;
+            if (minarea < 0 || area < minarea)
+            {
+                minarea = area;
+                best = OBB<T>(Point2<T>(p + u * ((minu + maxu) / 2) + v * (height / 2)),
+                              Vec2<T>((maxu - minu) / 2, height / 2),
+                              Vec2<T>(u));
+            }
+        }
+        return best;
+    }
+
+    template <class T>
+    Vec2<T> OBB<T>::getAxisY() const
+    {
+        return axis.right();
+    }
+
+    template <class T>
+    void OBB<T>::getCorners(Point2<T>* out) const
+    {
+        const Vec2<T> x = axis * halfsize.x,
+                      y = getAxisY() * halfsize.y;
+        out[0] = center - x - y;
+        out[1] = center + x - y;
+        out[2] = center + x + y;
+        out[3] = center - x + y;
+    }
+
+    template <class T>
+    AABB<T> OBB<T>::getBBox() const
+    {
+        const Vec2<T> y = getAxisY();
+        const Vec2<T> extent(std::abs(axis.x) * halfsize.x + std::abs(y.x) * halfsize.y,
+                             std::abs(axis.y) * halfsize.x + std::abs(y.y) * halfsize.y);
+        return AABB<T>(center - extent, extent * 2);
+    }
+
+    template <class T>
+    T OBB<T>::getArea() const
+    {
+        return halfsize.x * halfsize.y * 4;
+    }
+}
+
+#endif
@@ -51,7 +51,12 @@ namespace math
     void OffsetPolygon<T>::setOffset(const Vec2<T>& offset)
     {
         this->_bbox.pos += (offset - _offset);
+        this->_bcircle.center += (offset - _offset);
+        this->_obb.center += (offset - _offset);
+        if (!this->_obbdirty)
+            this->_padOBB();
         _offset = offset;
+        this->_revision = detail::nextRevision();
         this->_onVertexChanged();
     }
 
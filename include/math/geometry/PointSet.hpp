@@ -2,10 +2,14 @@
 #define CPPMATH_POINT_SET_HPP
 
 #include "Line2.hpp"
+#include "AABB.hpp"
 #include <vector>
 
 namespace math
 {
+    template <class T>
+    class Circle;
+
     template <typename T>
     class AbstractPointSet
     {
@@ -21,6 +25,18 @@ namespace math
             virtual Point2<T> get(size_t i) const                  = 0;
             virtual AABB<T>   getBBox() const                      = 0;
 
+            // Returns a cached circle containing all points, or nullptr if
+            // there is none. Unlike the AABB, it stays valid when the points
+            // rotate around its center.
+            // Use Circle<T>::fromPoints() to compute one.
+            virtual const Circle<T>* getBoundingCircle() const { return nullptr; }
+
+            // Returns a revision that changes whenever the vertices change,
+            // or 0 if changes are not tracked. Revisions are drawn from a
+            // global counter, so different point sets never share one,
+            // unless one was copied from the other.
+            virtual size_t getRevision() const { return 0; }
+
             // Return a line segment from point i to point j.
             Line2<T> getSegment(size_t i, size_t j) const;
 
@@ -48,6 +64,7 @@ namespace math
             void clear()                              final override;
 
             virtual AABB<T> getBBox() const override;
+            virtual size_t  getRevision() const override;
 
         protected:
             // Called whenever the vertex list changed
@@ -62,6 +79,7 @@ namespace math
         protected:
             mutable AABB<T> _bbox;
             mutable bool _bboxdirty;
+            size_t _revision;
     };
 
     template <typename T>
@@ -109,8 +127,8 @@ namespace math
             return AABB<T>();
         }
 
-        Vec2f min = this->get(0).asVector(),
-              max = this->get(0).asVector();
+        Vec2<T> min = this->get(0).asVector(),
+                max = this->get(0).asVector();
 
         for (size_t i = 1; i < this->size(); ++i)
         {
@@ -131,7 +149,8 @@ namespace math
     // BasePointSet
     template <typename T>
     BasePointSet<T>::BasePointSet() :
-        _bboxdirty(true)
+        _bboxdirty(true),
+        _revision(detail::nextRevision())
         // NOTE: BBox should recalculate because it doesn't
         //       know if derived classes automatically add some vertices.
     { }
@@ -142,6 +161,7 @@ namespace math
         _add(point);
         if (!intersect(_bbox, this->get(this->size() - 1)))
             _bboxdirty = true;
+        _revision = detail::nextRevision();
         _onVertexChanged();
     }
 
@@ -150,6 +170,7 @@ namespace math
     {
         _edit(i, p);
         _bboxdirty = true;
+        _revision = detail::nextRevision();
         _onVertexChanged();
     }
 
@@ -159,6 +180,7 @@ namespace math
         _insert(i, p);
         if (!intersect(_bbox, this->get(i)))
             _bboxdirty = true;
+        _revision = detail::nextRevision();
         _onVertexChanged();
     }
 
@@ -167,6 +189,7 @@ namespace math
     {
         _remove(i);
         _bboxdirty = true;
+        _revision = detail::nextRevision();
         _onVertexChanged();
     }
 
@@ -176,6 +199,7 @@ namespace math
     {
         _clear();
         _bboxdirty = true;
+        _revision = detail::nextRevision();
         _onVertexChanged();
     }
 
@@ -190,6 +214,12 @@ namespace math
         return _bbox;
     }
 
+    template <typename T>
+    size_t BasePointSet<T>::getRevision() const
+    {
+        return _revision;
+    }
+
 
 
     // PointSet
@@ -12,6 +12,8 @@ namespace math
 }
 
 #include "PointSet.hpp"
+#include "Circle.hpp"
+#include "OBB.hpp"
 
 namespace math
 {
@@ -29,6 +31,11 @@ namespace math
             virtual void            setNormalDir(NormalDirection ndir) = 0;
             virtual NormalDirection getNormalDir() const = 0;
 
+            // Returns a cached oriented bounding box, which is used as a
+            // second, tighter reject test after the AABB, or null if the
+            // polygon doesn't provide one.
+            virtual const OBB<T>* getOBB() const { return nullptr; }
+
             // Calls a lambda for each two consecutive points.
             // Returning true breaks the loop.
             // Callback signature: bool (const Line2<T>&)
@@ -59,8 +66,10 @@ namespace math
             void remove(size_t i)                     final override;
             void clear()                              final override;
 
-            virtual AABB<T> getBBox() const override;
-            virtual bool    isConvex() const override;
+            virtual AABB<T>          getBBox() const override;
+            virtual const Circle<T>* getBoundingCircle() const override;
+            virtual size_t           getRevision() const override;
+            virtual bool             isConvex() const override;
 
             virtual void     setFillType(FillType filltype) override;
             virtual FillType getFillType() const override;
@@ -68,10 +77,21 @@ namespace math
             virtual void            setNormalDir(NormalDirection ndir) override;
             virtual NormalDirection getNormalDir() const override;
 
+            // Enables caching the minimum area OBB. It is computed lazily
+            // like the AABB, but in O(n log n), so it is disabled by
+            // default. OBBs need floating point types, so this has no
+            // effect for integer polygons.
+            void setOBBEnabled(bool enabled);
+            virtual const OBB<T>* getOBB() const override;
+
         protected:
             // Called whenever the vertex list changed
             virtual void _onVertexChanged() {};
 
+            // Sets the OBB's halfsize to the fitted halfsize plus a margin
+            // for the OBB's current position.
+            void _padOBB() const;
+
             virtual void _add(const Point2<T>& point)          = 0;
             virtual void _edit(size_t i, const Point2<T>& p)   = 0;
             virtual void _insert(size_t i, const Point2<T>& p) = 0;
@@ -82,9 +102,16 @@ namespace math
             FillType _filltype;
             NormalDirection _ndir;
             mutable AABB<T> _bbox;
+            mutable Circle<T> _bcircle;
+            mutable OBB<T> _obb;
+            mutable Vec2<T> _obbhalfsize;
             mutable bool _convex;
             mutable bool _bboxdirty;
+            mutable bool _bcircledirty;
             mutable bool _convexdirty;
+            mutable bool _obbdirty;
+            bool _obbenabled;
+            size_t _revision;
     };
 
     template <typename T, typename PolygonType = AbstractPolygon<T>>
@@ -173,7 +200,11 @@ namespace math
         _ndir(ndir),
         _convex(false),
         _bboxdirty(true),
-        _convexdirty(true)
+        _bcircledirty(true),
+        _convexdirty(true),
+        _obbdirty(true),
+        _obbenabled(false),
+        _revision(detail::nextRevision())
         // NOTE: BBox and convexity should recalculate because it doesn't
         //       know if derived classes automatically add some vertices.
     { }
@@ -184,7 +215,11 @@ namespace math
         _add(point);
         if (!intersect(_bbox, this->get(this->size() - 1)))
             _bboxdirty = true;
+        if (!intersect(_bcircle, this->get(this->size() - 1)))
+            _bcircledirty = true;
         _convexdirty = true;
+        _obbdirty = true;
+        _revision = detail::nextRevision();
         _onVertexChanged();
     }
 
@@ -193,7 +228,10 @@ namespace math
     {
         _edit(i, p);
         _bboxdirty = true;
+        _bcircledirty = true;
         _convexdirty = true;
+        _obbdirty = true;
+        _revision = detail::nextRevision();
         _onVertexChanged();
     }
 
@@ -203,7 +241,11 @@ namespace math
         _insert(i, p);
         if (!intersect(_bbox, this->get(i)))
             _bboxdirty = true;
+        if (!intersect(_bcircle, this->get(i)))
+            _bcircledirty = true;
         _convexdirty = true;
+        _obbdirty = true;
+        _revision = detail::nextRevision();
         _onVertexChanged();
     }
 
@@ -212,7 +254,10 @@ namespace math
     {
         _remove(i);
         _bboxdirty = true;
+        _bcircledirty = true;
         _convexdirty = true;
+        _obbdirty = true;
+        _revision = detail::nextRevision();
         _onVertexChanged();
     }
 
@@ -222,7 +267,10 @@ namespace math
     {
         _clear();
         _bboxdirty = true;
+        _bcircledirty = true;
         _convexdirty = true;
+        _obbdirty = true;
+        _revision = detail::nextRevision();
         _onVertexChanged();
     }
 
@@ -237,6 +285,56 @@ namespace math
         return _bbox;
     }
 
+    template <typename T>
+    void BasePolygon<T>::setOBBEnabled(bool enabled)
+    {
+        _obbenabled = enabled && std::is_floating_point<T>::value;
+    }
+
+    template <typename T>
+    const OBB<T>* BasePolygon<T>::getOBB() const
+    {
+        if (!_obbenabled)
+            return nullptr;
+
+        if (_obbdirty)
+        {
+            _obb = OBB<T>::fromPoints(*this);
+            _obbhalfsize = _obb.halfsize;
+            _padOBB();
+            _obbdirty = false;
+        }
+        return &_obb;
+    }
+
+    template <typename T>
+    void BasePolygon<T>::_padOBB() const
+    {
+        // Grow it slightly, so rounding errors never reject points
+        // on the outline. The margin depends on the position, so it is
+        // recomputed when the polygon moves.
+        const T margin = detail::boundsSlack<T>(std::abs(_obb.center.x) + std::abs(_obb.center.y)
+                                                + _obbhalfsize.x + _obbhalfsize.y);
+        _obb.halfsize = _obbhalfsize + Vec2<T>(margin, margin);
+    }
+
+    template <typename T>
+    const Circle<T>* BasePolygon<T>::getBoundingCircle() const
+    {
+        if (_bcircledirty)
+        {
+            _bcircle = Circle<T>::fromPoints(*this);
+            _bcircledirty = false;
+        }
+        return &_bcircle;
+    }
+
+    template <typename T>
+    size_t BasePolygon<T>::getRevision() const
+    {
+        return _revision;
+    }
+
     template <typename T>
     bool BasePolygon<T>::isConvex() const
     {
@@ -0,0 +1,712 @@
+#ifndef CPPMATH_GEOMETRY_VISIBILITY_GRAPH_HPP
+#define CPPMATH_GEOMETRY_VISIBILITY_GRAPH_HPP
+
+#include <vector>
+#include <cstdint>
+#include "Polygon.hpp"
+#include "LooseQuadtree.hpp"
+
+/*
+ * Visibility graph and shortest paths among polygon obstacles.
+ * Shortest paths around polygons only bend at convex obstacle vertices,
+ * so these are the graph's nodes. Two nodes are connected if the segment
+ * between them does not enter any obstacle's interior, touching obstacle
+ * borders is allowed. Segments are validated against the obstacles found
+ * by a loose quadtree over their bounding boxes.
+ * Building validates all node pairs, distributed over multiple threads.
+ * When a single obstacle changed, update() only revalidates the pairs
+ * affected by its old and new position. Unconnected pairs passing the old
+ * position are found by sorting the nodes along the axis where the fewest
+ * nodes lie within the old position's slab, and skipping pairs with both
+ * nodes on the same side of it. This takes O(N log N + N * M), where M is
+ * the number of nodes that are not on the far side of the slab as seen
+ * from a node, which is still O(N^2) in the worst case.
+ * Paths are found with A* on the cached graph. Start and goal are
+ * connected to the graph per query. The open set and per-node state are
+ * kept between queries and reset lazily using a generation counter.
+ *
+ * Obstacles are treated as solid, closed polygons of any winding and must
+ * have at least 3 vertices. They are referenced, not copied, and must
+ * outlive the graph.
+ */
+
+namespace math
+{
+    template <typename T>
+    class VisibilityGraph
+    {
+        public:
+            VisibilityGraph();
+            VisibilityGraph(const std::vector<const AbstractPolygon<T>*>& obstacles, size_t numthreads = 0);
+
+            // Rebuilds the graph using up to numthreads threads (0 = auto).
+            void build(const std::vector<const AbstractPolygon<T>*>& obstacles, size_t numthreads = 0);
+
+            // Updates the graph after the obstacle with the given index
+            // was moved or changed.
+            void update(size_t obstacle, size_t numthreads = 0);
+
+            void clear();
+
+            // Returns true if the segment between a and b does not enter
+            // any obstacle.
+            bool isVisible(const Point2<T>& a, const Point2<T>& b) const;
+
+            // Returns true if the point is strictly inside an obstacle.
+            bool isBlocked(const Point2<T>& p) const;
+
+            // Finds the shortest path between start and goal and writes its
+            // waypoints, including start and goal, to out. If length is not
+            // null, the path length is written to it.
+            // Returns false if there is no path, e.g. if start or goal are
+            // inside an obstacle.
+            // Not thread-safe, as internal buffers are reused.
+            // Existing content of out will be removed.
+            bool findPath(const Point2<T>& start, const Point2<T>& goal,
+                          std::vector<Point2<T>>* out, T* length = nullptr);
+
+            size_t getNodeCount() const;
+            size_t getEdgeCount() const;
+
+        protected:
+            struct Node
+            {
+                Point2d p;
+                size_t obstacle;
+                bool alive;
+            };
+
+            struct Edge
+            {
+                size_t node;
+                double cost;
+            };
+
+            bool _isVisible(const Point2d& a, const Point2d& b) const;
+            bool _isBlockedBy(size_t obstacle, const Point2d& a, const Point2d& b) const;
+            bool _isInside(size_t obstacle, const Point2d& p) const;
+
+            void _addNodes(size_t obstacle, std::vector<size_t>* added);
+            void _removeNodes(size_t obstacle);
+
+            // Connects the given nodes to all nodes they can see.
+            void _connect(const std::vector<size_t>& nodes, size_t numthreads);
+            void _addEdge(size_t u, size_t v);
+            void _removeEdge(size_t u, size_t v);
+
+        protected:
+            std::vector<const AbstractPolygon<T>*> _obstacles;
+            std::vector<AABB<T>> _bboxes;
+            std::vector<int> _orientation;     // 1 = counter-clockwise in y-up
+            std::vector<std::vector<size_t>> _obstaclenodes;
+            std::vector<typename LooseQuadtree<T>::Handle> _handles;
+            std::vector<size_t> _handleobstacle;
+            LooseQuadtree<T> _tree;
+
+            std::vector<Node> _nodes;
+            std::vector<std::vector<Edge>> _edges;
+            std::vector<size_t> _freenodes;
+            size_t _nodecount, _edgecount;
+
+            // A* state, valid if the stamp matches the current generation
+            std::vector<double> _cost, _goaldist;
+            std::vector<size_t> _parent;
+            std::vector<uint32_t> _visited, _closed, _goalvisible;
+            std::vector<std::pair<double, size_t>> _open;
+            uint32_t _generation;
+    };
+}
+
+
+#include "../threading.hpp"
+#include <algorithm>
+#include <functional>
+#include <cmath>
+#include <cassert>
+
+// Implementation
+namespace math
+{
+    namespace detail
+    {
+        // Returns true if a ray from vertex w in direction d immediately
+        // enters the interior of a polygon with the given orientation.
+        inline bool visibilityEnters(const Point2d& w, const Point2d& prev, const Point2d& next,
+                                     const Vec2d& d, int orientation)
+        {
+            Vec2d eo = next - w,
+                  ep = prev - w;
+            if (orientation < 0)
+                std::swap(eo, ep);
+
+            const double c = eo.cross(ep);
+            if (c > 0)
+                return eo.cross(d) > 0 && d.cross(ep) > 0;
+            if (c < 0)
+                return !(ep.cross(d) >= 0 && d.cross(eo) >= 0);
+            return eo.dot(ep) < 0 && eo.cross(d) > 0;
+        }
+
+        // Slab test of a segment against an AABB, borders included.
+        template <typename T>
+        bool visibilitySegmentBox(const Point2d& a, const Point2d& b, const AABB<T>& box)
+        {
+            double t0 = 0, t1 = 1;
+            for (size_t k = 0; k < 2; ++k)
+            {
+                const double d = b[k] - a[k],
+                             min = box.pos[k],
+                             max = box.pos[k] + box.size[k];
+                if (d == 0)
+                {
+                    if (a[k] < min || a[k] > max)
+                        return false;
+                    continue;
+                }
+                double ta = (min - a[k]) / d,
+                       tb = (max - a[k]) / d;
+                if (ta > tb)
+                    std::swap(ta, tb);
+                t0 = std::max(t0, ta);
+                t1 = std::min(t1, tb);
+                if (t0 > t1)
+                    return false;
+            }
+            return true;
+        }
+    }
+
+
+    template <typename T>
+    VisibilityGraph<T>::VisibilityGraph() :
+        _nodecount(0),
+        _edgecount(0),
+        _generation(0)
+    { }
+
+    template <typename T>
+    VisibilityGraph<T>::VisibilityGraph(const std::vector<const AbstractPolygon<T>*>& obstacles, size_t numthreads) :
+        VisibilityGraph()
+    {
+        build(obstacles, numthreads);
+    }
+
+    template <typename T>
+    void VisibilityGraph<T>::clear()
+    {
+        _obstacles.clear();
+        _bboxes.clear();
+        _orientation.clear();
+        _obstaclenodes.clear();
+        _handles.clear();
+        _handleobstacle.clear();
+        _tree.clear();
+        _nodes.clear();
+        _edges.clear();
+        _freenodes.clear();
+        _nodecount = _edgecount = 0;
+    }
+
+    template <typename T>
+    void VisibilityGraph<T>::build(const std::vector<const AbstractPolygon<T>*>& obstacles, size_t numthreads)
+    {
+        clear();
+        _obstacles = obstacles;
+
+        const size_t n = obstacles.size();
+        _bboxes.resize(n);
+        _orientation.resize(n);
+        _obstaclenodes.resize(n);
+        _handles.resize(n);
+
+        Vec2<T> min, max;
+        for (size_t i = 0; i < n; ++i)
+        {
+            assert(obstacles[i] && "obstacle is null");
+            _bboxes[i] = obstacles[i]->getBBox();
+            const Vec2<T> bmin = _bboxes[i].pos,
+                          bmax = _bboxes[i].pos + _bboxes[i].size;
+            min = i == 0 ? bmin : mins(min, bmin);
+            max = i == 0 ? bmax : maxs(max, bmax);
+        }
+
+        _tree.reset(AABB<T>(min.asPoint(), max - min));
+        for (size_t i = 0; i < n; ++i)
+        {
+            _handles[i] = _tree.insert(_bboxes[i]);
+            _handleobstacle.resize(std::max(_handleobstacle.size(), _handles[i] + 1));
+            _handleobstacle[_handles[i]] = i;
+        }
+
+        std::vector<size_t> added;
+        for (size_t i = 0; i < n; ++i)
+            _addNodes(i, &added);
+        _connect(added, numthreads);
+    }
+
+    template <typename T>
+    void VisibilityGraph<T>::update(size_t obstacle, size_t numthreads)
+    {
+        assert(obstacle < _obstacles.size() && "invalid obstacle");
+
+        const AABB<T> oldbox = _bboxes[obstacle],
+                      newbox = _obstacles[obstacle]->getBBox();
+        _bboxes[obstacle] = newbox;
+        _tree.update(_handles[obstacle], newbox);
+
+        // Nodes of overlapping obstacles may have been covered or uncovered
+        std::vector<size_t> affected(1, obstacle);
+        auto collect = [&](typename LooseQuadtree<T>::Handle handle, const AABB<T>&) {
+            const size_t k = _handleobstacle[handle];
+            if (std::find(affected.begin(), affected.end(), k) == affected.end())
+                affected.push_back(k);
+            return false;
+        };
+        _tree.query(oldbox, collect);
+        _tree.query(newbox, collect);
+
+        for (size_t k : affected)
+            _removeNodes(k);
+
+        // Remove edges blocked at the new position
+        std::vector<std::pair<size_t, size_t>> blocked;
+        for (size_t u = 0; u < _nodes.size(); ++u)
+            for (auto& e : _edges[u])
+                if (e.node > u && detail::visibilitySegmentBox(_nodes[u].p, _nodes[e.node].p, newbox)
+                        && _isBlockedBy(obstacle, _nodes[u].p, _nodes[e.node].p))
+                    blocked.push_back(std::make_pair(u, e.node));
+        for (auto& edge : blocked)
+            _removeEdge(edge.first, edge.second);
+
+        // Revalidate unconnected pairs passing the old position. Pairs with
+        // both nodes on the same side of the box can't pass it, so sort the
+        // nodes along the axis with fewer nodes inside the box's slab and
+        // only pair them with the range on the other side.
+        const Vec2d bmin(oldbox.pos), bmax = bmin + Vec2d(oldbox.size);
+        size_t inslab[2] = { 0, 0 };
+        for (auto& node : _nodes)
+            for (int k = 0; k < 2; ++k)
+                if (node.alive && node.p[k] >= bmin[k] && node.p[k] <= bmax[k])
+                    ++inslab[k];
+        const int axis = inslab[0] <= inslab[1] ? 0 : 1;
+
+        std::vector<size_t> sorted;
+        for (size_t u = 0; u < _nodes.size(); ++u)
+            if (_nodes[u].alive)
+                sorted.push_back(u);
+        std::sort(sorted.begin(), sorted.end(), [&](size_t u, size_t v) {
+            return _nodes[u].p[axis] < _nodes[v].p[axis];
+        });
+        std::vector<double> coords(sorted.size());
+        for (size_t i = 0; i < sorted.size(); ++i)
+            coords[i] = _nodes[sorted[i]].p[axis];
+
+        const size_t threads = getThreadCount(numthreads);
+        std::vector<std::vector<std::pair<size_t, size_t>>> unblocked(threads);
+        parallelFor(0, threads, [&](size_t begin, size_t end) {
+            std::vector<uint8_t> adjacent(_nodes.size(), 0);
+            for (size_t slot = begin; slot < end; ++slot)
+            {
+                for (size_t u = slot; u < _nodes.size(); u += threads)
+                {
+                    if (!_nodes[u].alive)
+                        continue;
+                    const double x = _nodes[u].p[axis];
+                    const size_t first = x < bmin[axis]
+                            ? std::lower_bound(coords.begin(), coords.end(), bmin[axis]) - coords.begin() : 0;
+                    const size_t last = x > bmax[axis]
+                            ? std::upper_bound(coords.begin(), coords.end(), bmax[axis]) - coords.begin()
+                            : coords.size();
+
+                    for (auto& e : _edges[u])
+                        adjacent[e.node] = 1;
+                    for (size_t i = first; i < last; ++i)
+                    {
+                        const size_t v = sorted[i];
+                        if (v > u && !adjacent[v]
+                                && detail::visibilitySegmentBox(_nodes[u].p, _nodes[v].p, oldbox)
+                                && _isVisible(_nodes[u].p, _nodes[v].p))
+                            unblocked[slot].push_back(std::make_pair(u, v));
+                    }
+                    for (auto& e : _edges[u])
+                        adjacent[e.node] = 0;
+                }
+            }
+        }, threads);
+
+        for (auto& list : unblocked)
+            for (auto& edge : list)
+                _addEdge(edge.first, edge.second);
+
+        std::vector<size_t> added;
+        for (size_t k : affected)
+        {
+            _orientation[k] = 0;
+            _addNodes(k, &added);
+        }
+        _connect(added, numthreads);
+    }
+
+    template <typename T>
+    void VisibilityGraph<T>::_addNodes(size_t obstacle, std::vector<size_t>* added)
+    {
+        const AbstractPolygon<T>& pol = *_obstacles[obstacle];
+        const size_t n = pol.size();
+
+        double area = 0;
+        for (size_t i = 0; i < n; ++i)
+            area += Point2d(pol.get(i)).asVector().cross(Point2d(pol.get((i + 1) % n)).asVector());
+        _orientation[obstacle] = area < 0 ? -1 : 1;
+
+        if (n < 3)
+            return;
+
+        std::vector<typename LooseQuadtree<T>::Handle> others;
+        for (size_t i = 0; i < n; ++i)
+        {
+            const Point2d prev = pol.get((i + n - 1) % n),
+                          p = pol.get(i),
+                          next = pol.get((i + 1) % n);
+
+            // Only convex vertices
+            if ((next - p).cross(prev - p) * _orientation[obstacle] <= 0)
+                continue;
+
+            bool covered = false;
+            _tree.query(pol.get(i), &others);
+            for (auto h : others)
+            {
+                const size_t k = _handleobstacle[h];
+                if (k != obstacle && _isInside(k, p))
+                {
+                    covered = true;
+                    break;
+                }
+            }
+            if (covered)
+                continue;
+
+            size_t u;
+            if (!_freenodes.empty())
+            {
+                u = _freenodes.back();
+                _freenodes.pop_back();
+            }
+            else
+            {
+                u = _nodes.size();
+                _nodes.push_back(Node());
+                _edges.emplace_back();
+            }
+
+            _nodes[u].p = p;
+            _nodes[u].obstacle = obstacle;
+            _nodes[u].alive = true;
+            _obstaclenodes[obstacle].push_back(u);
+            added->push_back(u);
+            ++_nodecount;
+        }
+    }
+
+    template <typename T>
+    void VisibilityGraph<T>::_removeNodes(size_t obstacle)
+    {
+        for (size_t u : _obstaclenodes[obstacle])
+        {
+            while (!_edges[u].empty())
+                _removeEdge(u, _edges[u].back().node);
+            _nodes[u].alive = false;
+            _freenodes.push_back(u);
+            --_nodecount;
+        }
+        _obstaclenodes[obstacle].clear();
+    }
+
+    template <typename T>
+    void VisibilityGraph<T>::_connect(const std::vector<size_t>& nodes, size_t numthreads)
+    {
+        // Position + 1 in nodes, to check pairs of new nodes only once
+        std::vector<size_t> order(_nodes.size(), 0);
+        for (size_t i = 0; i < nodes.size(); ++i)
+            order[nodes[i]] = i + 1;
+
+        // Interleave the nodes between threads, as earlier nodes are
+        // paired with more new nodes than later ones.
+        const size_t threads = std::max<size_t>(1, std::min(getThreadCount(numthreads), nodes.size()));
+        std::vector<std::vector<std::pair<size_t, size_t>>> found(threads);
+        parallelFor(0, threads, [&](size_t begin, size_t end) {
+            for (size_t slot = begin; slot < end; ++slot)
+            {
+                for (size_t i = slot; i < nodes.size(); i += threads)
+                {
+                    const size_t u = nodes[i];
+                    for (size_t v = 0; v < _nodes.size(); ++v)
+                        if (_nodes[v].alive && v != u && (order[v] == 0 || order[v] > i + 1)
+                                && _isVisible(_nodes[u].p, _nodes[v].p))
+                            found[slot].push_back(std::make_pair(u, v));
+                }
+            }
+        }, threads);
+
+        for (auto& list : found)
+            for (auto& edge : list)
+                _addEdge(edge.first, edge.second);
+    }
+
+    template <typename T>
+    void VisibilityGraph<T>::_addEdge(size_t u, size_t v)
+    {
+        const double cost = (_nodes[u].p - _nodes[v].p).abs();
+        _edges[u].push_back(Edge{ v, cost });
+        _edges[v].push_back(Edge{ u, cost });
+        ++_edgecount;
+    }
+
+    template <typename T>
+    void VisibilityGraph<T>::_removeEdge(size_t u, size_t v)
+    {
+        auto erase = [](std::vector<Edge>& edges, size_t node) {
+            for (size_t i = 0; i < edges.size(); ++i)
+            {
+                if (edges[i].node == node)
+                {
+                    edges[i] = edges.back();
+                    edges.pop_back();
+                    return;
+                }
+            }
+        };
+        erase(_edges[u], v);
+        erase(_edges[v], u);
+        --_edgecount;
+    }
+
+    template <typename T>
+    bool VisibilityGraph<T>::isVisible(const Point2<T>& a, const Point2<T>& b) const
+    {
+        return _isVisible(a, b);
+    }
+
+    template <typename T>
+    bool VisibilityGraph<T>::isBlocked(const Point2<T>& p) const
+    {
+        bool blocked = false;
+        _tree.query(AABB<T>(p, Vec2<T>()), [&](typename LooseQuadtree<T>::Handle handle, const AABB<T>&) {
+            blocked = _isInside(_handleobstacle[handle], p);
+            return blocked;
+        });
+        return blocked;
+    }
+
+    template <typename T>
+    bool VisibilityGraph<T>::_isVisible(const Point2d& a, const Point2d& b) const
+    {
+        const Vec2d min = mins(a.asVector(), b.asVector()),
+                    max = maxs(a.asVector(), b.asVector());
+        const AABB<T> range(Point2<T>(min.asPoint()), Vec2<T>(max - min));
+
+        bool blocked = false;
+        _tree.query(range, [&](typename LooseQuadtree<T>::Handle handle, const AABB<T>& bbox) {
+            blocked = detail::visibilitySegmentBox(a, b, bbox) && _isBlockedBy(_handleobstacle[handle], a, b);
+            return blocked;
+        });
+        return !blocked;
+    }
+
+    template <typename T>
+    bool VisibilityGraph<T>::_isBlockedBy(size_t obstacle, const Point2d& a, const Point2d& b) const
+    {
+        const AbstractPolygon<T>& pol = *_obstacles[obstacle];
+        const int orientation = _orientation[obstacle];
+        const size_t n = pol.size();
+        const Vec2d d = b - a;
+        const double len2 = d.abs_sqr();
+
+        if (n < 3)
+            return false;
+
+        Point2d prev = pol.get(n - 1),
+                w0 = pol.get(0);
+        for (size_t i = 0; i < n; ++i)
+        {
+            const Point2d w1 = pol.get((i + 1) % n);
+            const Vec2d e = w1 - w0;
+            const double o1 = d.cross(w0 - a),
+                         o2 = d.cross(w1 - a),
+                         o3 = e.cross(a - w0),
+                         o4 = e.cross(b - w0);
+
+            // Proper crossing
+            if (((o1 < 0 && o2 > 0) || (o1 > 0 && o2 < 0)) && ((o3 < 0 && o4 > 0) || (o3 > 0 && o4 < 0)))
+                return true;
+
+            // End point inside the edge, segment pointing inwards
+            const double ea = (a - w0).dot(e),
+                         eb = (b - w0).dot(e);
+            if (o3 == 0 && ea > 0 && ea < e.abs_sqr() && e.cross(d) * orientation > 0)
+                return true;
+            if (o4 == 0 && eb > 0 && eb < e.abs_sqr() && e.cross(-d) * orientation > 0)
+                return true;
+
+            // Segment touching the vertex and entering the interior there
+            if (o1 == 0)
+            {
+                const double t = (w0 - a).dot(d);
+                if (t >= 0 && t <= len2)
+                {
+                    if (t > 0 && detail::visibilityEnters(w0, prev, w1, -d, orientation))
+                        return true;
+                    if (t < len2 && detail::visibilityEnters(w0, prev, w1, d, orientation))
+                        return true;
+                }
+            }
+
+            prev = w0;
+            w0 = w1;
+        }
+
+        return _isInside(obstacle, a + d / 2.0);
+    }
+
+    template <typename T>
+    bool VisibilityGraph<T>::_isInside(size_t obstacle, const Point2d& p) const
+    {
+        const AbstractPolygon<T>& pol = *_obstacles[obstacle];
+        const size_t n = pol.size();
+        bool inside = false;
+
+        if (n < 3)
+            return false;
+
+        Point2d a = pol.get(n - 1);
+        for (size_t i = 0; i < n; ++i)
+        {
+            const Point2d b = pol.get(i);
+            const Vec2d e = b - a;
+
+            // On the border
+            if (e.cross(p - a) == 0 && (p - a).dot(e) >= 0 && (p - b).dot(e) <= 0)
+                return false;
+
+            if ((a.y > p.y) != (b.y > p.y) && p.x < a.x + (p.y - a.y) * e.x / e.y)
+                inside = !inside;
+            a = b;
+        }
+        return inside;
+    }
+
+    template <typename T>
+    bool VisibilityGraph<T>::findPath(const Point2<T>& start, const Point2<T>& goal,
+                                      std::vector<Point2<T>>* out, T* length)
+    {
+        assert(out && "out is null");
+        out->clear();
+
+        if (isBlocked(start) || isBlocked(goal))
+            return false;
+
+        const Point2d s = start,
+                      g = goal;
+
+        if (_isVisible(s, g))
+        {
+            out->push_back(start);
+            out->push_back(goal);
+            if (length)
+                *length = (g - s).abs();
+            return true;
+        }
+
+        // The goal is a virtual node after all others
+        const size_t n = _nodes.size(),
+                     goalid = n;
+        if (_cost.size() < n + 1)
+        {
+            _cost.resize(n + 1);
+            _goaldist.resize(n + 1);
+            _parent.resize(n + 1);
+            _visited.resize(n + 1, 0);
+            _closed.resize(n + 1, 0);
+            _goalvisible.resize(n + 1, 0);
+        }
+        if (++_generation == 0)
+        {
+            std::fill(_visited.begin(), _visited.end(), 0);
+            std::fill(_closed.begin(), _closed.end(), 0);
+            std::fill(_goalvisible.begin(), _goalvisible.end(), 0);
+            _generation = 1;
+        }
+
+        const uint32_t gen = _generation;
+        typedef std::pair<double, size_t> Entry;
+        _open.clear();
+
+        auto relax = [&](size_t v, double cost, size_t parent) {
+            if (_visited[v] == gen && cost >= _cost[v])
+                return;
+            _visited[v] = gen;
+            _cost[v] = cost;
+            _parent[v] = parent;
+            _open.push_back(Entry(cost + (v == goalid ? 0 : (g - _nodes[v].p).abs()), v));
+            std::push_heap(_open.begin(), _open.end(), std::greater<Entry>());
+        };
+
+        for (size_t v = 0; v < n; ++v)
+        {
+            if (!_nodes[v].alive)
+                continue;
+            if (_isVisible(_nodes[v].p, g))
+            {
+                _goalvisible[v] = gen;
+                _goaldist[v] = (g - _nodes[v].p).abs();
+            }
+            if (_isVisible(s, _nodes[v].p))
+                relax(v, (_nodes[v].p - s).abs(), goalid);
+        }
+
+        while (!_open.empty())
+        {
+            std::pop_heap(_open.begin(), _open.end(), std::greater<Entry>());
+            const size_t u = _open.back().second;
+            _open.pop_back();
+
+            if (_closed[u] == gen)
+                continue;
+            _closed[u] = gen;
+
+            if (u == goalid)
+            {
+                // Parents of nodes connected to the start are goalid
+                out->push_back(goal);
+                for (size_t v = _parent[goalid]; v != goalid; v = _parent[v])
+                    out->push_back(Point2<T>(_nodes[v].p));
+                out->push_back(start);
+                std::reverse(out->begin(), out->end());
+                if (length)
+                    *length = _cost[goalid];
+                return true;
+            }
+
+            if (_goalvisible[u] == gen)
+                relax(goalid, _cost[u] + _goaldist[u], u);
+            for (auto& e : _edges[u])
+                relax(e.node, _cost[u] + e.cost, u);
+        }
+
+        return false;
+    }
+
+    template <typename T>
+    size_t VisibilityGraph<T>::getNodeCount() const
+    {
+        return _nodecount;
+    }
+
+    template <typename T>
+    size_t VisibilityGraph<T>::getEdgeCount() const
+    {
+        return _edgecount;
+    }
+}
+
+#endif
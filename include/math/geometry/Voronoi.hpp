@@ -0,0 +1,229 @@
+#ifndef CPPMATH_GEOMETRY_VORONOI_HPP
+#define CPPMATH_GEOMETRY_VORONOI_HPP
+
+#include <vector>
+#include "Delaunay.hpp"
+#include "KDTree.hpp"
+
+/*
+ * Voronoi diagram of a set of sites, clipped to a bounding box.
+ * The diagram is built as the dual of the Delaunay triangulation: the
+ * cell of a site is the bounding box clipped by the perpendicular
+ * bisectors to each of its Delaunay neighbours. Since only neighbours
+ * are considered, building all cells is O(n log n) in total, and cells
+ * are built independently of each other, so the work is spread across
+ * threads.
+ * Cells are convex and wound counter-clockwise in a y-up system (clockwise
+ * in a y-down system). Cells of sites outside the bounding box may be
+ * empty. Coincident sites share the same cell.
+ * Nearest-site queries are answered by a k-d tree over the sites.
+ */
+
+namespace math
+{
+    template <typename T>
+    class Voronoi
+    {
+        public:
+            Voronoi();
+            Voronoi(const AbstractPointSet<T>& sites, const AABB<T>& bounds, size_t numthreads = 0);
+
+            // Rebuilds the diagram using up to numthreads threads (0 = auto).
+            void build(const AbstractPointSet<T>& sites, const AABB<T>& bounds, size_t numthreads = 0);
+            void clear();
+
+            // Returns the cell of site i.
+            const PointSet<T>& getCell(size_t i) const;
+
+            // Returns the index of the site whose cell contains p, i.e. the
+            // closest site, or (size_t)-1 if there are no sites.
+            // Of coincident sites, the lowest index is returned.
+            // If sqrdist is not null, the squared distance is written to it.
+            size_t findNearest(const Point2<T>& p, T* sqrdist = nullptr) const;
+
+            const Delaunay<T>& getDelaunay() const;
+            const AABB<T>&     getBounds() const;
+
+            size_t size() const;
+
+        protected:
+            void _buildCell(size_t i, const std::vector<size_t>& neighbors, PointSet<T>* out) const;
+
+        protected:
+            Delaunay<T> _delaunay;
+            KDTree<T> _tree;
+            std::vector<PointSet<T>> _cells;
+            std::vector<size_t> _owner;     // Lowest index of coincident sites
+            AABB<T> _bounds;
+    };
+}
+
+
+#include "../threading.hpp"
+#include <algorithm>
+#include <numeric>
+#include <cassert>
+
+// Implementation
+namespace math
+{
+    template <typename T>
+    Voronoi<T>::Voronoi()
+    { }
+
+    template <typename T>
+    Voronoi<T>::Voronoi(const AbstractPointSet<T>& sites, const AABB<T>& bounds, size_t numthreads)
+    {
+        build(sites, bounds, numthreads);
+    }
+
+    template <typename T>
+    void Voronoi<T>::build(const AbstractPointSet<T>& sites, const AABB<T>& bounds, size_t numthreads)
+    {
+        const size_t n = sites.size();
+        _bounds = bounds;
+        _delaunay.triangulate(sites);
+        _tree.build(sites, numthreads);
+        _cells.assign(n, PointSet<T>());
+        _owner.resize(n);
+
+        if (n == 0)
+            return;
+
+        const std::vector<Point2<T>>& points = _delaunay.getPoints();
+        const std::vector<size_t>& triangles = _delaunay.getTriangles();
+        const std::vector<size_t>& halfedges = _delaunay.getHalfedges();
+
+        // Find coincident sites the same way the triangulation does, so
+        // that the lowest index of each group is the one in the mesh.
+        std::vector<size_t> ids(n);
+        std::vector<size_t>& owner = _owner;
+        std::iota(ids.begin(), ids.end(), 0);
+        std::sort(ids.begin(), ids.end(), [&points](size_t a, size_t b) {
+            const Point2d p = points[a], q = points[b];
+            return p.x != q.x ? p.x < q.x : p.y != q.y ? p.y < q.y : a < b;
+        });
+        for (size_t k = 0; k < n; ++k)
+            owner[ids[k]] = k > 0 && Point2d(points[ids[k]]) == Point2d(points[ids[k - 1]]) ? owner[ids[k - 1]] : ids[k];
+        ids.erase(std::remove_if(ids.begin(), ids.end(), [&owner](size_t i) { return owner[i] != i; }), ids.end());
+
+        std::vector<std::vector<size_t>> neighbors(n);
+        if (triangles.empty())
+        {
+            // All sites are collinear, ids is sorted along the line
+            for (size_t k = 1; k < ids.size(); ++k)
+            {
+                neighbors[ids[k - 1]].push_back(ids[k]);
+                neighbors[ids[k]].push_back(ids[k - 1]);
+            }
+        }
+        else
+        {
+            // Every interior edge is visited once per direction, hull
+            // edges only once.
+            for (size_t e = 0; e < triangles.size(); ++e)
+            {
+                const size_t a = triangles[e],
+                             b = triangles[detail::delaunayNext(e)];
+                neighbors[a].push_back(b);
+                if (halfedges[e] == Delaunay<T>::npos)
+                    neighbors[b].push_back(a);
+            }
+        }
+
+        parallelFor(0, ids.size(), [&](size_t begin, size_t end) {
+            for (size_t k = begin; k < end; ++k)
+                _buildCell(ids[k], neighbors[ids[k]], &_cells[ids[k]]);
+        }, numthreads, 64);
+
+        for (size_t i = 0; i < n; ++i)
+            if (owner[i] != i)
+                _cells[i] = _cells[owner[i]];
+    }
+
+    template <typename T>
+    void Voronoi<T>::_buildCell(size_t i, const std::vector<size_t>& neighbors, PointSet<T>* out) const
+    {
+        const std::vector<Point2<T>>& points = _delaunay.getPoints();
+        const Point2d site = points[i];
+
+        std::vector<Point2d> cell, clipped;
+        cell.reserve(8);
+        clipped.reserve(8);
+        cell.push_back(Point2d(_bounds.x, _bounds.y));
+        cell.push_back(Point2d(_bounds.x + _bounds.w, _bounds.y));
+        cell.push_back(Point2d(_bounds.x + _bounds.w, _bounds.y + _bounds.h));
+        cell.push_back(Point2d(_bounds.x, _bounds.y + _bounds.h));
+
+        // Sutherland-Hodgman against the half plane closer to the site
+        for (size_t j : neighbors)
+        {
+            const Vec2d dir = Point2d(points[j]) - site;
+            const Point2d mid = site + dir / 2.0;
+
+            clipped.clear();
+            for (size_t k = 0; k < cell.size(); ++k)
+            {
+                const Point2d& a = cell[k];
+                const Point2d& b = cell[(k + 1) % cell.size()];
+                const double da = dir.dot(a - mid),
+                             db = dir.dot(b - mid);
+
+                if (da <= 0)
+                    clipped.push_back(a);
+                if ((da < 0 && db > 0) || (da > 0 && db < 0))
+                    clipped.push_back(a + (b - a) * (da / (da - db)));
+            }
+            cell.swap(clipped);
+
+            if (cell.empty())
+                break;
+        }
+
+        out->clear();
+        for (auto& p : cell)
+            out->add(p);
+    }
+
+    template <typename T>
+    void Voronoi<T>::clear()
+    {
+        _delaunay.triangulate(PointSet<T>());
+        _tree.clear();
+        _cells.clear();
+        _owner.clear();
+    }
+
+    template <typename T>
+    const PointSet<T>& Voronoi<T>::getCell(size_t i) const
+    {
+        return _cells[i];
+    }
+
+    template <typename T>
+    size_t Voronoi<T>::findNearest(const Point2<T>& p, T* sqrdist) const
+    {
+        const size_t i = _tree.findNearest(p, sqrdist);
+        return i == (size_t)-1 ? i : _owner[i];
+    }
+
+    template <typename T>
+    const Delaunay<T>& Voronoi<T>::getDelaunay() const
+    {
+        return _delaunay;
+    }
+
+    template <typename T>
+    const AABB<T>& Voronoi<T>::getBounds() const
+    {
+        return _bounds;
+    }
+
+    template <typename T>
+    size_t Voronoi<T>::size() const
+    {
+        return _cells.size();
+    }
+}
+
+#endif
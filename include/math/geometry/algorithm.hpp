@@ -6,17 +6,67 @@ namespace math
     template <typename>
     class AbstractPointSet;
 
+    template <typename>
+    class Point2;
+
     // Convert triangle strip formatted point sets to polygons and back.
     // The functions don't check if the input set is actually correctly formatted.
     // Input and output parameters must _not_ be the same.
     template <typename T> void polygonToTriangleStrip(const AbstractPointSet<T>& pol, AbstractPointSet<T>* out);
     template <typename T> void triangleStripToPolygon(const AbstractPointSet<T>& points, AbstractPointSet<T>* out);
+
+    // Finds the shortest path from start to goal through a corridor of
+    // triangles given as triangle strip, using the simple stupid funnel
+    // algorithm. start must be inside the first triangle and goal inside
+    // the last one. The path includes start and goal, and all points in
+    // between are corridor vertices.
+    // Portals are read from the strip directly, so no memory is allocated
+    // if out has enough capacity.
+    // Existing content of out will be removed.
+    template <typename T> void funnelPath(const AbstractPointSet<T>& strip, const Point2<T>& start,
+                                          const Point2<T>& goal, AbstractPointSet<T>* out);
 }
 
 
 #include "PointSet.hpp"
+#include <utility>
 #include <cassert>
 
+namespace math
+{
+    namespace detail
+    {
+        // Returns the right and left point of portal i, i.e. the edge
+        // shared by the strip's triangles i and i + 1, or start/goal for
+        // the first and last portal.
+        // Right and left are seen from inside the corridor looking towards
+        // the goal in a y-up system, i.e. left is counter-clockwise of right.
+        template <typename T>
+        void funnelPortal(const AbstractPointSet<T>& strip, const Point2<T>& start, const Point2<T>& goal,
+                          size_t i, Point2<T>* right, Point2<T>* left)
+        {
+            if (i == 0)
+                *right = *left = start;
+            else if (i == strip.size() - 2)
+                *right = *left = goal;
+            else
+            {
+                const Point2d behind = strip.get(i - 1);
+                *right = strip.get(i);
+                *left = strip.get(i + 1);
+                if ((Point2d(*right) - behind).cross(Point2d(*left) - behind) < 0)
+                    std::swap(*right, *left);
+            }
+        }
+
+        template <typename T>
+        double funnelCross(const Point2<T>& apex, const Point2<T>& a, const Point2<T>& b)
+        {
+            return (Point2d(a) - Point2d(apex)).cross(Point2d(b) - Point2d(apex));
+        }
+    }
+}
+
 namespace math
 {
     template <typename T>
@@ -64,6 +114,74 @@ namespace math
         for (size_t i = end; i != 0; i -= 2)
             out->add(points.get(i));
     }
+
+    template <typename T>
+    void funnelPath(const AbstractPointSet<T>& strip, const Point2<T>& start,
+                    const Point2<T>& goal, AbstractPointSet<T>* out)
+    {
+        assert(out && "out is null");
+        out->clear();
+        out->add(start);
+
+        // n - 2 triangles have n - 3 inner portals, plus start and goal
+        const size_t numportals = strip.size() >= 3 ? strip.size() - 1 : 0;
+
+        Point2<T> apex = start,
+                  right = start,
+                  left = start;
+        size_t apexid = 0,
+               rightid = 0,
+               leftid = 0;
+
+        for (size_t i = 1; i < numportals; ++i)
+        {
+            Point2<T> r, l;
+            detail::funnelPortal(strip, start, goal, i, &r, &l);
+
+            // Tighten the right side
+            if (detail::funnelCross(apex, right, r) >= 0)
+            {
+                if (apex == right || detail::funnelCross(apex, r, left) > 0)
+                {
+                    right = r;
+                    rightid = i;
+                }
+                else
+                {
+                    // Right crossed over left, left is a corner
+                    apex = right = left;
+                    apexid = rightid = leftid;
+                    if (out->get(out->size() - 1) != apex)
+                        out->add(apex);
+                    i = apexid;
+                    continue;
+                }
+            }
+
+            // Tighten the left side
+            if (detail::funnelCross(apex, l, left) >= 0)
+            {
+                if (apex == left || detail::funnelCross(apex, right, l) > 0)
+                {
+                    left = l;
+                    leftid = i;
+                }
+                else
+                {
+                    // Left crossed over right, right is a corner
+                    apex = left = right;
+                    apexid = leftid = rightid;
+                    if (out->get(out->size() - 1) != apex)
+                        out->add(apex);
+                    i = apexid;
+                    continue;
+                }
+            }
+        }
+
+        if (out->get(out->size() - 1) != goal || out->size() == 1)
+            out->add(goal);
+    }
 }
 
 #endif
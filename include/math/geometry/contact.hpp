@@ -0,0 +1,408 @@
+#ifndef CPPMATH_GEOMETRY_CONTACT_HPP
+#define CPPMATH_GEOMETRY_CONTACT_HPP
+
+#include "Manifold.hpp"
+#include "AABB.hpp"
+
+/*
+ * Contact manifolds of convex polygons and AABBs.
+ * The axis of least penetration is found with the separating axis
+ * theorem, testing the edge normals of both shapes. The edge with that
+ * normal is the reference edge. The incident edge is the edge of the other
+ * shape whose normal is most anti-parallel to it. The incident edge is
+ * clipped against the side planes of the reference edge, and all clipped
+ * points behind the reference edge become contacts, so a manifold has at
+ * most two points.
+ * Shape a is preferred as reference shape unless b's separation is
+ * significantly larger, which avoids flipping between both when their
+ * separations are about equal, e.g. for stacked boxes.
+ * Feature ids encode the reference edge, the incident vertex or the
+ * clipped incident edge, and whether b was used as reference shape. They
+ * only depend on the polygons' vertex indices, so they can be used to
+ * match contacts across frames for warm starting.
+ * Shapes are copied to inline storage, so boxes and polygons with up to 8
+ * vertices are collided without allocating.
+ */
+
+namespace math
+{
+    template <typename>
+    class AbstractPointSet;
+
+    // Computes the contact manifold of two filled convex polygons of any
+    // winding, or of a polygon and an AABB.
+    // Returns an empty manifold if the shapes are separated. Touching
+    // shapes produce contacts with a depth of 0.
+    template <typename T> Manifold<T> collide(const AbstractPointSet<T>& a, const AbstractPointSet<T>& b);
+    template <typename T> Manifold<T> collide(const AbstractPointSet<T>& a, const AABB<T>& b);
+    template <typename T> Manifold<T> collide(const AABB<T>& a, const AbstractPointSet<T>& b);
+    template <typename T> Manifold<T> collide(const AABB<T>& a, const AABB<T>& b);
+}
+
+
+#include "PointSet.hpp"
+#include <vector>
+#include <algorithm>
+#include <limits>
+
+// Implementation
+namespace math
+{
+    namespace detail
+    {
+        // Array with inline storage for up to N elements, so boxes and
+        // small polygons don't allocate. Larger arrays are kept in a
+        // vector.
+        template <typename U, size_t N>
+        class ContactArray
+        {
+            public:
+                ContactArray() : _size(0) {}
+
+                size_t size() const  { return _size; }
+                bool   empty() const { return _size == 0; }
+
+                U*       begin()       { return _heap.empty() ? _inline : _heap.data(); }
+                const U* begin() const { return _heap.empty() ? _inline : _heap.data(); }
+                U*       end()         { return begin() + _size; }
+                const U* end() const   { return begin() + _size; }
+
+                U&       operator[](size_t i)       { return begin()[i]; }
+                const U& operator[](size_t i) const { return begin()[i]; }
+                U&       front()       { return begin()[0]; }
+                const U& front() const { return begin()[0]; }
+                U&       back()        { return begin()[_size - 1]; }
+                const U& back() const  { return begin()[_size - 1]; }
+
+                void clear()
+                {
+                    _heap.clear();
+                    _size = 0;
+                }
+
+                void resize(size_t n)
+                {
+                    if (!_heap.empty())
+                        _heap.resize(n);
+                    else if (n > N)
+                    {
+                        _heap.assign(_inline, _inline + _size);
+                        _heap.resize(n);
+                    }
+                    _size = n;
+                }
+
+                void push_back(const U& value)
+                {
+                    if (!_heap.empty())
+                        _heap.push_back(value);
+                    else if (_size < N)
+                        _inline[_size] = value;
+                    else
+                    {
+                        _heap.assign(_inline, _inline + _size);
+                        _heap.push_back(value);
+                    }
+                    ++_size;
+                }
+
+                void pop_back()
+                {
+                    if (!_heap.empty())
+                        _heap.pop_back();
+                    --_size;
+                }
+
+            private:
+                // Elements are in _heap if it is not empty, otherwise
+                // in _inline.
+                U _inline[N];
+                std::vector<U> _heap;
+                size_t _size;
+        };
+
+        // Convex polygon in counter-clockwise order (y-up) with outward
+        // edge normals. Points are relative to origin.
+        struct ContactPolygon
+        {
+            ContactArray<Point2d, 8> points;
+            ContactArray<Vec2d, 8> normals;
+            Vec2d origin;
+        };
+
+        inline void contactNormals(ContactPolygon* pol)
+        {
+            const size_t n = pol->points.size();
+            pol->normals.resize(n);
+            for (size_t i = 0; i < n; ++i)
+            {
+                const Vec2d e = pol->points[(i + 1) % n] - pol->points[i];
+                pol->normals[i] = Vec2d(e.y, -e.x).normalized();
+            }
+        }
+
+        template <typename T>
+        void contactRead(const AbstractPointSet<T>& pol, ContactPolygon* out)
+        {
+            out->origin = Vec2d();
+            out->points.clear();
+            for (size_t i = 0; i < pol.size(); ++i)
+            {
+                const Point2d p = pol.get(i);
+                if (out->points.empty() || p != out->points.back())
+                    out->points.push_back(p);
+            }
+            if (out->points.size() > 1 && out->points.front() == out->points.back())
+                out->points.pop_back();
+
+            double area = 0;
+            for (size_t i = 0; i < out->points.size(); ++i)
+                area += out->points[i].asVector().cross(out->points[(i + 1) % out->points.size()].asVector());
+            if (area < 0)
+                std::reverse(out->points.begin(), out->points.end());
+            contactNormals(out);
+        }
+
+        template <typename T>
+        void contactRead(const AABB<T>& box, ContactPolygon* out)
+        {
+            out->origin = Vec2d();
+            out->points.resize(4);
+            out->points[0] = Point2d(box.x, box.y);
+            out->points[1] = Point2d(box.x + box.w, box.y);
+            out->points[2] = Point2d(box.x + box.w, box.y + box.h);
+            out->points[3] = Point2d(box.x, box.y + box.h);
+            contactNormals(out);
+        }
+
+        // Returns the largest separation of b along a's edge normals and
+        // writes the according edge and b's supporting vertex to edge and
+        // support.
+        inline double contactMaxSeparation(const ContactPolygon& a, const ContactPolygon& b,
+                                           size_t* edge, size_t* support = nullptr)
+        {
+            const Vec2d offset = b.origin - a.origin;
+            double best = -std::numeric_limits<double>::infinity();
+            for (size_t i = 0; i < a.points.size(); ++i)
+            {
+                double s = std::numeric_limits<double>::infinity();
+                size_t k = 0;
+                for (size_t j = 0; j < b.points.size(); ++j)
+                {
+                    const double d = a.normals[i].dot(b.points[j] + offset - a.points[i]);
+                    if (d < s)
+                    {
+                        s = d;
+                        k = j;
+                    }
+                }
+                if (s > best)
+                {
+                    best = s;
+                    *edge = i;
+                    if (support)
+                        *support = k;
+                }
+            }
+            return best;
+        }
+
+        // Clips the segment cp to the half plane n * p <= offset.
+        // Points created by clipping get the given id.
+        // Returns false if less than two points are left.
+        inline bool contactClipSegment(Point2d* cp, uint32_t* ids, const Vec2d& n, double offset, uint32_t clipid)
+        {
+            const double d0 = n.dot(cp[0].asVector()) - offset,
+                         d1 = n.dot(cp[1].asVector()) - offset;
+
+            if (d0 > 0 && d1 > 0)
+                return false;
+
+            if (d0 > 0 || d1 > 0)
+            {
+                const size_t k = d0 > 0 ? 0 : 1;
+                cp[k] = cp[0] + (cp[1] - cp[0]) * (d0 / (d0 - d1));
+                ids[k] = clipid;
+            }
+            return true;
+        }
+
+        // Returns the edge of pol whose normal is most anti-parallel to n,
+        // the first one if there are several.
+        // If start is not null, the edge is found by walking from the edge
+        // at start, which is updated.
+        inline size_t contactIncidentEdge(const ContactPolygon& pol, const Vec2d& n, size_t* start = nullptr)
+        {
+            const size_t m = pol.normals.size();
+            if (!start || *start >= m)
+            {
+                size_t incedge = 0;
+                double mindot = std::numeric_limits<double>::infinity();
+                for (size_t i = 0; i < m; ++i)
+                {
+                    const double d = n.dot(pol.normals[i]);
+                    if (d < mindot)
+                    {
+                        mindot = d;
+                        incedge = i;
+                    }
+                }
+                if (start)
+                    *start = incedge;
+                return incedge;
+            }
+
+            // The dot product is unimodal along the normals of a convex
+            // polygon, apart from runs of equal normals.
+            size_t k = *start;
+            double d = n.dot(pol.normals[k]);
+            for (size_t steps = 0; steps < m; ++steps)
+            {
+                const size_t next = (k + 1) % m,
+                             prev = (k + m - 1) % m;
+                const double dn = n.dot(pol.normals[next]),
+                             dp = n.dot(pol.normals[prev]);
+                if (dn < d)
+                {
+                    k = next;
+                    d = dn;
+                }
+                else if (dp < d)
+                {
+                    k = prev;
+                    d = dp;
+                }
+                else
+                    break;
+            }
+
+            // Pick the lowest index of a run of equal normals, like the
+            // full search does
+            size_t first = k;
+            for (size_t i = (k + 1) % m; i != k && n.dot(pol.normals[i]) == d; i = (i + 1) % m)
+                first = std::min(first, i);
+            for (size_t i = (k + m - 1) % m; i != k && n.dot(pol.normals[i]) == d; i = (i + m - 1) % m)
+                first = std::min(first, i);
+
+            *start = first;
+            return first;
+        }
+
+        // Clips the incident edge of inc against the given reference edge.
+        // If incident is not null, it is used as starting point to find the
+        // incident edge and updated, see contactIncidentEdge().
+        template <typename T>
+        void contactClip(const ContactPolygon& ref, size_t edge, const ContactPolygon& inc, bool flip,
+                         Manifold<T>* out, size_t* incident = nullptr)
+        {
+            const Vec2d n = ref.normals[edge];
+            const Point2d v1 = ref.points[edge],
+                          v2 = ref.points[(edge + 1) % ref.points.size()];
+
+            const size_t incedge = contactIncidentEdge(inc, n, incident);
+
+            // Work relative to the reference polygon's origin
+            const Vec2d rel = inc.origin - ref.origin;
+            const size_t m = inc.points.size();
+            Point2d cp[2] = { inc.points[incedge] + rel, inc.points[(incedge + 1) % m] + rel };
+            uint32_t ids[2] = { (uint32_t)incedge, (uint32_t)((incedge + 1) % m) };
+
+            // Side planes of the reference edge
+            const Vec2d t = (v2 - v1).normalized();
+            if (!contactClipSegment(cp, ids, -t, -t.dot(v1.asVector()), 0x8000 | (uint32_t)incedge))
+                return;
+            if (!contactClipSegment(cp, ids, t, t.dot(v2.asVector()), 0xc000 | (uint32_t)incedge))
+                return;
+
+            const uint32_t refid = (flip ? 0x80000000u : 0) | ((uint32_t)edge << 16);
+            const double offset = n.dot(v1.asVector());
+            out->normal = Vec2<T>(flip ? n : -n);
+            out->count = 0;
+            for (size_t k = 0; k < 2; ++k)
+            {
+                const double separation = n.dot(cp[k].asVector()) - offset;
+                if (separation <= 0)
+                {
+                    ContactPoint<T>& contact = out->points[out->count++];
+                    contact.p = cp[k] + ref.origin;
+                    contact.depth = -separation;
+                    contact.id = refid | ids[k];
+                }
+            }
+        }
+
+        // Builds the manifold of two overlapping polygons, given their
+        // separations (<= 0) and edges found by contactMaxSeparation().
+        // incident is passed to contactClip().
+        template <typename T>
+        Manifold<T> contactOverlap(const ContactPolygon& a, size_t edgea, double sa,
+                                   const ContactPolygon& b, size_t edgeb, double sb,
+                                   size_t* incident = nullptr)
+        {
+            // Prefer a unless b's separation is clearly larger
+            Manifold<T> manifold;
+            if (sb > 0.98 * sa)
+                contactClip(b, edgeb, a, true, &manifold, incident);
+            else
+                contactClip(a, edgea, b, false, &manifold, incident);
+            return manifold;
+        }
+
+        template <typename T>
+        Manifold<T> contactManifold(const ContactPolygon& a, const ContactPolygon& b)
+        {
+            if (a.points.size() < 3 || b.points.size() < 3)
+                return Manifold<T>();
+
+            size_t edgea, edgeb;
+            const double sa = contactMaxSeparation(a, b, &edgea);
+            if (sa > 0)
+                return Manifold<T>();
+
+            const double sb = contactMaxSeparation(b, a, &edgeb);
+            if (sb > 0)
+                return Manifold<T>();
+
+            return contactOverlap<T>(a, edgea, sa, b, edgeb, sb);
+        }
+    }
+
+
+    template <typename T>
+    Manifold<T> collide(const AbstractPointSet<T>& a, const AbstractPointSet<T>& b)
+    {
+        detail::ContactPolygon pa, pb;
+        detail::contactRead(a, &pa);
+        detail::contactRead(b, &pb);
+        return detail::contactManifold<T>(pa, pb);
+    }
+
+    template <typename T>
+    Manifold<T> collide(const AbstractPointSet<T>& a, const AABB<T>& b)
+    {
+        detail::ContactPolygon pa, pb;
+        detail::contactRead(a, &pa);
+        detail::contactRead(b, &pb);
+        return detail::contactManifold<T>(pa, pb);
+    }
+
+    template <typename T>
+    Manifold<T> collide(const AABB<T>& a, const AbstractPointSet<T>& b)
+    {
+        detail::ContactPolygon pa, pb;
+        detail::contactRead(a, &pa);
+        detail::contactRead(b, &pb);
+        return detail::contactManifold<T>(pa, pb);
+    }
+
+    template <typename T>
+    Manifold<T> collide(const AABB<T>& a, const AABB<T>& b)
+    {
+        detail::ContactPolygon pa, pb;
+        detail::contactRead(a, &pa);
+        detail::contactRead(b, &pb);
+        return detail::contactManifold<T>(pa, pb);
+    }
+}
+
+#endif
@@ -0,0 +1,374 @@
+#ifndef CPPMATH_GEOMETRY_CONTOUR_HPP
+#define CPPMATH_GEOMETRY_CONTOUR_HPP
+
+#include <vector>
+#include "PointSet.hpp"
+#include "Grid.hpp"
+
+namespace math
+{
+    // An outline extracted from a grid.
+    // Outer outlines and holes have opposite winding, solid area is always
+    // on the left side (see Vec2::left()) of each segment.
+    // For holes, parent is the index of the enclosing outer outline.
+    // For outer outlines, parent is the outline's own index.
+    template <typename T>
+    struct Contour
+    {
+        PointSet<T> outline;
+        bool hole;
+        size_t parent;
+    };
+
+    // Traces the outlines of all solid (non-zero) cells of an occupancy grid.
+    // Cell (x, y) covers the area origin + [x, x + 1] * cellsize.
+    // Collinear vertices are merged, so a solid rectangle of any size results
+    // in a single outline with 4 vertices. Cells touching only at a corner
+    // are not connected. Out-of-bounds cells are treated as empty.
+    // The grid is classified in parallel row bands using numthreads threads
+    // (0 = auto), tracing itself is linear in the number of boundary edges.
+    // Existing content of out will be removed.
+    template <typename T, typename U>
+    void extractContours(const Grid<U>& grid, std::vector<Contour<T>>* out,
+                         const Vec2<T>& cellsize = Vec2<T>(1),
+                         const Point2<T>& origin = Point2<T>(),
+                         size_t numthreads = 0);
+
+    // Extracts the iso lines of a scalar field using marching squares.
+    // Sample (x, y) is located at origin + (x, y) * cellsize.
+    // Values >= iso are considered solid. Out-of-bounds samples are treated
+    // as empty, so contours touching the border are closed along the border.
+    // Ambiguous saddle cells are resolved using the average of the corners.
+    // Existing content of out will be removed.
+    template <typename T, typename U>
+    void extractIsoContours(const Grid<U>& field, U iso, std::vector<Contour<T>>* out,
+                            const Vec2<T>& cellsize = Vec2<T>(1),
+                            const Point2<T>& origin = Point2<T>(),
+                            size_t numthreads = 0);
+}
+
+
+#include "../threading.hpp"
+#include <cassert>
+#include <cstdint>
+
+// Implementation
+namespace math
+{
+    namespace detail
+    {
+        typedef std::vector<Point2d> ContourLoop;
+
+        // Signed area (times 2) of a closed loop.
+        inline double loopArea(const ContourLoop& loop)
+        {
+            double area = 0;
+            for (size_t i = 0, j = loop.size() - 1; i < loop.size(); j = i++)
+                area += loop[j].asVector().cross(loop[i].asVector());
+            return area;
+        }
+
+        inline bool loopContains(const ContourLoop& loop, const Point2d& p)
+        {
+            bool inside = false;
+            for (size_t i = 0, j = loop.size() - 1; i < loop.size(); j = i++)
+            {
+                const Point2d& a = loop[i];
+                const Point2d& b = loop[j];
+                if ((a.y > p.y) != (b.y > p.y) &&
+                        p.x < (b.x - a.x) * (p.y - a.y) / (b.y - a.y) + a.x)
+                    inside = !inside;
+            }
+            return inside;
+        }
+
+        // Removes duplicate and collinear vertices.
+        inline void mergeCollinear(ContourLoop* loop)
+        {
+            auto collinear = [](const Point2d& a, const Point2d& b, const Point2d& c) {
+                Vec2d ab = b - a, bc = c - b;
+                return std::abs(ab.cross(bc)) <= 1e-9 * (ab.abs_sqr() + bc.abs_sqr());
+            };
+
+            ContourLoop out;
+            out.reserve(loop->size());
+            for (auto& p : *loop)
+            {
+                while (out.size() >= 2 && collinear(out[out.size() - 2], out.back(), p))
+                    out.pop_back();
+                out.push_back(p);
+            }
+
+            // Fix up the seam between the last and the first vertex
+            size_t begin = 0;
+            bool changed = true;
+            while (changed && out.size() - begin >= 3)
+            {
+                changed = false;
+                if (collinear(out[out.size() - 2], out.back(), out[begin]))
+                {
+                    out.pop_back();
+                    changed = true;
+                }
+                else if (collinear(out.back(), out[begin], out[begin + 1]))
+                {
+                    ++begin;
+                    changed = true;
+                }
+            }
+
+            loop->assign(out.begin() + begin, out.end());
+        }
+
+        // Classifies the loops into outlines and holes, simplifies them and
+        // writes them to out.
+        template <typename T>
+        void finalizeContours(std::vector<ContourLoop>& loops, std::vector<Contour<T>>* out,
+                              const Vec2<T>& cellsize, const Point2<T>& origin)
+        {
+            std::vector<double> areas;
+            areas.reserve(loops.size());
+
+            // Drop degenerate loops, e.g. iso lines collapsed to a point
+            size_t n = 0;
+            for (size_t i = 0; i < loops.size(); ++i)
+            {
+                double area = loopArea(loops[i]);
+                if (std::abs(area) > 1e-12)
+                {
+                    areas.push_back(area);
+                    loops[n++].swap(loops[i]);
+                }
+            }
+            loops.resize(n);
+
+            out->resize(loops.size());
+            for (size_t i = 0; i < loops.size(); ++i)
+            {
+                Contour<T>& c = (*out)[i];
+                c.hole = areas[i] > 0;
+                c.parent = i;
+
+                if (c.hole)
+                {
+                    // The midpoint of the first edge can't lie on another
+                    // loop, because no two loops share an edge.
+                    Point2d p = loops[i][0] + (loops[i][1] - loops[i][0]) / 2.0;
+                    double best = 0;
+                    for (size_t k = 0; k < loops.size(); ++k)
+                    {
+                        if (areas[k] >= 0 || (best != 0 && -areas[k] >= best))
+                            continue;
+                        if (loopContains(loops[k], p))
+                        {
+                            best = -areas[k];
+                            c.parent = k;
+                        }
+                    }
+                }
+            }
+
+            for (size_t i = 0; i < loops.size(); ++i)
+            {
+                mergeCollinear(&loops[i]);
+                PointSet<T>& outline = (*out)[i].outline;
+                outline.clear();
+                for (auto& p : loops[i])
+                    outline.add(origin + (p.asVector() * cellsize));
+            }
+        }
+    }
+
+
+    template <typename T, typename U>
+    void extractContours(const Grid<U>& grid, std::vector<Contour<T>>* out,
+                         const Vec2<T>& cellsize, const Point2<T>& origin,
+                         size_t numthreads)
+    {
+        assert(out && "out is null");
+        out->clear();
+
+        // Direction i has its left neighbour at (i + 3) % 4 and its right
+        // neighbour at (i + 1) % 4.
+        static const int dirs[4][2] = { { 1, 0 }, { 0, 1 }, { -1, 0 }, { 0, -1 } };
+
+        const int cw = grid.getWidth() + 1,
+                  ch = grid.getHeight() + 1;
+
+        // Marching squares over the cell corners. Each corner stores a bit
+        // mask of outgoing boundary edges, oriented so that solid cells are
+        // on the left.
+        std::vector<uint8_t> masks(cw * ch);
+        parallelFor(0, ch, [&](size_t begin, size_t end) {
+            for (int y = begin; y < (int)end; ++y)
+                for (int x = 0; x < cw; ++x)
+                {
+                    bool a = grid.get(x - 1, y - 1) != U(),
+                         b = grid.get(x,     y - 1) != U(),
+                         c = grid.get(x - 1, y)     != U(),
+                         d = grid.get(x,     y)     != U();
+                    masks[y * cw + x] = (b && !d)
+                                      | (d && !c) << 1
+                                      | (c && !a) << 2
+                                      | (a && !b) << 3;
+                }
+        }, numthreads, 32);
+
+        std::vector<uint8_t> remaining(masks);
+        std::vector<detail::ContourLoop> loops;
+
+        for (int i = 0; i < cw * ch; ++i)
+        {
+            while (remaining[i])
+            {
+                int d = 0;
+                while (!(remaining[i] & (1 << d)))
+                    ++d;
+
+                detail::ContourLoop loop;
+                int x = i % cw, y = i / cw;
+                while (true)
+                {
+                    loop.push_back(Point2d(x, y));
+                    remaining[y * cw + x] &= ~(1 << d);
+                    x += dirs[d][0];
+                    y += dirs[d][1];
+
+                    // Prefer left turns to keep diagonal neighbours apart
+                    uint8_t m = masks[y * cw + x];
+                    int next = (d + 3) % 4;
+                    if (!(m & (1 << next)))
+                        next = (m & (1 << d)) ? d : (d + 1) % 4;
+
+                    if (!(remaining[y * cw + x] & (1 << next)))
+                        break;
+                    d = next;
+                }
+                loops.push_back(loop);
+            }
+        }
+
+        detail::finalizeContours(loops, out, cellsize, origin);
+    }
+
+    template <typename T, typename U>
+    void extractIsoContours(const Grid<U>& field, U iso, std::vector<Contour<T>>* out,
+                            const Vec2<T>& cellsize, const Point2<T>& origin,
+                            size_t numthreads)
+    {
+        assert(out && "out is null");
+        out->clear();
+
+        // The field is virtually padded by one empty sample on each side,
+        // hence the cell at padded position (x, y) spans the samples
+        // (x - 1, y - 1) to (x, y).
+        const int cw = field.getWidth() + 1,
+                  ch = field.getHeight() + 1;
+
+        // Corners and edges of a cell in walking order:
+        // c0 --0-- c1
+        // |        |
+        // 3        1
+        // |        |
+        // c3 --2-- c2
+        static const int corners[4][2] = { { 0, 0 }, { 1, 0 }, { 1, 1 }, { 0, 1 } };
+
+        // Cell layout: bits 0-3 corner inside flags, bit 4 center inside,
+        // bits 5-8 visited flags per entry edge.
+        std::vector<uint16_t> cells(cw * ch);
+
+        auto inside = [&](int x, int y) {
+            return field.contains(x, y) && field.at(x, y) >= iso;
+        };
+
+        parallelFor(0, ch, [&](size_t begin, size_t end) {
+            for (int y = begin; y < (int)end; ++y)
+                for (int x = 0; x < cw; ++x)
+                {
+                    uint16_t c = 0;
+                    double sum = 0;
+                    for (int k = 0; k < 4; ++k)
+                    {
+                        int sx = x - 1 + corners[k][0],
+                            sy = y - 1 + corners[k][1];
+                        if (inside(sx, sy))
+                            c |= 1 << k;
+                        if (field.contains(sx, sy))
+                            sum += field.at(sx, sy);
+                    }
+                    if ((c == 5 || c == 10) && sum / 4 >= iso)
+                        c |= 1 << 4;
+                    cells[y * cw + x] = c;
+                }
+        }, numthreads, 32);
+
+        // Returns the exit edge of a segment given its entry edge
+        auto exitEdge = [](uint16_t c, int entry) {
+            bool saddle = (c & 15) == 5 || (c & 15) == 10;
+            if (saddle && (c & (1 << 4)))
+                return (entry + 3) % 4;
+            for (int k = 1; k < 4; ++k)
+            {
+                int e = (entry + k) % 4;
+                if ((c & (1 << e)) && !(c & (1 << ((e + 1) % 4))))
+                    return e;
+            }
+            assert(false && "no exit edge");
+            return 0;
+        };
+
+        auto crossing = [&](int x, int y, int edge) {
+            int ax = x - 1 + corners[edge][0],
+                ay = y - 1 + corners[edge][1],
+                bx = x - 1 + corners[(edge + 1) % 4][0],
+                by = y - 1 + corners[(edge + 1) % 4][1];
+            double t;
+            if (!field.contains(ax, ay))
+                t = 1;
+            else if (!field.contains(bx, by))
+                t = 0;
+            else
+            {
+                double va = field.at(ax, ay),
+                       vb = field.at(bx, by);
+                t = va == vb ? 0.5 : math::clamp<double>((iso - va) / (vb - va), 0, 1);
+            }
+            return Point2d(ax + (bx - ax) * t, ay + (by - ay) * t);
+        };
+
+        static const int neighbours[4][2] = { { 0, -1 }, { 1, 0 }, { 0, 1 }, { -1, 0 } };
+        std::vector<detail::ContourLoop> loops;
+
+        for (int i = 0; i < cw * ch; ++i)
+        {
+            for (int entry = 0; entry < 4; ++entry)
+            {
+                uint16_t c = cells[i];
+                bool isentry = !(c & (1 << entry)) && (c & (1 << ((entry + 1) % 4)));
+                if (!isentry || (c & (1 << (5 + entry))))
+                    continue;
+
+                detail::ContourLoop loop;
+                int x = i % cw, y = i / cw, e = entry;
+                while (!(cells[y * cw + x] & (1 << (5 + e))))
+                {
+                    uint16_t& cell = cells[y * cw + x];
+                    cell |= 1 << (5 + e);
+                    loop.push_back(crossing(x, y, e));
+
+                    int exit = exitEdge(cell, e);
+                    x += neighbours[exit][0];
+                    y += neighbours[exit][1];
+                    e = (exit + 2) % 4;
+                }
+
+                if (loop.size() >= 3)
+                    loops.push_back(loop);
+            }
+        }
+
+        detail::finalizeContours(loops, out, cellsize, origin);
+    }
+}
+
+#endif
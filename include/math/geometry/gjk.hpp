@@ -0,0 +1,218 @@
+#ifndef CPPMATH_GEOMETRY_GJK_HPP
+#define CPPMATH_GEOMETRY_GJK_HPP
+
+#include <vector>
+#include "Point2.hpp"
+
+/*
+ * Distance between convex polygons using the Gilbert-Johnson-Keerthi
+ * algorithm.
+ * GJK searches the point of the Minkowski difference a - b closest to the
+ * origin. It keeps a simplex of up to three support points of a - b,
+ * reduces it to the feature closest to the origin and adds the support
+ * point in the direction of the origin until no more progress is made.
+ * The closest points on both polygons are interpolated from the support
+ * points with the same barycentric coordinates.
+ * If the simplex encloses the origin, the polygons overlap and the
+ * distance is 0.
+ * Supports are found by linear search, which is fast enough for the small
+ * polygons typically used for collision shapes.
+ */
+
+namespace math
+{
+    template <typename>
+    class AbstractPointSet;
+
+    // Returns the distance between two filled convex polygons of any
+    // winding, or 0 if they overlap.
+    // If pa and pb are not null, the closest points on a and b are written
+    // to them. They are undefined if the polygons overlap.
+    template <typename T>
+    T distance(const AbstractPointSet<T>& a, const AbstractPointSet<T>& b,
+               Point2<T>* pa = nullptr, Point2<T>* pb = nullptr);
+}
+
+
+#include "PointSet.hpp"
+
+// Implementation
+namespace math
+{
+    namespace detail
+    {
+        struct GJKVertex
+        {
+            Point2d a, b;   // Support points on a and b
+            Vec2d w;        // a - b
+            double u;       // Barycentric coordinate
+        };
+
+        inline size_t gjkSupport(const std::vector<Point2d>& points, const Vec2d& d)
+        {
+            size_t best = 0;
+            double max = d.dot(points[0].asVector());
+            for (size_t i = 1; i < points.size(); ++i)
+            {
+                const double v = d.dot(points[i].asVector());
+                if (v > max)
+                {
+                    max = v;
+                    best = i;
+                }
+            }
+            return best;
+        }
+
+        // Reduces a segment simplex to the feature closest to the origin.
+        inline void gjkSolve2(GJKVertex* s, size_t* count)
+        {
+            const Vec2d e = s[1].w - s[0].w;
+            const double len = e.abs_sqr();
+            const double t = len > 0 ? -s[0].w.dot(e) / len : 0;
+            if (t <= 0)
+            {
+                s[0].u = 1;
+                *count = 1;
+            }
+            else if (t >= 1)
+            {
+                s[0] = s[1];
+                s[0].u = 1;
+                *count = 1;
+            }
+            else
+            {
+                s[0].u = 1 - t;
+                s[1].u = t;
+            }
+        }
+
+        // Reduces a triangle simplex to the feature closest to the origin.
+        // Returns true if the origin is inside.
+        inline bool gjkSolve3(GJKVertex* s, size_t* count)
+        {
+            const double area = (s[1].w - s[0].w).cross(s[2].w - s[0].w);
+            bool outside = false;
+            for (size_t i = 0; i < 3; ++i)
+            {
+                const Vec2d& p = s[i].w;
+                const Vec2d& q = s[(i + 1) % 3].w;
+                if ((q - p).cross(-p) * area < 0)
+                    outside = true;
+            }
+            if (!outside && area != 0)
+                return true;
+
+            // Closest of the three edges
+            GJKVertex best[2];
+            size_t bestcount = 0;
+            double bestdist = -1;
+            for (size_t i = 0; i < 3; ++i)
+            {
+                GJKVertex edge[2] = { s[i], s[(i + 1) % 3] };
+                size_t n = 2;
+                gjkSolve2(edge, &n);
+                const Vec2d v = n == 1 ? edge[0].w : edge[0].w * edge[0].u + edge[1].w * edge[1].u;
+                const double dist = v.abs_sqr();
+                if (bestdist < 0 || dist < bestdist)
+                {
+                    bestdist = dist;
+                    best[0] = edge[0];
+                    best[1] = edge[1];
+                    bestcount = n;
+                }
+            }
+
+            s[0] = best[0];
+            s[1] = best[1];
+            *count = bestcount;
+            return false;
+        }
+
+        // Same as distance(), but works on vertex lists.
+        inline double gjkDistance(const std::vector<Point2d>& a, const std::vector<Point2d>& b,
+                                  Point2d* pa, Point2d* pb)
+        {
+            if (a.empty() || b.empty())
+                return 0;
+
+            GJKVertex s[3];
+            size_t count = 1;
+            s[0].a = a[0];
+            s[0].b = b[0];
+            s[0].w = a[0] - b[0];
+            s[0].u = 1;
+
+            Vec2d v;
+            const size_t maxiter = 20 + a.size() + b.size();
+            for (size_t iter = 0; iter < maxiter; ++iter)
+            {
+                if (count == 2)
+                    gjkSolve2(s, &count);
+                else if (count == 3 && gjkSolve3(s, &count))
+                    return 0;
+
+                v = Vec2d();
+                for (size_t i = 0; i < count; ++i)
+                    v += s[i].w * s[i].u;
+
+                const double vv = v.abs_sqr();
+                if (vv == 0)
+                    return 0;
+
+                // New support point towards the origin
+                GJKVertex next;
+                next.a = a[gjkSupport(a, -v)];
+                next.b = b[gjkSupport(b, v)];
+                next.w = next.a - next.b;
+                next.u = 0;
+
+                // No more progress
+                if (vv - v.dot(next.w) <= 1e-12 * vv)
+                    break;
+
+                bool duplicate = false;
+                for (size_t i = 0; i < count; ++i)
+                    duplicate = duplicate || s[i].w == next.w;
+                if (duplicate)
+                    break;
+
+                s[count++] = next;
+            }
+
+            Vec2d ca, cb;
+            for (size_t i = 0; i < count; ++i)
+            {
+                ca += s[i].a.asVector() * s[i].u;
+                cb += s[i].b.asVector() * s[i].u;
+            }
+            if (pa)
+                *pa = ca.asPoint();
+            if (pb)
+                *pb = cb.asPoint();
+            return v.abs();
+        }
+    }
+
+
+    template <typename T>
+    T distance(const AbstractPointSet<T>& a, const AbstractPointSet<T>& b, Point2<T>* pa, Point2<T>* pb)
+    {
+        std::vector<Point2d> va(a.size()), vb(b.size());
+        for (size_t i = 0; i < va.size(); ++i)
+            va[i] = a.get(i);
+        for (size_t i = 0; i < vb.size(); ++i)
+            vb[i] = b.get(i);
+
+        Point2d ca, cb;
+        const double dist = detail::gjkDistance(va, vb, &ca, &cb);
+        if (pa)
+            *pa = ca;
+        if (pb)
+            *pb = cb;
+        return dist;
+    }
+}
+
+#endif
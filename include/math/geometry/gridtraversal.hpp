@@ -0,0 +1,278 @@
+#ifndef CPPMATH_GEOMETRY_GRID_TRAVERSAL_HPP
+#define CPPMATH_GEOMETRY_GRID_TRAVERSAL_HPP
+
+#include <vector>
+#include "Intersection.hpp"
+#include "Grid.hpp"
+
+#ifndef CPPMATH_GRID_RAY_PACKET_SIZE
+#define CPPMATH_GRID_RAY_PACKET_SIZE 8
+#endif
+
+/*
+ * Uniform grid traversal based on
+ * Amanatides & Woo, "A Fast Voxel Traversal Algorithm for Ray Tracing".
+ * The grid is anchored at (0, 0), cell (x, y) covers the area
+ * [x, x + 1] * cellsize, [y, y + 1] * cellsize.
+ */
+
+namespace math
+{
+    // Walks a line through a uniform grid and calls a visitor for each cell
+    // it passes, in order.
+    // The intersection has the same format as intersect(Line2, AABB) with
+    // the visited cell: times holds the entry and exit time, seg the part
+    // of the line inside the cell and normal the normal of the entered face
+    // (zero for the start cell).
+    // Rays and lines are traversed from line.p in direction of line.d until
+    // the visitor stops or maxcells cells were visited.
+    // Returning true breaks the loop.
+    // Callback signature: bool (const Point2i& cell, const Intersection<T>& isec)
+    template <typename T, typename F>
+    void traverseGrid(const Line2<T>& line, const Vec2<T>& cellsize, F f, size_t maxcells = (size_t)-1);
+
+    // Returns the first solid (non-zero) cell of an occupancy grid hit by
+    // a line, or an empty intersection if there is none.
+    // Out-of-bounds cells are empty, so the line is clipped to the grid
+    // first and rays and lines end when they leave it.
+    template <typename T, typename U>
+    Intersection<T> raycast(const Grid<U>& grid, const Vec2<T>& cellsize, const Line2<T>& line,
+                            Point2i* cell = nullptr);
+
+    // Casts many line segments through an occupancy grid at once and writes
+    // the entry time of the first solid cell of each segment to times.
+    // Segments that hit nothing get a time > 1, i.e. they have line of sight.
+    // Segments are clipped to the grid and stepped in double, so for integer
+    // T only the distinction between hits (<= 1) and misses is meaningful.
+    // Segments are processed in packets of CPPMATH_GRID_RAY_PACKET_SIZE,
+    // stepping in lock-step on structure-of-arrays data, which allows the
+    // compiler to vectorize the stepping.
+    template <typename T, typename U>
+    void raycast(const Grid<U>& grid, const Vec2<T>& cellsize, const std::vector<Line2<T>>& segments,
+                 std::vector<T>* times);
+}
+
+
+#include <limits>
+#include <cassert>
+
+// Implementation
+namespace math
+{
+    template <typename T, typename F>
+    void traverseGrid(const Line2<T>& line, const Vec2<T>& cellsize, F f, size_t maxcells)
+    {
+        const double inf = std::numeric_limits<double>::infinity();
+        const double tend = line.type == Segment ? 1 : inf;
+        const Vec2d p(line.p.asVector()), d(line.d);
+
+        Point2i cell;
+        Vec2i step;
+        Vec2d tmax, tdelta;
+
+        for (int i = 0; i < 2; ++i)
+        {
+            cell[i] = std::floor(p[i] / cellsize[i]);
+            step[i] = sign(d[i]);
+            if (step[i] == 0)
+            {
+                tmax[i] = tdelta[i] = inf;
+                continue;
+            }
+            double boundary = (cell[i] + (step[i] > 0 ? 1 : 0)) * (double)cellsize[i];
+            tmax[i] = (boundary - p[i]) / d[i];
+            tdelta[i] = cellsize[i] / std::abs(d[i]);
+        }
+
+        double t = 0;
+        Vec2<T> normal;
+
+        for (size_t n = 0; n < maxcells; ++n)
+        {
+            double texit = std::min(std::min(tmax.x, tmax.y), tend);
+            if (texit == inf)
+                texit = t;  // Zero direction vector
+
+            Intersection<T> isec(Point2<T>((p + d * t).asPoint()),
+                                 Point2<T>((p + d * texit).asPoint()),
+                                 Vec2<T>(t, texit), normal);
+
+            if (f(cell, isec) || texit >= tend || d.isZero())
+                return;
+
+            int axis = tmax.x < tmax.y ? 0 : 1;
+            cell[axis] += step[axis];
+            t = tmax[axis];
+            tmax[axis] += tdelta[axis];
+            normal.fill(0);
+            normal[axis] = -step[axis];
+        }
+    }
+
+    namespace detail
+    {
+        // Clips a line to [0, size] and returns its parameter range in t0, t1
+        // and the normal of the border it enters through, if any.
+        // Returns false if the line misses the area.
+        template <typename T>
+        bool clipToGrid(const Vec2d& p, const Vec2d& d, LineType type, const Vec2d& size,
+                        double* t0, double* t1, Vec2<T>* entrynormal)
+        {
+            const double inf = std::numeric_limits<double>::infinity();
+            *t0 = type == Line ? -inf : 0;
+            *t1 = type == Segment ? 1 : inf;
+            entrynormal->fill(0);
+            for (int i = 0; i < 2; ++i)
+            {
+                if (d[i] == 0)
+                {
+                    if (p[i] < 0 || p[i] > size[i])
+                        return false;
+                    continue;
+                }
+
+                double a = -p[i] / d[i],
+                       b = (size[i] - p[i]) / d[i];
+                if (a > b)
+                    std::swap(a, b);
+                if (a > *t0)
+                {
+                    *t0 = a;
+                    entrynormal->fill(0);
+                    (*entrynormal)[i] = -sign(d[i]);
+                }
+                *t1 = std::min(*t1, b);
+            }
+            return *t0 <= *t1 && *t0 != -inf;
+        }
+    }
+
+    template <typename T, typename U>
+    Intersection<T> raycast(const Grid<U>& grid, const Vec2<T>& cellsize, const Line2<T>& line,
+                            Point2i* cell)
+    {
+        // Clip to the grid's extent
+        const double inf = std::numeric_limits<double>::infinity();
+        const double tstart = line.type == Line ? -inf : 0;
+        const Vec2d p(line.p.asVector()), d(line.d),
+                    size((double)grid.getWidth() * cellsize.x, (double)grid.getHeight() * cellsize.y);
+        double t0, t1;
+        Vec2<T> entrynormal;
+        if (!detail::clipToGrid(p, d, line.type, size, &t0, &t1, &entrynormal))
+            return Intersection<T>();
+
+        // Traverse the clipped segment and map its times back to the line
+        const double len = t1 - t0;
+        const Line2<T> clipped(Point2<T>((p + d * t0).asPoint()), Vec2<T>(d * len), Segment);
+
+        Intersection<T> hit;
+        traverseGrid(clipped, cellsize, [&](const Point2i& c, const Intersection<T>& isec) {
+            if (grid.get(c.x, c.y) == U())
+                return false;
+            hit = isec;
+            hit.near = t0 + isec.near * len;
+            hit.far = t0 + isec.far * len;
+            if (hit.normal.isZero() && t0 > tstart)
+                hit.normal = entrynormal;
+            if (cell)
+                *cell = c;
+            return true;
+        });
+        return hit;
+    }
+
+    template <typename T, typename U>
+    void raycast(const Grid<U>& grid, const Vec2<T>& cellsize, const std::vector<Line2<T>>& segments,
+                 std::vector<T>* times)
+    {
+        assert(times && "times is null");
+
+        const size_t L = CPPMATH_GRID_RAY_PACKET_SIZE;
+        const double inf = std::numeric_limits<double>::infinity();
+        const double far = 2;
+        const int w = grid.getWidth(),
+                  h = grid.getHeight();
+        const Vec2d size(w, h);
+
+        times->resize(segments.size());
+
+        for (size_t base = 0; base < segments.size(); base += L)
+        {
+            const size_t n = std::min(L, segments.size() - base);
+
+            // Packet state as structure of arrays, in grid space and in double,
+            // so integer segments step correctly
+            int cx[L], cy[L], sx[L], sy[L];
+            double tmaxx[L], tmaxy[L], tdx[L], tdy[L], t[L], tend[L];
+            bool active[L];
+
+            size_t numactive = 0;
+            for (size_t i = 0; i < L; ++i)
+            {
+                const Line2<T>& seg = segments[base + std::min(i, n - 1)];
+                const Vec2d p(seg.p.x / (double)cellsize.x, seg.p.y / (double)cellsize.y),
+                            d(seg.d.x / (double)cellsize.x, seg.d.y / (double)cellsize.y);
+
+                // Start at the point where the segment enters the grid
+                double t0, t1;
+                Vec2<T> entrynormal;
+                active[i] = i < n && detail::clipToGrid(p, d, Segment, size, &t0, &t1, &entrynormal);
+                numactive += active[i];
+                if (!active[i])
+                    t0 = t1 = far;
+
+                const Vec2d start = p + d * t0;
+                cx[i] = clamp((int)std::floor(start.x), 0, w - 1);
+                cy[i] = clamp((int)std::floor(start.y), 0, h - 1);
+                sx[i] = sign(d.x);
+                sy[i] = sign(d.y);
+                tdx[i] = d.x != 0 ? 1 / std::abs(d.x) : inf;
+                tdy[i] = d.y != 0 ? 1 / std::abs(d.y) : inf;
+                tmaxx[i] = d.x != 0 ? (cx[i] + (sx[i] > 0) - p.x) / d.x : inf;
+                tmaxy[i] = d.y != 0 ? (cy[i] + (sy[i] > 0) - p.y) / d.y : inf;
+                t[i] = t0;
+                tend[i] = t1;
+            }
+
+            while (numactive > 0)
+            {
+                // Test cells
+                for (size_t i = 0; i < L; ++i)
+                {
+                    if (!active[i])
+                        continue;
+
+                    bool inside = cx[i] >= 0 && cy[i] >= 0 && cx[i] < w && cy[i] < h;
+                    if (inside && grid.at(cx[i], cy[i]) != U())
+                    {
+                        active[i] = false;
+                        --numactive;
+                    }
+                    else if (std::min(tmaxx[i], tmaxy[i]) > tend[i])
+                    {
+                        t[i] = far;
+                        active[i] = false;
+                        --numactive;
+                    }
+                }
+
+                // Step all lanes, branch-free
+                for (size_t i = 0; i < L; ++i)
+                {
+                    bool stepx = tmaxx[i] < tmaxy[i];
+                    double next = stepx ? tmaxx[i] : tmaxy[i];
+                    t[i] = active[i] ? next : t[i];
+                    cx[i] += (active[i] && stepx) ? sx[i] : 0;
+                    cy[i] += (active[i] && !stepx) ? sy[i] : 0;
+                    tmaxx[i] += (active[i] && stepx) ? tdx[i] : 0;
+                    tmaxy[i] += (active[i] && !stepx) ? tdy[i] : 0;
+                }
+            }
+
+            for (size_t i = 0; i < n; ++i)
+                (*times)[base + i] = t[i];
+        }
+    }
+}
+
+#endif
@@ -8,6 +8,12 @@ namespace math
     template <typename T>
     class AbstractPolygon;
 
+    template <class T>
+    class OBB;
+
+    template <class T>
+    class Circle;
+
     template <typename T> bool            intersect(const Point2<T>& point, const Point2<T>& a, const Point2<T>& b, const Point2<T>& c);
 
     template <typename T> Intersection<T> intersect(const Line2<T>& line, const AbstractPolygon<T>& pol);
@@ -21,7 +27,15 @@ namespace math
     template <typename T> Intersection<T> intersect(const AABB<T>& aabb, const AABB<T>& other);
     template <typename T> bool            contains(const AABB<T>& aabb, const AABB<T>& other);
 
+    template <typename T> bool            intersect(const Circle<T>& circle, const Point2<T>& point);
+
+    template <typename T> Intersection<T> intersect(const Line2<T>& line, const OBB<T>& obb);
+    template <typename T> bool            intersect(const OBB<T>& obb, const Point2<T>& point);
+    template <typename T> Intersection<T> intersect(const OBB<T>& obb, const OBB<T>& other);
+    template <typename T> Intersection<T> intersect(const OBB<T>& obb, const AABB<T>& aabb);
+
     template <typename T> Intersection<T> sweep(const AABB<T>& aabb, const Vec2<T>& vel, AABB<T> other);
+    template <typename T> Intersection<T> sweep(const AABB<T>& aabb, const Vec2<T>& vel, const AABB<T>& other, const Vec2<T>& othervel);
     template <typename T> Intersection<T> sweep(const AABB<T>& aabb, const Vec2<T>& vel, const AbstractPolygon<T>& pol, bool avgCorners = true, bool backfaceCulling = true);
     template <typename T> Intersection<T> sweep(const AABB<T>& aabb, const Vec2<T>& vel, const Line2<T>& line, NormalDirection ndir = NormalBoth);
 
@@ -40,6 +54,8 @@ namespace math
 
 
 #include "Polygon.hpp"
+#include "OBB.hpp"
+#include <limits>
 #include <cassert>
 
 // Implementation
@@ -96,6 +112,20 @@ namespace math
         if (!intersect(line, pol.getBBox()))
             return Intersection<T>();
 
+        // Allow for rounding in the distance, as for the OBB
+        auto circle = pol.getBoundingCircle();
+        if (circle)
+        {
+            const T slack = detail::boundsSlack<T>(std::abs(circle->center.x) + std::abs(circle->center.y) + circle->radius
+                                                   + std::abs(line.p.x) + std::abs(line.p.y));
+            if (line.distance(circle->center) > circle->radius + slack)
+                return Intersection<T>();
+        }
+
+        auto obb = pol.getOBB();
+        if (obb && !intersect(line, *obb))
+            return Intersection<T>();
+
         auto isec = findNearest(line, pol);
         if (isec)
             return isec;
@@ -120,6 +150,10 @@ namespace math
         if (!intersect(pol.getBBox(), point))
             return false;
 
+        auto obb = pol.getOBB();
+        if (obb && !intersect(*obb, point))
+            return false;
+
         if (pol.getFillType() == Filled)
         {
             Line2<T> ray(point, Vec2<T>(1, 0), Ray);
@@ -153,12 +187,38 @@ namespace math
         return isec;
     }
 
+    // Both AABBs are moving. The sweep is done with the relative velocity,
+    // but like for a static AABB, seg is the movement of aabb's center
+    // from entry to exit time in world space.
+    template <typename T>
+    Intersection<T> sweep(const AABB<T>& aabb, const Vec2<T>& vel, const AABB<T>& other, const Vec2<T>& othervel)
+    {
+        auto isec = sweep(aabb, vel - othervel, other);
+        if (isec)
+        {
+            const Point2<T> center = aabb.getCenter();
+            isec.seg = Line2<T>(center + vel * isec.near, center + vel * isec.far, Segment);
+        }
+        return isec;
+    }
+
     template <typename T>
     Intersection<T> sweep(const AABB<T>& aabb, const Vec2<T>& vel, const AbstractPolygon<T>& pol, bool avgCorners, bool backfaceCulling)
     {
         if (!sweep(aabb, vel, pol.getBBox()))
             return Intersection<T>();
 
+        // Bounding circle grown by the AABB's half diagonal
+        auto circle = pol.getBoundingCircle();
+        if (circle && vel != Vec2<T>())
+        {
+            const T reach = circle->radius + aabb.size.abs() / 2;
+            const T slack = detail::boundsSlack<T>(std::abs(circle->center.x) + std::abs(circle->center.y) + reach
+                                                   + std::abs(aabb.x) + std::abs(aabb.y));
+            if (Line2<T>(aabb.getCenter(), vel, Segment).distance(circle->center) > reach + slack)
+                return Intersection<T>();
+        }
+
         Intersection<T> nearest;
         auto cb = [&](const Line2<T>& seg) {
             auto isec = sweep(aabb, vel, seg, pol.getNormalDir());
@@ -406,6 +466,115 @@ namespace math
         return intersect(aabb, other.pos.asPoint())
             && intersect(aabb, other.pos.asPoint() + other.size);
     }
+
+
+    template <typename T>
+    bool intersect(const Circle<T>& circle, const Point2<T>& point)
+    {
+        return (point - circle.center).abs_sqr() <= circle.radius * circle.radius;
+    }
+
+
+    template <typename T>
+    Intersection<T> intersect(const Line2<T>& line, const OBB<T>& obb)
+    {
+        // Slab test in the box's local space
+        const Vec2d axes[] = { obb.axis, obb.getAxisY() };
+        const Vec2d rel = Point2d(line.p) - Point2d(obb.center),
+                    d = line.d;
+        double near = -std::numeric_limits<double>::infinity(),
+               far = std::numeric_limits<double>::infinity();
+        Vec2d normal;
+        for (size_t i = 0; i < 2; ++i)
+        {
+            const double p = axes[i].dot(rel),
+                         dp = axes[i].dot(d),
+                         h = obb.halfsize[i];
+            if (dp == 0)
+            {
+                if (p < -h || p > h)
+                    return Intersection<T>();
+                continue;
+            }
+
+            double t0 = (-h - p) / dp,
+                   t1 = (h - p) / dp;
+            if (t0 > t1)
+                std::swap(t0, t1);
+            if (t0 > near)
+            {
+                near = t0;
+                normal = dp > 0 ? -axes[i] : axes[i];
+            }
+            far = std::min(far, t1);
+            if (near > far)
+                return Intersection<T>();
+        }
+
+        if (line.type != Line && far < 0)
+            return Intersection<T>();
+
+        if (line.type == Segment && near > 1)
+            return Intersection<T>();
+
+        if (line.type != Line && near < 0)
+            near = 0;
+
+        if (line.type == Segment && far > 1)
+            far = 1;
+
+        Intersection<T> isec(line.p + line.d * near, line.p + line.d * far,
+                             Vec2<T>(near, far), Vec2<T>(normal));
+        isec.type = LinexOBB;
+        return isec;
+    }
+
+    template <typename T>
+    bool intersect(const OBB<T>& obb, const Point2<T>& point)
+    {
+        const Vec2<T> rel = point - obb.center;
+        return std::abs(obb.axis.dot(rel)) <= obb.halfsize.x
+            && std::abs(obb.getAxisY().dot(rel)) <= obb.halfsize.y;
+    }
+
+    template <typename T>
+    Intersection<T> intersect(const OBB<T>& obb, const OBB<T>& other)
+    {
+        // Separating axis test with both boxes' axes. The normal is the
+        // axis of least penetration.
+        const Vec2d ax[] = { obb.axis, obb.getAxisY() },
+                    bx[] = { other.axis, other.getAxisY() };
+        const Vec2d d = Point2d(other.center) - Point2d(obb.center);
+        const Vec2d* axes[] = { &ax[0], &ax[1], &bx[0], &bx[1] };
+
+        double depth = std::numeric_limits<double>::infinity();
+        Vec2d normal;
+        for (auto axis : axes)
+        {
+            const double ra = obb.halfsize.x * std::abs(axis->dot(ax[0])) + obb.halfsize.y * std::abs(axis->dot(ax[1])),
+                         rb = other.halfsize.x * std::abs(axis->dot(bx[0])) + other.halfsize.y * std::abs(axis->dot(bx[1])),
+                         dist = axis->dot(d),
+                         overlap = ra + rb - std::abs(dist);
+            if (overlap < 0)
+                return Intersection<T>();
+
+            if (overlap < depth)
+            {
+                depth = overlap;
+                normal = dist > 0 ? -*axis : *axis;
+            }
+        }
+
+        Intersection<T> isec(Vec2<T>(-normal * depth), Vec2<T>(normal));
+        isec.type = OBBxOBB;
+        return isec;
+    }
+
+    template <typename T>
+    Intersection<T> intersect(const OBB<T>& obb, const AABB<T>& aabb)
+    {
+        return intersect(obb, OBB<T>(aabb));
+    }
 }
 
 #endif
@@ -0,0 +1,389 @@
+#ifndef CPPMATH_GEOMETRY_MINKOWSKI_HPP
+#define CPPMATH_GEOMETRY_MINKOWSKI_HPP
+
+#include <deque>
+#include <vector>
+#include <unordered_map>
+#include "Polygon.hpp"
+#include "Intersection.hpp"
+
+/*
+ * Minkowski sums of convex polygons and configuration space sweeps.
+ * The sum of two convex polygons is built in O(n + m) by merging their
+ * edges in order of their angle, starting at both polygons' lowest
+ * vertices. The difference A - B is the sum of A and B mirrored at the
+ * origin.
+ * Sweeping an AABB against a convex polygon is equivalent to casting the
+ * AABB's center against the polygon grown by the AABB's half extents,
+ * the same way sweep(AABB, vel, AABB) works for boxes. MinkowskiCache
+ * keeps the grown polygons per (polygon, AABB size) pair, so that sweeps
+ * against static obstacles are reduced to a single ray vs convex polygon
+ * test. They are stored relative to the polygon's first vertex. When the
+ * polygon's revision changes, its shape is compared with a copy relative
+ * to the first vertex as well, so translated polygons keep their entries
+ * and only rays are translated at query time.
+ */
+
+namespace math
+{
+    // Computes the Minkowski sum of two convex polygons.
+    // Collinear input vertices are kept. The result has the same winding
+    // as a.
+    // Existing content of out will be removed.
+    template <typename T>
+    void minkowskiSum(const AbstractPointSet<T>& a, const AbstractPointSet<T>& b, AbstractPointSet<T>* out);
+
+    template <typename T>
+    void minkowskiSum(const AbstractPointSet<T>& a, const AABB<T>& b, AbstractPointSet<T>* out);
+
+    // Computes the Minkowski difference a - b = a + (-b) of two convex
+    // polygons. It contains the origin if and only if a and b overlap.
+    // Existing content of out will be removed.
+    template <typename T>
+    void minkowskiDifference(const AbstractPointSet<T>& a, const AbstractPointSet<T>& b, AbstractPointSet<T>* out);
+
+    template <typename T>
+    void minkowskiDifference(const AbstractPointSet<T>& a, const AABB<T>& b, AbstractPointSet<T>* out);
+
+    // Intersects a line with a filled convex polygon of any winding.
+    // Works like intersect(Line2, AABB): the result contains entry and
+    // exit times and points, the near time is clamped to 0 for rays and
+    // segments starting inside. The normal is the outward normal of the
+    // entered edge.
+    template <typename T>
+    Intersection<T> intersectConvex(const Line2<T>& line, const AbstractPointSet<T>& pol);
+
+    // Sweeps an AABB against a filled convex polygon. Works like
+    // sweep(AABB, vel, AABB), i.e. the result describes the movement of
+    // the AABB's center.
+    template <typename T>
+    Intersection<T> sweepConvex(const AABB<T>& aabb, const Vec2<T>& vel, const AbstractPointSet<T>& pol);
+
+
+    // Caches configuration space obstacles, i.e. convex polygons grown by
+    // the half extents of moving AABBs.
+    // Changes are detected with AbstractPointSet::getRevision(). Polygons
+    // that don't track revisions must be invalidated after changing.
+    template <typename T>
+    class MinkowskiCache
+    {
+        public:
+            // Returns the polygon grown by an AABB of the given size
+            // centered at the origin, relative to the polygon's first
+            // vertex, which is written to offset if it is not null.
+            // It is computed on first access and stays valid until the
+            // polygon's shape changes or it is invalidated.
+            const PointSet<T>& get(const AbstractPointSet<T>& pol, const Vec2<T>& size,
+                                   Vec2<T>* offset = nullptr);
+
+            // Same as sweepConvex(), but uses the cached polygon.
+            Intersection<T> sweep(const AABB<T>& aabb, const Vec2<T>& vel, const AbstractPointSet<T>& pol);
+
+            // Removes all entries of the given polygon.
+            void invalidate(const AbstractPointSet<T>& pol);
+            void clear();
+
+            // Returns the amount of cached polygons.
+            size_t size() const;
+
+        protected:
+            struct Entry
+            {
+                Vec2<T> size;
+                PointSet<T> sum;
+            };
+
+            struct Record
+            {
+                size_t revision;
+                std::vector<Vec2<T>> shape;     // Relative to the first vertex
+                std::deque<Entry> entries;      // Usually only a few
+            };
+
+            // Returns the polygon's record, cleared if its shape changed.
+            Record& _getRecord(const AbstractPointSet<T>& pol);
+
+        protected:
+            std::unordered_map<const AbstractPointSet<T>*, Record> _records;
+    };
+}
+
+
+#include "intersect.hpp"
+#include <algorithm>
+#include <limits>
+#include <cassert>
+
+// Implementation
+namespace math
+{
+    namespace detail
+    {
+        // Reads a convex polygon in counter-clockwise order (y-up) starting
+        // at its lowest vertex. Returns true if it was reversed.
+        template <typename T>
+        bool readConvex(const AbstractPointSet<T>& pol, std::vector<Point2<T>>* out, bool mirror)
+        {
+            const size_t n = pol.size();
+            out->resize(n);
+            double area = 0;
+            for (size_t i = 0; i < n; ++i)
+            {
+                (*out)[i] = mirror ? (-pol.get(i).asVector()).asPoint() : pol.get(i);
+                area += Vec2d(pol.get(i).asVector()).cross(Vec2d(pol.get((i + 1) % n).asVector()));
+            }
+
+            const bool reversed = area < 0;
+            if (reversed)
+                std::reverse(out->begin(), out->end());
+
+            auto lowest = std::min_element(out->begin(), out->end(), [](const Point2<T>& a, const Point2<T>& b) {
+                return a.y != b.y ? a.y < b.y : a.x < b.x;
+            });
+            std::rotate(out->begin(), lowest, out->end());
+            return reversed;
+        }
+
+        template <typename T>
+        void minkowskiSum(const AbstractPointSet<T>& a, const AbstractPointSet<T>& b, AbstractPointSet<T>* out, bool mirror)
+        {
+            assert(out && "out is null");
+            out->clear();
+
+            if (a.size() == 0 || b.size() == 0)
+                return;
+
+            std::vector<Point2<T>> p, q, sum;
+            const bool reversed = readConvex(a, &p, false);
+            readConvex(b, &q, mirror);
+
+            const size_t n = p.size(),
+                         m = q.size();
+            p.push_back(p[0]);
+            p.push_back(p[1 % n]);
+            q.push_back(q[0]);
+            q.push_back(q[1 % m]);
+
+            sum.reserve(n + m);
+            for (size_t i = 0, j = 0; i < n || j < m;)
+            {
+                sum.push_back(p[i] + q[j].asVector());
+                const auto cross = (p[i + 1] - p[i]).cross(q[j + 1] - q[j]);
+                if (cross >= 0 && i < n)
+                    ++i;
+                if (cross <= 0 && j < m)
+                    ++j;
+            }
+
+            if (reversed)
+                std::reverse(sum.begin(), sum.end());
+            for (auto& v : sum)
+                out->add(v);
+        }
+
+        template <typename T>
+        void boxToPolygon(const AABB<T>& box, PointSet<T>* out)
+        {
+            out->add(box.pos.asPoint());
+            out->add(Point2<T>(box.x + box.w, box.y));
+            out->add(box.pos.asPoint() + box.size);
+            out->add(Point2<T>(box.x, box.y + box.h));
+        }
+    }
+
+
+    template <typename T>
+    void minkowskiSum(const AbstractPointSet<T>& a, const AbstractPointSet<T>& b, AbstractPointSet<T>* out)
+    {
+        detail::minkowskiSum(a, b, out, false);
+    }
+
+    template <typename T>
+    void minkowskiSum(const AbstractPointSet<T>& a, const AABB<T>& b, AbstractPointSet<T>* out)
+    {
+        PointSet<T> box(4);
+        detail::boxToPolygon(b, &box);
+        detail::minkowskiSum(a, box, out, false);
+    }
+
+    template <typename T>
+    void minkowskiDifference(const AbstractPointSet<T>& a, const AbstractPointSet<T>& b, AbstractPointSet<T>* out)
+    {
+        detail::minkowskiSum(a, b, out, true);
+    }
+
+    template <typename T>
+    void minkowskiDifference(const AbstractPointSet<T>& a, const AABB<T>& b, AbstractPointSet<T>* out)
+    {
+        PointSet<T> box(4);
+        detail::boxToPolygon(b, &box);
+        detail::minkowskiSum(a, box, out, true);
+    }
+
+    template <typename T>
+    Intersection<T> intersectConvex(const Line2<T>& line, const AbstractPointSet<T>& pol)
+    {
+        const size_t n = pol.size();
+        if (n < 3 || !intersect(line, pol.getBBox()))
+            return Intersection<T>();
+
+        double area = 0;
+        for (size_t i = 0; i < n; ++i)
+            area += Vec2d(pol.get(i).asVector()).cross(Vec2d(pol.get((i + 1) % n).asVector()));
+        const double s = area < 0 ? -1 : 1;
+
+        // Cyrus-Beck clipping against all edges
+        double near = -std::numeric_limits<double>::infinity(),
+               far = std::numeric_limits<double>::infinity();
+        Vec2d normal;
+        const Vec2d d = line.d;
+        for (size_t i = 0; i < n; ++i)
+        {
+            const Point2d a = pol.get(i),
+                          b = pol.get((i + 1) % n);
+            const Vec2d edge = b - a;
+            const Vec2d nrm = Vec2d(edge.y, -edge.x) * s;
+            const double num = nrm.dot(a - Point2d(line.p)),
+                         den = nrm.dot(d);
+
+            if (den == 0)
+            {
+                if (num < 0)
+                    return Intersection<T>();
+            }
+            else if (den < 0)
+            {
+                const double t = num / den;
+                if (t > near)
+                {
+                    near = t;
+                    normal = nrm;
+                }
+            }
+            else
+                far = std::min(far, num / den);
+
+            if (near > far)
+                return Intersection<T>();
+        }
+
+        if (line.type != Line && far < 0)
+            return Intersection<T>();
+
+        if (line.type == Segment && near > 1)
+            return Intersection<T>();
+
+        if (line.type != Line && near < 0)
+            near = 0;
+
+        if (line.type == Segment && far > 1)
+            far = 1;
+
+        Intersection<T> isec(line.p + line.d * near, line.p + line.d * far,
+                             Vec2<T>(near, far), Vec2<T>(normal.normalized()));
+        isec.type = LinexConvex;
+        return isec;
+    }
+
+    template <typename T>
+    Intersection<T> sweepConvex(const AABB<T>& aabb, const Vec2<T>& vel, const AbstractPointSet<T>& pol)
+    {
+        PointSet<T> sum(pol.size() + 4);
+        minkowskiSum(pol, AABB<T>((-aabb.size / 2).asPoint(), aabb.size), &sum);
+        auto isec = intersectConvex(Line2<T>(aabb.getCenter(), vel, Segment), sum);
+        if (isec)
+            isec.type = SweptAABBxConvex;
+        return isec;
+    }
+
+
+    template <typename T>
+    typename MinkowskiCache<T>::Record& MinkowskiCache<T>::_getRecord(const AbstractPointSet<T>& pol)
+    {
+        Record& record = _records[&pol];
+        const size_t revision = pol.getRevision();
+        const size_t n = pol.size();
+        const Point2<T> origin = n > 0 ? pol.get(0) : Point2<T>();
+
+        if (!record.entries.empty() && (revision == 0 || revision == record.revision))
+            return record;
+
+        // Keep the entries if the polygon was only translated, allowing
+        // for rounding of the relative positions.
+        bool same = record.shape.size() == n;
+        for (size_t i = 0; same && i < n; ++i)
+        {
+            const Point2<T> p = pol.get(i);
+            const Vec2<T> d = (p - origin) - record.shape[i];
+            const T slack = detail::boundsSlack<T>(std::abs(p.x) + std::abs(p.y)
+                                                   + std::abs(origin.x) + std::abs(origin.y));
+            same = std::abs(d.x) <= slack && std::abs(d.y) <= slack;
+        }
+
+        if (!same)
+        {
+            record.entries.clear();
+            record.shape.resize(n);
+            for (size_t i = 0; i < n; ++i)
+                record.shape[i] = pol.get(i) - origin;
+        }
+        record.revision = revision;
+        return record;
+    }
+
+    template <typename T>
+    const PointSet<T>& MinkowskiCache<T>::get(const AbstractPointSet<T>& pol, const Vec2<T>& size,
+                                              Vec2<T>* offset)
+    {
+        auto& entries = _getRecord(pol).entries;
+        const Vec2<T> origin = pol.size() > 0 ? pol.get(0).asVector() : Vec2<T>();
+        if (offset)
+            *offset = origin;
+
+        for (auto& e : entries)
+            if (e.size == size)
+                return e.sum;
+
+        // Grow by the box moved by -origin to get the sum relative to it
+        entries.push_back(Entry{ size, PointSet<T>(pol.size() + 4) });
+        minkowskiSum(pol, AABB<T>((-size / 2 - origin).asPoint(), size), &entries.back().sum);
+        return entries.back().sum;
+    }
+
+    template <typename T>
+    Intersection<T> MinkowskiCache<T>::sweep(const AABB<T>& aabb, const Vec2<T>& vel, const AbstractPointSet<T>& pol)
+    {
+        Vec2<T> offset;
+        const PointSet<T>& sum = get(pol, aabb.size, &offset);
+        auto isec = intersectConvex(Line2<T>(aabb.getCenter() - offset, vel, Segment), sum);
+        if (isec)
+        {
+            isec.type = SweptAABBxConvex;
+            isec.seg.p += offset;
+        }
+        return isec;
+    }
+
+    template <typename T>
+    void MinkowskiCache<T>::invalidate(const AbstractPointSet<T>& pol)
+    {
+        _records.erase(&pol);
+    }
+
+    template <typename T>
+    void MinkowskiCache<T>::clear()
+    {
+        _records.clear();
+    }
+
+    template <typename T>
+    size_t MinkowskiCache<T>::size() const
+    {
+        size_t num = 0;
+        for (auto& it : _records)
+            num += it.second.entries.size();
+        return num;
+    }
+}
+
+#endif
@@ -0,0 +1,280 @@
+#ifndef CPPMATH_GEOMETRY_MORTON_HPP
+#define CPPMATH_GEOMETRY_MORTON_HPP
+
+#include <vector>
+#include <cstdint>
+#include "AABB.hpp"
+
+/*
+ * Morton codes (Z-order curve) and related sorting utilities.
+ * Positions are quantized to 16 bit per axis relative to a bounding box
+ * and interleaved to a 32 bit code, x in the even bits. Sorting objects
+ * by their codes places spatially close objects close in memory.
+ */
+
+namespace math
+{
+    template <typename T>
+    class AbstractPointSet;
+
+    template <typename T>
+    class AbstractPolygon;
+
+    // Interleaves the lower 16 bits of x and y.
+    inline uint32_t mortonEncode(uint32_t x, uint32_t y);
+    inline void     mortonDecode(uint32_t code, uint32_t* x, uint32_t* y);
+
+    // Returns the Morton code of a point or an AABB's center, quantized
+    // against the given bounds. Positions outside are clamped.
+    template <typename T>
+    uint32_t mortonCode(const Point2<T>& p, const AABB<T>& bounds);
+
+    template <typename T>
+    uint32_t mortonCode(const AABB<T>& aabb, const AABB<T>& bounds);
+
+    // Computes the permutation that sorts the keys ascending, using a
+    // stable LSD radix sort on up to numthreads threads (0 = auto).
+    // Existing content of order will be removed.
+    inline void radixSort(const std::vector<uint32_t>& keys, std::vector<size_t>* order,
+                          size_t numthreads = 0);
+
+    // Computes the permutation that sorts the points or the polygons'
+    // bounding box centers in Morton order.
+    // Existing content of order will be removed.
+    template <typename T>
+    void mortonOrder(const AbstractPointSet<T>& points, std::vector<size_t>* order, size_t numthreads = 0);
+
+    template <typename T>
+    void mortonOrder(const std::vector<const AbstractPolygon<T>*>& polygons, std::vector<size_t>* order,
+                     size_t numthreads = 0);
+
+    // Rearranges elements so that the ith element is the previously
+    // order[i]th element.
+    template <typename T>
+    void reorder(AbstractPointSet<T>* points, const std::vector<size_t>& order);
+
+    template <typename V>
+    void reorder(std::vector<V>* items, const std::vector<size_t>& order);
+
+    // Sorts a point set in Morton order.
+    template <typename T>
+    void mortonSort(AbstractPointSet<T>* points, size_t numthreads = 0);
+}
+
+
+#include "Polygon.hpp"
+#include "../threading.hpp"
+#include <cassert>
+
+// Implementation
+namespace math
+{
+    namespace detail
+    {
+        // Spreads the lower 16 bits to the even bits.
+        inline uint32_t mortonSpread(uint32_t x)
+        {
+            x &= 0x0000ffff;
+            x = (x | (x << 8)) & 0x00ff00ff;
+            x = (x | (x << 4)) & 0x0f0f0f0f;
+            x = (x | (x << 2)) & 0x33333333;
+            x = (x | (x << 1)) & 0x55555555;
+            return x;
+        }
+
+        inline uint32_t mortonCompact(uint32_t x)
+        {
+            x &= 0x55555555;
+            x = (x | (x >> 1)) & 0x33333333;
+            x = (x | (x >> 2)) & 0x0f0f0f0f;
+            x = (x | (x >> 4)) & 0x00ff00ff;
+            x = (x | (x >> 8)) & 0x0000ffff;
+            return x;
+        }
+
+        template <typename T>
+        uint32_t mortonQuantize(T val, T min, T size)
+        {
+            if (size <= 0)
+                return 0;
+            double f = (val - min) / (double)size * 65535.0;
+            return f <= 0 ? 0 : f >= 65535 ? 65535 : (uint32_t)f;
+        }
+    }
+
+
+    inline uint32_t mortonEncode(uint32_t x, uint32_t y)
+    {
+        return detail::mortonSpread(x) | (detail::mortonSpread(y) << 1);
+    }
+
+    inline void mortonDecode(uint32_t code, uint32_t* x, uint32_t* y)
+    {
+        assert(x && y && "x or y is null");
+        *x = detail::mortonCompact(code);
+        *y = detail::mortonCompact(code >> 1);
+    }
+
+    template <typename T>
+    uint32_t mortonCode(const Point2<T>& p, const AABB<T>& bounds)
+    {
+        return mortonEncode(detail::mortonQuantize(p.x, bounds.x, bounds.w),
+                            detail::mortonQuantize(p.y, bounds.y, bounds.h));
+    }
+
+    template <typename T>
+    uint32_t mortonCode(const AABB<T>& aabb, const AABB<T>& bounds)
+    {
+        return mortonCode(aabb.getCenter(), bounds);
+    }
+
+    inline void radixSort(const std::vector<uint32_t>& keys, std::vector<size_t>* order,
+                          size_t numthreads)
+    {
+        assert(order && "order is null");
+
+        const size_t n = keys.size(),
+                     minchunk = 4096,
+                     chunks = std::max<size_t>(1, std::min(getThreadCount(numthreads), n / minchunk));
+        const size_t chunksize = (n + chunks - 1) / chunks;
+
+        std::vector<uint32_t> k(keys), ktmp(n);
+        std::vector<size_t> tmp(n);
+        std::vector<size_t> hist(chunks * 256);
+
+        order->resize(n);
+        for (size_t i = 0; i < n; ++i)
+            (*order)[i] = i;
+
+        for (int shift = 0; shift < 32; shift += 8)
+        {
+            // Per-chunk histograms
+            std::fill(hist.begin(), hist.end(), 0);
+            parallelFor(0, chunks, [&](size_t begin, size_t end) {
+                for (size_t c = begin; c < end; ++c)
+                {
+                    size_t* h = &hist[c * 256];
+                    for (size_t i = c * chunksize; i < std::min(n, (c + 1) * chunksize); ++i)
+                        ++h[(k[i] >> shift) & 0xff];
+                }
+            }, chunks);
+
+            // Skip the pass if all keys share the same digit
+            bool trivial = false;
+            for (size_t d = 0; d < 256 && !trivial; ++d)
+            {
+                size_t sum = 0;
+                for (size_t c = 0; c < chunks; ++c)
+                    sum += hist[c * 256 + d];
+                if (sum == n)
+                    trivial = true;
+                else if (sum > 0)
+                    break;
+            }
+            if (trivial)
+                continue;
+
+            // Exclusive prefix sum in (digit, chunk) order to keep the
+            // sort stable.
+            size_t offset = 0;
+            for (size_t d = 0; d < 256; ++d)
+            {
+                for (size_t c = 0; c < chunks; ++c)
+                {
+                    size_t count = hist[c * 256 + d];
+                    hist[c * 256 + d] = offset;
+                    offset += count;
+                }
+            }
+
+            parallelFor(0, chunks, [&](size_t begin, size_t end) {
+                for (size_t c = begin; c < end; ++c)
+                {
+                    size_t* h = &hist[c * 256];
+                    for (size_t i = c * chunksize; i < std::min(n, (c + 1) * chunksize); ++i)
+                    {
+                        size_t dst = h[(k[i] >> shift) & 0xff]++;
+                        ktmp[dst] = k[i];
+                        tmp[dst] = (*order)[i];
+                    }
+                }
+            }, chunks);
+
+            k.swap(ktmp);
+            order->swap(tmp);
+        }
+    }
+
+    template <typename T>
+    void mortonOrder(const AbstractPointSet<T>& points, std::vector<size_t>* order, size_t numthreads)
+    {
+        const AABB<T> bounds = points.getBBox();
+        std::vector<uint32_t> codes(points.size());
+        for (size_t i = 0; i < codes.size(); ++i)
+            codes[i] = mortonCode(points.get(i), bounds);
+        radixSort(codes, order, numthreads);
+    }
+
+    template <typename T>
+    void mortonOrder(const std::vector<const AbstractPolygon<T>*>& polygons, std::vector<size_t>* order,
+                     size_t numthreads)
+    {
+        assert(order && "order is null");
+        if (polygons.empty())
+        {
+            order->clear();
+            return;
+        }
+
+        Vec2<T> min = polygons[0]->getBBox().pos,
+                max = min;
+        for (auto pol : polygons)
+        {
+            const AABB<T>& bbox = pol->getBBox();
+            min = mins(min, bbox.pos);
+            max = maxs(max, bbox.pos + bbox.size);
+        }
+
+        const AABB<T> bounds(min.asPoint(), max - min);
+        std::vector<uint32_t> codes(polygons.size());
+        for (size_t i = 0; i < codes.size(); ++i)
+            codes[i] = mortonCode(polygons[i]->getBBox(), bounds);
+        radixSort(codes, order, numthreads);
+    }
+
+    template <typename T>
+    void reorder(AbstractPointSet<T>* points, const std::vector<size_t>& order)
+    {
+        assert(points && "points is null");
+        assert(order.size() == points->size() && "order has the wrong size");
+
+        std::vector<Point2<T>> old(points->size());
+        for (size_t i = 0; i < old.size(); ++i)
+            old[i] = points->get(i);
+        for (size_t i = 0; i < old.size(); ++i)
+            points->edit(i, old[order[i]]);
+    }
+
+    template <typename V>
+    void reorder(std::vector<V>* items, const std::vector<size_t>& order)
+    {
+        assert(items && "items is null");
+        assert(order.size() == items->size() && "order has the wrong size");
+
+        std::vector<V> sorted;
+        sorted.reserve(items->size());
+        for (size_t i : order)
+            sorted.push_back(std::move((*items)[i]));
+        items->swap(sorted);
+    }
+
+    template <typename T>
+    void mortonSort(AbstractPointSet<T>* points, size_t numthreads)
+    {
+        std::vector<size_t> order;
+        mortonOrder(*points, &order, numthreads);
+        reorder(points, order);
+    }
+}
+
+#endif
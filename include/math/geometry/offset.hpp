@@ -0,0 +1,555 @@
+#ifndef CPPMATH_GEOMETRY_OFFSET_HPP
+#define CPPMATH_GEOMETRY_OFFSET_HPP
+
+#include <vector>
+#include "Polygon.hpp"
+
+/*
+ * Polygon offsetting (inflating and deflating).
+ * Every edge is moved by delta along its normal and consecutive edges are
+ * connected by a join. At corners where the offset edges overlap, they are
+ * connected through the original vertex instead. The resulting raw curve
+ * may intersect itself, which is resolved afterwards: the curve is split
+ * at all self-intersections and only pieces separating a region of
+ * positive winding number from the outside are kept and linked to the
+ * final outlines. This works for concave input and also splits polygons
+ * that fall apart when shrunk.
+ * Self-intersection candidates are found with a sweep over the segments'
+ * x-extents, pieces are classified by casting axis-aligned rays against
+ * the segments bucketed into strips.
+ */
+
+namespace math
+{
+    enum JoinType
+    {
+        JoinMiter,      // Sharp corners, cut off at miterlimit * delta
+        JoinRound,      // Arcs around the original vertex
+        JoinSquare      // Corners cut off at distance delta
+    };
+
+    // Offsets a polygon by delta. Positive values inflate, negative values
+    // shrink the polygon, independent of its winding. A delta of 0 only
+    // resolves self-intersections. Open polygons are offset on both sides
+    // by abs(delta) with caps at the ends, where JoinMiter results in
+    // square caps.
+    // miterlimit is the maximum distance of a miter from the original
+    // vertex relative to delta (at least 1).
+    // arctolerance is the maximum deviation of round joins from the true
+    // arc. If it is <= 0, 1% of delta is used.
+    // The result can consist of multiple outlines. Outer outlines have the
+    // same winding as the input, holes have the opposite winding. Results of
+    // open polygons are wound counter-clockwise in a y-up system.
+    // P can be any point set type, e.g. PointSet<T> or OffsetPolygon<T>.
+    // Existing content of out will be removed.
+    template <typename T, typename P>
+    void offsetPolygon(const AbstractPolygon<T>& pol, T delta, std::vector<P>* out,
+                       JoinType join = JoinMiter, double miterlimit = 2, double arctolerance = 0);
+}
+
+
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+#include <cassert>
+
+// Implementation
+namespace math
+{
+    namespace detail
+    {
+        struct OffsetSplit
+        {
+            double t;
+            size_t id;
+
+            bool operator<(const OffsetSplit& other) const
+            {
+                return t < other.t;
+            }
+        };
+
+        inline size_t offsetFind(std::vector<size_t>& parent, size_t i)
+        {
+            while (parent[i] != i)
+                i = parent[i] = parent[parent[i]];
+            return i;
+        }
+
+        inline void offsetUnion(std::vector<size_t>& parent, size_t a, size_t b)
+        {
+            a = offsetFind(parent, a);
+            b = offsetFind(parent, b);
+            if (a != b)
+                parent[std::max(a, b)] = std::min(a, b);
+        }
+
+        inline double offsetSignedArea(const std::vector<Point2d>& path)
+        {
+            double area = 0;
+            for (size_t i = 0; i < path.size(); ++i)
+                area += path[i].asVector().cross(path[(i + 1) % path.size()].asVector());
+            return area / 2;
+        }
+
+        // Builds the raw offset curve of a closed path wound counter-
+        // clockwise in a y-up system.
+        inline void offsetRaw(const std::vector<Point2d>& path, double delta, JoinType join,
+                              double miterlimit, double arctolerance, std::vector<Point2d>* raw)
+        {
+            const size_t n = path.size();
+            const double a = std::abs(delta),
+                         sgn = delta < 0 ? -1 : 1,
+                         eps = 1e-9;
+
+            // Unit edge directions and offset directions. The right side
+            // is the outside of a counter-clockwise polygon.
+            std::vector<Vec2d> dirs(n), normals(n);
+            for (size_t i = 0; i < n; ++i)
+            {
+                dirs[i] = (path[(i + 1) % n] - path[i]).normalized();
+                normals[i] = Vec2d(dirs[i].y, -dirs[i].x) * sgn;
+            }
+
+            const double step = 2 * std::acos(1 - std::min(arctolerance, a) / a);
+
+            raw->clear();
+            for (size_t i = 0; i < n; ++i)
+            {
+                const size_t prev = (i + n - 1) % n;
+                const Point2d& p = path[i];
+                const Vec2d &d0 = dirs[prev], &d1 = dirs[i],
+                            &n0 = normals[prev], &n1 = normals[i];
+                const double cross = d0.cross(d1),
+                             dot = d0.dot(d1);
+                const bool spike = std::abs(cross) < eps && dot < 0;
+
+                if (std::abs(cross) < eps && dot > 0)
+                {
+                    raw->push_back(p + n0 * a);
+                    continue;
+                }
+
+                if (!spike && cross * delta < 0)
+                {
+                    // Offset edges overlap, connect through the vertex
+                    raw->push_back(p + n0 * a);
+                    raw->push_back(p);
+                    raw->push_back(p + n1 * a);
+                    continue;
+                }
+
+                // Cuts the corner with a line perpendicular to the bisector
+                // at the given distance from the vertex.
+                auto square = [&](double dist) {
+                    Vec2d b = n0 + n1;
+                    b = b.abs_sqr() < eps ? d0 : b.normalized();
+                    const double den0 = d0.dot(b),
+                                 den1 = -d1.dot(b);
+                    if (den0 < eps || den1 < eps)
+                    {
+                        raw->push_back(p + n0 * a);
+                        raw->push_back(p + n1 * a);
+                        return;
+                    }
+                    raw->push_back(p + n0 * a + d0 * ((dist - a * n0.dot(b)) / den0));
+                    raw->push_back(p + n1 * a - d1 * ((dist - a * n1.dot(b)) / den1));
+                };
+
+                if (join == JoinMiter)
+                {
+                    const double cosine = n0.dot(n1);
+                    if (!spike && 1 + cosine > 2 / (miterlimit * miterlimit))
+                        raw->push_back(p + (n0 + n1) * (a / (1 + cosine)));
+                    else
+                        square(spike ? a : a * miterlimit);
+                }
+                else if (join == JoinSquare)
+                    square(a);
+                else
+                {
+                    // Joins turn in the same direction as delta's sign
+                    const double angle = std::acos(std::max(-1.0, std::min(1.0, n0.dot(n1)))) * sgn;
+                    const size_t steps = std::max<size_t>(1, (size_t)std::ceil(std::abs(angle) / step));
+                    for (size_t k = 0; k <= steps; ++k)
+                    {
+                        const double phi = angle * k / steps,
+                                     c = std::cos(phi),
+                                     s = std::sin(phi);
+                        raw->push_back(p + Vec2d(n0.x * c - n0.y * s, n0.x * s + n0.y * c) * a);
+                    }
+                }
+            }
+        }
+
+        // Segments of a closed curve bucketed into strips along one axis,
+        // used to cast axis-aligned rays.
+        struct OffsetStrips
+        {
+            double min, size;
+            std::vector<size_t> offsets, segments;
+
+            OffsetStrips(const std::vector<Point2d>& verts, int axis, const Vec2d& min, const Vec2d& max) :
+                min(min[axis]),
+                size(1)
+            {
+                const size_t m = verts.size(),
+                             count = std::max<size_t>(1, 4 * (size_t)std::sqrt((double)m));
+                size = std::max(max[axis] - min[axis], 1e-300) / count;
+                offsets.assign(count + 1, 0);
+
+                auto range = [&](size_t i, size_t* first, size_t* last) {
+                    const double a = verts[i][axis],
+                                 b = verts[(i + 1) % m][axis];
+                    *first = index(std::min(a, b));
+                    *last = index(std::max(a, b));
+                };
+
+                size_t first, last;
+                for (size_t i = 0; i < m; ++i)
+                {
+                    range(i, &first, &last);
+                    for (size_t k = first; k <= last; ++k)
+                        ++offsets[k + 1];
+                }
+                for (size_t k = 0; k < count; ++k)
+                    offsets[k + 1] += offsets[k];
+
+                std::vector<size_t> fill(offsets.begin(), offsets.end() - 1);
+                segments.resize(offsets.back());
+                for (size_t i = 0; i < m; ++i)
+                {
+                    range(i, &first, &last);
+                    for (size_t k = first; k <= last; ++k)
+                        segments[fill[k]++] = i;
+                }
+            }
+
+            size_t index(double x) const
+            {
+                const double k = std::floor((x - min) / size);
+                return k <= 0 ? 0 : std::min((size_t)k, offsets.size() - 2);
+            }
+        };
+
+        // Computes the winding numbers of the curve directly left and right
+        // of a point m in the interior of a piece with direction d. An
+        // axis-aligned ray is cast from m: crossings beyond m are shared by
+        // both sides, crossings at m (the piece itself and collinear overlaps)
+        // only count for the side the ray starts from.
+        inline void offsetWinding(const std::vector<Point2d>& verts, const OffsetStrips* strips,
+                                  const Point2d& m, const Vec2d& d, double eps, int* wleft, int* wright)
+        {
+            const int axis = std::abs(d.y) >= std::abs(d.x) ? 0 : 1;
+            const Vec2d r = axis == 0 ? Vec2d(1, 0) : Vec2d(0, 1);
+            const OffsetStrips& strip = strips[1 - axis];
+            const size_t k = strip.index(m[1 - axis]);
+
+            int w = 0, c = 0;
+            for (size_t s = strip.offsets[k]; s < strip.offsets[k + 1]; ++s)
+            {
+                const size_t i = strip.segments[s];
+                const Vec2d a = verts[i] - m,
+                            b = verts[(i + 1) % verts.size()] - m;
+                const double va = r.cross(a),
+                             vb = r.cross(b);
+
+                if ((va <= 0) == (vb <= 0))
+                    continue;
+
+                const double ua = r.dot(a),
+                             ub = r.dot(b),
+                             u = ua + (ub - ua) * (va / (va - vb));
+                const int sgn = va <= 0 ? 1 : -1;
+                if (u > eps)
+                    w += sgn;
+                else if (u >= -eps)
+                    c += sgn;
+            }
+
+            const bool leftfirst = r.dot(Vec2d(-d.y, d.x)) < 0;
+            *wleft = leftfirst ? w + c : w;
+            *wright = leftfirst ? w : w + c;
+        }
+
+        // Resolves self-intersections of a raw offset curve and extracts
+        // the outlines of the area with positive winding number.
+        inline void offsetCleanup(std::vector<Point2d> raw, std::vector<std::vector<Point2d>>* loops)
+        {
+            loops->clear();
+
+            raw.erase(std::unique(raw.begin(), raw.end()), raw.end());
+            while (raw.size() > 1 && raw.front() == raw.back())
+                raw.pop_back();
+            if (raw.size() < 3)
+                return;
+
+            const size_t m = raw.size();
+
+            Vec2d min = raw[0].asVector(),
+                  max = min;
+            for (auto& p : raw)
+            {
+                min = mins(min, p.asVector());
+                max = maxs(max, p.asVector());
+            }
+            const double eps = 1e-9 * std::max(1.0, std::max(max.x - min.x, max.y - min.y));
+
+            // Vertex ids: raw vertices first, intersections are appended.
+            // Coincident vertices are merged with a union-find.
+            std::vector<Point2d> verts(raw);
+            std::vector<size_t> parent(m);
+            std::iota(parent.begin(), parent.end(), 0);
+
+            std::vector<std::vector<OffsetSplit>> splits(m);
+            for (size_t i = 0; i < m; ++i)
+            {
+                splits[i].push_back(OffsetSplit{ 0, i });
+                splits[i].push_back(OffsetSplit{ 1, (i + 1) % m });
+            }
+
+            // Adds an intersection at parameter t of segment i or returns
+            // the id of the end point it coincides with.
+            auto endpoint = [&](size_t i, double t, double len) -> size_t {
+                if (t * len <= eps)
+                    return i;
+                if ((1 - t) * len <= eps)
+                    return (i + 1) % m;
+                return (size_t)-1;
+            };
+
+            auto intersect = [&](size_t i, size_t j) {
+                const Point2d &a1 = raw[i], &a2 = raw[j];
+                const Vec2d d1 = raw[(i + 1) % m] - a1,
+                            d2 = raw[(j + 1) % m] - a2;
+                const double len1 = d1.abs(),
+                             len2 = d2.abs(),
+                             den = d1.cross(d2);
+
+                if (std::abs(den) > 1e-12 * len1 * len2)
+                {
+                    const double t = (a2 - a1).cross(d2) / den,
+                                 s = (a2 - a1).cross(d1) / den;
+                    if (t * len1 < -eps || (t - 1) * len1 > eps || s * len2 < -eps || (s - 1) * len2 > eps)
+                        return;
+
+                    const size_t e1 = endpoint(i, t, len1),
+                                 e2 = endpoint(j, s, len2);
+                    if (e1 != (size_t)-1 && e2 != (size_t)-1)
+                        offsetUnion(parent, e1, e2);
+                    else if (e1 != (size_t)-1)
+                        splits[j].push_back(OffsetSplit{ s, e1 });
+                    else if (e2 != (size_t)-1)
+                        splits[i].push_back(OffsetSplit{ t, e2 });
+                    else
+                    {
+                        const size_t id = verts.size();
+                        verts.push_back(a1 + d1 * t);
+                        parent.push_back(id);
+                        splits[i].push_back(OffsetSplit{ t, id });
+                        splits[j].push_back(OffsetSplit{ s, id });
+                    }
+                }
+                else if (std::abs((a2 - a1).cross(d1)) <= eps * len1)
+                {
+                    // Collinear: split each segment at the other's end points
+                    auto project = [&](size_t seg, const Vec2d& d, double len, size_t id) {
+                        const double t = (raw[id] - raw[seg]).dot(d) / (len * len);
+                        if (t * len < -eps || (t - 1) * len > eps)
+                            return;
+                        const size_t e = endpoint(seg, t, len);
+                        if (e != (size_t)-1)
+                            offsetUnion(parent, e, id);
+                        else
+                            splits[seg].push_back(OffsetSplit{ t, id });
+                    };
+                    project(i, d1, len1, j);
+                    project(i, d1, len1, (j + 1) % m);
+                    project(j, d2, len2, i);
+                    project(j, d2, len2, (i + 1) % m);
+                }
+            };
+
+            // Sweep over the x-extents to find candidate pairs
+            std::vector<size_t> order(m), active;
+            std::iota(order.begin(), order.end(), 0);
+            auto minx = [&](size_t i) { return std::min(raw[i].x, raw[(i + 1) % m].x); };
+            auto maxx = [&](size_t i) { return std::max(raw[i].x, raw[(i + 1) % m].x); };
+            std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return minx(a) < minx(b); });
+
+            for (size_t i : order)
+            {
+                const double x = minx(i) - eps,
+                             ymin = std::min(raw[i].y, raw[(i + 1) % m].y) - eps,
+                             ymax = std::max(raw[i].y, raw[(i + 1) % m].y) + eps;
+                active.erase(std::remove_if(active.begin(), active.end(),
+                            [&](size_t j) { return maxx(j) < x; }), active.end());
+                for (size_t j : active)
+                    if (std::max(raw[j].y, raw[(j + 1) % m].y) >= ymin && std::min(raw[j].y, raw[(j + 1) % m].y) <= ymax)
+                        intersect(i, j);
+                active.push_back(i);
+            }
+
+            // Split segments into pieces and keep those with positive
+            // winding on the left and none on the right side.
+            struct Piece
+            {
+                size_t from, to;
+            };
+            std::vector<Piece> pieces;
+
+            const OffsetStrips strips[2] = { OffsetStrips(raw, 0, min, max), OffsetStrips(raw, 1, min, max) };
+
+            for (size_t i = 0; i < m; ++i)
+            {
+                auto& s = splits[i];
+                std::sort(s.begin(), s.end());
+
+                const Vec2d d = raw[(i + 1) % m] - raw[i];
+                const double len = d.abs();
+
+                for (size_t k = 1; k < s.size(); ++k)
+                {
+                    if ((s[k].t - s[k - 1].t) * len <= eps)
+                    {
+                        offsetUnion(parent, s[k - 1].id, s[k].id);
+                        continue;
+                    }
+
+                    int wleft, wright;
+                    offsetWinding(raw, strips, raw[i] + d * ((s[k - 1].t + s[k].t) / 2), d, eps, &wleft, &wright);
+                    if (wleft > 0 && wright <= 0)
+                        pieces.push_back(Piece{ s[k - 1].id, s[k].id });
+                }
+            }
+
+            // Collinear overlaps running in the same direction are kept once
+            // per segment, so coincident pieces are merged before linking.
+            for (auto& p : pieces)
+            {
+                p.from = offsetFind(parent, p.from);
+                p.to = offsetFind(parent, p.to);
+            }
+            auto less = [](const Piece& a, const Piece& b) {
+                return a.from < b.from || (a.from == b.from && a.to < b.to);
+            };
+            auto equal = [](const Piece& a, const Piece& b) { return a.from == b.from && a.to == b.to; };
+            std::sort(pieces.begin(), pieces.end(), less);
+            pieces.erase(std::unique(pieces.begin(), pieces.end(), equal), pieces.end());
+
+            // Link pieces to outlines
+            std::vector<std::vector<size_t>> outgoing(verts.size());
+            for (size_t i = 0; i < pieces.size(); ++i)
+                if (pieces[i].from != pieces[i].to)
+                    outgoing[pieces[i].from].push_back(i);
+
+            std::vector<bool> used(pieces.size(), false);
+            std::vector<Point2d> loop;
+            for (size_t start = 0; start < pieces.size(); ++start)
+            {
+                if (used[start] || pieces[start].from == pieces[start].to)
+                    continue;
+
+                loop.clear();
+                size_t e = start;
+                bool closed = false;
+                while (true)
+                {
+                    used[e] = true;
+                    loop.push_back(verts[pieces[e].from]);
+
+                    const size_t v = pieces[e].to;
+                    if (v == pieces[start].from)
+                    {
+                        closed = true;
+                        break;
+                    }
+
+                    auto& out = outgoing[v];
+                    auto next = std::find_if(out.begin(), out.end(), [&used](size_t i) { return !used[i]; });
+                    if (next == out.end())
+                        break;
+                    e = *next;
+                }
+
+                if (!closed)
+                    continue;
+
+                // Remove collinear vertices
+                for (size_t i = 0; i < loop.size() && loop.size() >= 3;)
+                {
+                    const Point2d& a = loop[(i + loop.size() - 1) % loop.size()];
+                    const Point2d& c = loop[(i + 1) % loop.size()];
+                    const Vec2d ab = loop[i] - a,
+                                ac = c - a;
+                    if (std::abs(ab.cross(ac)) <= eps * ac.abs() && ab.dot(ac) >= 0 && ab.dot(ac) <= ac.abs_sqr())
+                        loop.erase(loop.begin() + i);
+                    else
+                        ++i;
+                }
+
+                if (loop.size() >= 3 && std::abs(offsetSignedArea(loop)) > eps * eps)
+                    loops->push_back(loop);
+            }
+        }
+    }
+
+
+    template <typename T, typename P>
+    void offsetPolygon(const AbstractPolygon<T>& pol, T delta, std::vector<P>* out,
+                       JoinType join, double miterlimit, double arctolerance)
+    {
+        assert(out && "out is null");
+        out->clear();
+
+        std::vector<Point2d> path;
+        path.reserve(pol.size());
+        for (size_t i = 0; i < pol.size(); ++i)
+        {
+            const Point2d p = pol.get(i);
+            if (path.empty() || p != path.back())
+                path.push_back(p);
+        }
+        while (path.size() > 1 && path.front() == path.back())
+            path.pop_back();
+
+        if (path.size() < 2)
+            return;
+
+        // Open polygons and single segments are traversed forth and back,
+        // which makes the ends spikes that get capped.
+        bool reversed = false;
+        double d = delta;
+        if (pol.getFillType() == Open || path.size() == 2)
+        {
+            for (size_t i = path.size() - 2; i > 0; --i)
+                path.push_back(path[i]);
+            d = std::abs(d);
+        }
+        else if (detail::offsetSignedArea(path) < 0)
+        {
+            std::reverse(path.begin(), path.end());
+            reversed = true;
+        }
+
+        const double a = std::abs(d);
+        std::vector<Point2d> raw(path);
+        if (d != 0)
+            detail::offsetRaw(path, d, join, std::max(1.0, miterlimit),
+                              arctolerance > 0 ? arctolerance : a / 100, &raw);
+
+        std::vector<std::vector<Point2d>> loops;
+        detail::offsetCleanup(std::move(raw), &loops);
+
+        out->resize(loops.size());
+        for (size_t i = 0; i < loops.size(); ++i)
+        {
+            if (reversed)
+                std::reverse(loops[i].begin(), loops[i].end());
+            for (auto& p : loops[i])
+                (*out)[i].add(Point2<T>(p));
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,838 @@
+#ifndef MATH_ROUND_INTERSECT_FUNCTIONS_HPP
+#define MATH_ROUND_INTERSECT_FUNCTIONS_HPP
+
+#include "intersect.hpp"
+#include "Circle.hpp"
+#include "Capsule.hpp"
+
+/*
+ * Intersection, sweep and distance functions for circles and capsules.
+ * Both are handled as a core, i.e. a point or a segment, grown by a
+ * radius. Circles and capsules overlap another shape if the distance
+ * between the core and the shape is at most the radius. A circle or
+ * capsule of the other side is a point or segment with the radii summed
+ * up.
+ * Casting a ray against a grown shape is the union of ray vs circle tests
+ * at its vertices and ray vs rectangle tests along its edges. A moving
+ * capsule first touches a shape either with one of its end circles, or
+ * the shape's vertices touch it, so sweeps are reduced to ray casts of
+ * the capsule's ends and of the shape's vertices in opposite direction.
+ * Penetration of overlapping shapes uses the closest points if the core
+ * is outside the shape, and otherwise the separating axis test. For
+ * concave polygons, the latter is an approximation.
+ *
+ * Static tests work like intersect(AABB, AABB): the normal points from
+ * the other shape towards the circle or capsule, and delta is the
+ * penetration vector, i.e. moving by -delta separates them.
+ * Sweeps work like sweep(AABB, vel, AABB): the result contains entry and
+ * exit times in [0, 1], seg is the movement of the circle's or capsule's
+ * center, and the normal is the contact normal at the entry time.
+ * Rays and lines passed as shapes are clipped to a segment around the
+ * circle's or capsule's projection first, which is long enough to give
+ * the same results as the unbounded line.
+ */
+
+namespace math
+{
+    template <typename T> bool            intersect(const Capsule<T>& capsule, const Point2<T>& point);
+
+    template <typename T> Intersection<T> intersect(const Line2<T>& line, const Circle<T>& circle);
+    template <typename T> Intersection<T> intersect(const Line2<T>& line, const Capsule<T>& capsule);
+
+    template <typename T> Intersection<T> intersect(const Circle<T>& circle, const Circle<T>& other);
+    template <typename T> Intersection<T> intersect(const Circle<T>& circle, const Capsule<T>& other);
+    template <typename T> Intersection<T> intersect(const Circle<T>& circle, const AABB<T>& box);
+    template <typename T> Intersection<T> intersect(const Circle<T>& circle, const Line2<T>& line);
+    template <typename T> Intersection<T> intersect(const Circle<T>& circle, const AbstractPolygon<T>& pol);
+
+    template <typename T> Intersection<T> intersect(const Capsule<T>& capsule, const Circle<T>& other);
+    template <typename T> Intersection<T> intersect(const Capsule<T>& capsule, const Capsule<T>& other);
+    template <typename T> Intersection<T> intersect(const Capsule<T>& capsule, const AABB<T>& box);
+    template <typename T> Intersection<T> intersect(const Capsule<T>& capsule, const Line2<T>& line);
+    template <typename T> Intersection<T> intersect(const Capsule<T>& capsule, const AbstractPolygon<T>& pol);
+
+    template <typename T> Intersection<T> sweep(const Circle<T>& circle, const Vec2<T>& vel, const Circle<T>& other);
+    template <typename T> Intersection<T> sweep(const Circle<T>& circle, const Vec2<T>& vel, const Capsule<T>& other);
+    template <typename T> Intersection<T> sweep(const Circle<T>& circle, const Vec2<T>& vel, const AABB<T>& box);
+    template <typename T> Intersection<T> sweep(const Circle<T>& circle, const Vec2<T>& vel, const Line2<T>& line);
+    template <typename T> Intersection<T> sweep(const Circle<T>& circle, const Vec2<T>& vel, const AbstractPolygon<T>& pol);
+
+    template <typename T> Intersection<T> sweep(const Capsule<T>& capsule, const Vec2<T>& vel, const Circle<T>& other);
+    template <typename T> Intersection<T> sweep(const Capsule<T>& capsule, const Vec2<T>& vel, const Capsule<T>& other);
+    template <typename T> Intersection<T> sweep(const Capsule<T>& capsule, const Vec2<T>& vel, const AABB<T>& box);
+    template <typename T> Intersection<T> sweep(const Capsule<T>& capsule, const Vec2<T>& vel, const Line2<T>& line);
+    template <typename T> Intersection<T> sweep(const Capsule<T>& capsule, const Vec2<T>& vel, const AbstractPolygon<T>& pol);
+
+    // Distance between the outlines, or 0 if they overlap.
+    template <typename T> T               distance(const Circle<T>& circle, const Point2<T>& point);
+    template <typename T> T               distance(const Circle<T>& circle, const Circle<T>& other);
+    template <typename T> T               distance(const Circle<T>& circle, const Capsule<T>& other);
+    template <typename T> T               distance(const Circle<T>& circle, const AABB<T>& box);
+    template <typename T> T               distance(const Circle<T>& circle, const Line2<T>& line);
+    template <typename T> T               distance(const Circle<T>& circle, const AbstractPolygon<T>& pol);
+
+    template <typename T> T               distance(const Capsule<T>& capsule, const Point2<T>& point);
+    template <typename T> T               distance(const Capsule<T>& capsule, const Circle<T>& other);
+    template <typename T> T               distance(const Capsule<T>& capsule, const Capsule<T>& other);
+    template <typename T> T               distance(const Capsule<T>& capsule, const AABB<T>& box);
+    template <typename T> T               distance(const Capsule<T>& capsule, const Line2<T>& line);
+    template <typename T> T               distance(const Capsule<T>& capsule, const AbstractPolygon<T>& pol);
+}
+
+
+#include "Polygon.hpp"
+#include <limits>
+#include <algorithm>
+#include <cmath>
+
+// Implementation
+namespace math
+{
+    namespace detail
+    {
+        // Shapes are passed as accessors, which return their points with
+        // operator(), the amount of points with size() and the fill type
+        // with getFillType(): a point has 1 point, a segment 2 open points
+        // and an AABB 4 filled points.
+
+        struct RoundPoint
+        {
+            Point2d p;
+
+            Point2d operator()(size_t) const { return p; }
+            size_t size() const { return 1; }
+            FillType getFillType() const { return Open; }
+        };
+
+        struct RoundSegment
+        {
+            Point2d a, b;
+
+            Point2d operator()(size_t i) const { return i == 0 ? a : b; }
+            size_t size() const { return 2; }
+            FillType getFillType() const { return Open; }
+        };
+
+        struct RoundQuad
+        {
+            Point2d corners[4];
+
+            Point2d operator()(size_t i) const { return corners[i]; }
+            size_t size() const { return 4; }
+            FillType getFillType() const { return Filled; }
+        };
+
+        template <typename T>
+        struct RoundPolygon
+        {
+            const AbstractPolygon<T>& pol;
+
+            Point2d operator()(size_t i) const { return pol.get(i); }
+            size_t size() const { return pol.size(); }
+            FillType getFillType() const { return pol.getFillType(); }
+        };
+
+        inline size_t roundEdgeCount(size_t n, FillType fill)
+        {
+            return n < 2 ? 0 : (fill != Open && n > 2 ? n : n - 1);
+        }
+
+        // Closest points between the segments p0-p1 and q0-q1, which may
+        // be points. See Ericson, Real-Time Collision Detection, 5.1.9.
+        inline double roundClosest(const Point2d& p0, const Point2d& p1, const Point2d& q0, const Point2d& q1,
+                                   Point2d* cp, Point2d* cq)
+        {
+            const Vec2d d1 = p1 - p0,
+                        d2 = q1 - q0,
+                        r = p0 - q0;
+            const double a = d1.abs_sqr(),
+                         e = d2.abs_sqr(),
+                         f = d2.dot(r);
+            double s = 0, t = 0;
+
+            if (a == 0)
+                t = e == 0 ? 0 : std::min(std::max(f / e, 0.0), 1.0);
+            else
+            {
+                const double c = d1.dot(r);
+                if (e == 0)
+                    s = std::min(std::max(-c / a, 0.0), 1.0);
+                else
+                {
+                    const double b = d1.dot(d2),
+                                 denom = a * e - b * b;
+                    s = denom > 0 ? std::min(std::max((b * f - c * e) / denom, 0.0), 1.0) : 0;
+                    t = (b * s + f) / e;
+                    if (t < 0)
+                    {
+                        t = 0;
+                        s = std::min(std::max(-c / a, 0.0), 1.0);
+                    }
+                    else if (t > 1)
+                    {
+                        t = 1;
+                        s = std::min(std::max((b - c) / a, 0.0), 1.0);
+                    }
+                }
+            }
+
+            *cp = p0 + d1 * s;
+            *cq = q0 + d2 * t;
+            return (*cp - *cq).abs();
+        }
+
+        template <typename S>
+        bool roundInside(const Point2d& p, const S& shape)
+        {
+            const size_t n = shape.size();
+            bool inside = false;
+            for (size_t i = 0, j = n - 1; i < n; j = i++)
+            {
+                const Point2d a = shape(i),
+                              b = shape(j);
+                if ((a.y > p.y) != (b.y > p.y)
+                        && p.x < a.x + (b.x - a.x) * (p.y - a.y) / (b.y - a.y))
+                    inside = !inside;
+            }
+            return inside;
+        }
+
+        // Returns the signed distance between the segment a0-a1 and a
+        // shape, negative if they overlap. normal points from the shape
+        // towards the segment.
+        template <typename S>
+        double roundSeparation(const Point2d& a0, const Point2d& a1, const S& shape, Vec2d* normal)
+        {
+            const size_t n = shape.size();
+            const FillType fill = shape.getFillType();
+            double dist = std::numeric_limits<double>::infinity();
+            Point2d ca, cb, p, q;
+            if (n == 1)
+                dist = roundClosest(a0, a1, shape(0), shape(0), &ca, &cb);
+
+            const size_t edges = roundEdgeCount(n, fill);
+            for (size_t i = 0; i < edges; ++i)
+            {
+                const double d = roundClosest(a0, a1, shape(i), shape((i + 1) % n), &p, &q);
+                if (d < dist)
+                {
+                    dist = d;
+                    ca = p;
+                    cb = q;
+                }
+            }
+
+            // Crossing segments give a distance of about 0 with an
+            // arbitrary direction, which is left to the axis test
+            const double slack = boundsSlack<double>(std::abs(ca.x) + std::abs(ca.y));
+            if (dist > slack && !(fill == Filled && n > 2 && roundInside(a0, shape)))
+            {
+                *normal = (ca - cb) / dist;
+                return dist;
+            }
+
+            // Separating axis test with the segment's and the edges'
+            // normals
+            double depth = std::numeric_limits<double>::infinity();
+            auto test = [&](const Vec2d& axis) {
+                const double len = axis.abs();
+                if (len == 0)
+                    return;
+                const Vec2d ax = axis / len;
+                const double s0 = ax.dot(a0.asVector()),
+                             s1 = ax.dot(a1.asVector());
+                double min = std::numeric_limits<double>::infinity(),
+                       max = -min;
+                for (size_t i = 0; i < n; ++i)
+                {
+                    const double s = ax.dot(shape(i).asVector());
+                    min = std::min(min, s);
+                    max = std::max(max, s);
+                }
+
+                const double pos = max - std::min(s0, s1),
+                             neg = std::max(s0, s1) - min;
+                if (pos < depth)
+                {
+                    depth = pos;
+                    *normal = ax;
+                }
+                if (neg < depth)
+                {
+                    depth = neg;
+                    *normal = -ax;
+                }
+            };
+
+            test((a1 - a0).left());
+            for (size_t i = 0; i < edges; ++i)
+                test((shape((i + 1) % n) - shape(i)).left());
+
+            if (depth == std::numeric_limits<double>::infinity())
+            {
+                // Two equal points
+                *normal = Vec2d(0, 1);
+                return 0;
+            }
+            return -depth;
+        }
+
+        // Clips the time interval [t0, t1] of p + d * t to min <= x <= max
+        // along one axis.
+        inline bool roundSlab(double p, double d, double min, double max, double* t0, double* t1)
+        {
+            if (d == 0)
+                return p >= min && p <= max;
+
+            double a = (min - p) / d,
+                   b = (max - p) / d;
+            if (a > b)
+                std::swap(a, b);
+            *t0 = std::max(*t0, a);
+            *t1 = std::min(*t1, b);
+            return *t0 <= *t1;
+        }
+
+        // Intersects p + d * t, tmin <= t <= tmax, with a shape grown by
+        // radius r. Returns entry and exit times.
+        template <typename S>
+        bool roundLine(const Point2d& p, const Vec2d& d, double tmin, double tmax,
+                       const S& shape, double r, double* near, double* far)
+        {
+            const size_t n = shape.size();
+            const FillType fill = shape.getFillType();
+            double tnear = std::numeric_limits<double>::infinity(),
+                   tfar = -tnear;
+            auto hit = [&](double t0, double t1) {
+                t0 = std::max(t0, tmin);
+                t1 = std::min(t1, tmax);
+                if (t0 <= t1)
+                {
+                    tnear = std::min(tnear, t0);
+                    tfar = std::max(tfar, t1);
+                }
+            };
+
+            // Circles around vertices
+            const double dd = d.abs_sqr();
+            for (size_t i = 0; i < n; ++i)
+            {
+                const Vec2d m = p - shape(i);
+                const double b = m.dot(d),
+                             c = m.abs_sqr() - r * r;
+                if (dd == 0)
+                {
+                    if (c <= 0)
+                        hit(tmin, tmax);
+                    continue;
+                }
+
+                const double disc = b * b - dd * c;
+                if (disc >= 0)
+                {
+                    const double s = std::sqrt(disc);
+                    hit((-b - s) / dd, (-b + s) / dd);
+                }
+            }
+
+            // Rectangles along edges
+            const size_t edges = roundEdgeCount(n, fill);
+            for (size_t i = 0; i < edges; ++i)
+            {
+                const Point2d a = shape(i);
+                const Vec2d e = shape((i + 1) % n) - a;
+                const double len = e.abs();
+                if (len == 0)
+                    continue;
+
+                const Vec2d u = e / len,
+                            v = u.left(),
+                            rel = p - a;
+                double t0 = -std::numeric_limits<double>::infinity(),
+                       t1 = std::numeric_limits<double>::infinity();
+                if (roundSlab(rel.dot(u), d.dot(u), 0, len, &t0, &t1)
+                        && roundSlab(rel.dot(v), d.dot(v), -r, r, &t0, &t1))
+                    hit(t0, t1);
+            }
+
+            // Starting inside a filled shape
+            if (fill == Filled && n > 2 && tmin > -std::numeric_limits<double>::infinity()
+                    && roundInside(p + d * tmin, shape))
+                hit(tmin, tmin);
+
+            if (tnear > tfar)
+                return false;
+
+            *near = tnear;
+            *far = tfar;
+            return true;
+        }
+
+        // Sweeps the segment a0-a1 grown by r, moving by vel, against a
+        // shape. Returns entry and exit times in [0, 1].
+        template <typename S>
+        bool roundSweep(const Point2d& a0, const Point2d& a1, const Vec2d& vel, double r,
+                        const S& shape, double* near, double* far)
+        {
+            const size_t n = shape.size();
+            double tnear = std::numeric_limits<double>::infinity(),
+                   tfar = -tnear, t0, t1;
+            auto hit = [&](double t0, double t1) {
+                tnear = std::min(tnear, t0);
+                tfar = std::max(tfar, t1);
+            };
+
+            if (roundLine(a0, vel, 0, 1, shape, r, &t0, &t1))
+                hit(t0, t1);
+
+            if (a0 != a1)
+            {
+                if (roundLine(a1, vel, 0, 1, shape, r, &t0, &t1))
+                    hit(t0, t1);
+
+                // The shape's vertices moving towards the segment
+                for (size_t i = 0; i < n; ++i)
+                    if (roundLine(shape(i), -vel, 0, 1, RoundSegment{ a0, a1 }, r, &t0, &t1))
+                        hit(t0, t1);
+
+                // Crossing without touching a vertex, e.g. a long capsule
+                // lying across a box
+                Vec2d normal;
+                if (roundSeparation(a0, a1, shape, &normal) <= r)
+                    hit(0, 0);
+            }
+
+            if (tnear > tfar)
+                return false;
+
+            *near = tnear;
+            *far = tfar;
+            return true;
+        }
+
+        // Builds the results from the functions above.
+
+        template <typename T, typename S>
+        Intersection<T> roundIntersect(const Point2d& a0, const Point2d& a1, double r,
+                                       const S& shape, IntersectionType type)
+        {
+            Vec2d normal;
+            const double depth = r - roundSeparation(a0, a1, shape, &normal);
+            if (depth < 0)
+                return Intersection<T>();
+
+            Intersection<T> isec(Vec2<T>(-normal * depth), Vec2<T>(normal));
+            isec.type = type;
+            return isec;
+        }
+
+        template <typename T, typename S>
+        T roundDistance(const Point2d& a0, const Point2d& a1, double r, const S& shape)
+        {
+            Vec2d normal;
+            return std::max(roundSeparation(a0, a1, shape, &normal) - r, 0.0);
+        }
+
+        template <typename T, typename S>
+        Intersection<T> roundCast(const Line2<T>& line, double r, const S& shape, IntersectionType type)
+        {
+            const double inf = std::numeric_limits<double>::infinity();
+            const Point2d p = line.p;
+            const Vec2d d = line.d;
+            double near, far;
+            if (!roundLine(p, d, line.type == Line ? -inf : 0, line.type == Segment ? 1 : inf,
+                           shape, r, &near, &far))
+                return Intersection<T>();
+
+            Vec2d normal;
+            const Point2d entry = p + d * near;
+            roundSeparation(entry, entry, shape, &normal);
+
+            Intersection<T> isec(Point2<T>(entry), Point2<T>(p + d * far),
+                                 Vec2<T>(near, far), Vec2<T>(normal));
+            isec.type = type;
+            return isec;
+        }
+
+        template <typename T, typename S>
+        Intersection<T> roundSweep(const Point2d& a0, const Point2d& a1, const Vec2d& vel, double r,
+                                   const S& shape, IntersectionType type)
+        {
+            double near, far;
+            if (!roundSweep(a0, a1, vel, r, shape, &near, &far))
+                return Intersection<T>();
+
+            Vec2d normal;
+            roundSeparation(a0 + vel * near, a1 + vel * near, shape, &normal);
+
+            const Point2d center = a0 + (a1 - a0) / 2;
+            Intersection<T> isec(Point2<T>(center + vel * near), Point2<T>(center + vel * far),
+                                 Vec2<T>(near, far), Vec2<T>(normal));
+            isec.type = type;
+            return isec;
+        }
+
+        // Rejects polygons whose cached bounding circle is farther than r
+        // away from the area swept by the segment a0-a1 moving by vel.
+        template <typename T>
+        bool roundReject(const Point2d& a0, const Point2d& a1, const Vec2d& vel, double r,
+                         const AbstractPolygon<T>& pol)
+        {
+            const Circle<T>* circle = pol.getBoundingCircle();
+            if (!circle)
+                return false;
+
+            const Point2d c = circle->center;
+            const double limit = r + circle->radius
+                + detail::boundsSlack<T>(std::abs(c.x) + std::abs(c.y) + r + circle->radius
+                                         + std::abs(a0.x) + std::abs(a0.y));
+            const RoundQuad quad = { { a0, a1, a1 + vel, a0 + vel } };
+
+            Point2d p, q;
+            for (size_t i = 0; i < 4; ++i)
+                if (roundClosest(quad(i), quad((i + 1) % 4), c, c, &p, &q) <= limit)
+                    return false;
+            return !roundInside(c, quad);
+        }
+
+        template <typename T>
+        RoundQuad roundBox(const AABB<T>& box)
+        {
+            return RoundQuad{ { Point2d(box.x, box.y), Point2d(box.x + box.w, box.y),
+                                Point2d(box.x + box.w, box.y + box.h), Point2d(box.x, box.y + box.h) } };
+        }
+
+        // Clips rays and lines to a segment containing their closest points
+        // to the segment a0-a1 moving by vel, i.e. the range of the
+        // projected core, extended by the core's length plus r on open
+        // sides. The separating axis test then treats it like an infinite
+        // line. Segments are returned as they are.
+        template <typename T>
+        RoundSegment roundClipLine(const Line2<T>& line, const Point2d& a0, const Point2d& a1,
+                                   const Vec2d& vel, double r)
+        {
+            const Point2d p = line.p;
+            const Vec2d d = line.d;
+            const double dd = d.abs_sqr();
+            if (line.type == Segment || dd == 0)
+                return RoundSegment{ p, p + d };
+
+            const Point2d core[] = { a0, a1, a0 + vel, a1 + vel };
+            double lo = std::numeric_limits<double>::infinity(),
+                   hi = -lo;
+            for (auto& q : core)
+            {
+                const double t = (q - p).dot(d) / dd;
+                lo = std::min(lo, t);
+                hi = std::max(hi, t);
+            }
+
+            const double extra = ((a1 - a0).abs() + r) / std::sqrt(dd);
+            lo -= extra;
+            hi += extra;
+            if (line.type == Ray)
+            {
+                lo = std::max(lo, 0.0);
+                hi = std::max(hi, 0.0);
+            }
+            return RoundSegment{ p + d * lo, p + d * hi };
+        }
+    }
+
+    template <typename T>
+    bool intersect(const Capsule<T>& capsule, const Point2<T>& point)
+    {
+        return detail::roundDistance<T>(capsule.a, capsule.b, capsule.radius, detail::RoundPoint{ point }) == 0;
+    }
+
+    template <typename T>
+    Intersection<T> intersect(const Line2<T>& line, const Circle<T>& circle)
+    {
+        return detail::roundCast(line, circle.radius, detail::RoundPoint{ circle.center }, LinexCircle);
+    }
+
+    template <typename T>
+    Intersection<T> intersect(const Line2<T>& line, const Capsule<T>& capsule)
+    {
+        return detail::roundCast(line, capsule.radius, detail::RoundSegment{ capsule.a, capsule.b }, LinexCapsule);
+    }
+
+
+    template <typename T>
+    Intersection<T> intersect(const Circle<T>& circle, const Circle<T>& other)
+    {
+        const Vec2d d = Point2d(circle.center) - Point2d(other.center);
+        const double r = (double)circle.radius + other.radius,
+                     dist = d.abs();
+        if (dist > r)
+            return Intersection<T>();
+
+        const Vec2d normal = dist > 0 ? d / dist : Vec2d(0, 1);
+        Intersection<T> isec(Vec2<T>(normal * (dist - r)), Vec2<T>(normal));
+        isec.type = CirclexShape;
+        return isec;
+    }
+
+    template <typename T>
+    Intersection<T> intersect(const Circle<T>& circle, const Capsule<T>& other)
+    {
+        return detail::roundIntersect<T>(circle.center, circle.center, (double)circle.radius + other.radius,
+                                         detail::RoundSegment{ other.a, other.b }, CirclexShape);
+    }
+
+    template <typename T>
+    Intersection<T> intersect(const Circle<T>& circle, const AABB<T>& box)
+    {
+        const Point2d c = circle.center;
+        const double r = circle.radius;
+        const Point2d closest(std::min(std::max(c.x, (double)box.x), (double)box.x + box.w),
+                              std::min(std::max(c.y, (double)box.y), (double)box.y + box.h));
+        const Vec2d d = c - closest;
+        const double dist = d.abs();
+        if (dist > r)
+            return Intersection<T>();
+
+        Vec2d normal;
+        double depth;
+        if (dist > 0)
+        {
+            normal = d / dist;
+            depth = r - dist;
+        }
+        else
+        {
+            // Center inside, push out through the nearest side
+            const double sides[] = { c.x - box.x, box.x + box.w - c.x, c.y - box.y, box.y + box.h - c.y };
+            const Vec2d normals[] = { Vec2d(-1, 0), Vec2d(1, 0), Vec2d(0, -1), Vec2d(0, 1) };
+            const size_t i = std::min_element(sides, sides + 4) - sides;
+            normal = normals[i];
+            depth = r + sides[i];
+        }
+
+        Intersection<T> isec(Vec2<T>(-normal * depth), Vec2<T>(normal));
+        isec.type = CirclexShape;
+        return isec;
+    }
+
+    template <typename T>
+    Intersection<T> intersect(const Circle<T>& circle, const Line2<T>& line)
+    {
+        return detail::roundIntersect<T>(circle.center, circle.center, circle.radius,
+                                         detail::roundClipLine(line, circle.center, circle.center, Vec2d(), circle.radius),
+                                         CirclexShape);
+    }
+
+    template <typename T>
+    Intersection<T> intersect(const Circle<T>& circle, const AbstractPolygon<T>& pol)
+    {
+        if (pol.size() == 0 || !intersect(circle.getBBox(), pol.getBBox())
+                || detail::roundReject(circle.center, circle.center, Vec2d(), circle.radius, pol))
+            return Intersection<T>();
+        return detail::roundIntersect<T>(circle.center, circle.center, circle.radius,
+                                         detail::RoundPolygon<T>{ pol }, CirclexShape);
+    }
+
+
+    template <typename T>
+    Intersection<T> intersect(const Capsule<T>& capsule, const Circle<T>& other)
+    {
+        return detail::roundIntersect<T>(capsule.a, capsule.b, (double)capsule.radius + other.radius,
+                                         detail::RoundPoint{ other.center }, CapsulexShape);
+    }
+
+    template <typename T>
+    Intersection<T> intersect(const Capsule<T>& capsule, const Capsule<T>& other)
+    {
+        return detail::roundIntersect<T>(capsule.a, capsule.b, (double)capsule.radius + other.radius,
+                                         detail::RoundSegment{ other.a, other.b }, CapsulexShape);
+    }
+
+    template <typename T>
+    Intersection<T> intersect(const Capsule<T>& capsule, const AABB<T>& box)
+    {
+        return detail::roundIntersect<T>(capsule.a, capsule.b, capsule.radius, detail::roundBox(box), CapsulexShape);
+    }
+
+    template <typename T>
+    Intersection<T> intersect(const Capsule<T>& capsule, const Line2<T>& line)
+    {
+        return detail::roundIntersect<T>(capsule.a, capsule.b, capsule.radius,
+                                         detail::roundClipLine(line, capsule.a, capsule.b, Vec2d(), capsule.radius),
+                                         CapsulexShape);
+    }
+
+    template <typename T>
+    Intersection<T> intersect(const Capsule<T>& capsule, const AbstractPolygon<T>& pol)
+    {
+        if (pol.size() == 0 || !intersect(capsule.getBBox(), pol.getBBox())
+                || detail::roundReject(capsule.a, capsule.b, Vec2d(), capsule.radius, pol))
+            return Intersection<T>();
+        return detail::roundIntersect<T>(capsule.a, capsule.b, capsule.radius,
+                                         detail::RoundPolygon<T>{ pol }, CapsulexShape);
+    }
+
+
+    template <typename T>
+    Intersection<T> sweep(const Circle<T>& circle, const Vec2<T>& vel, const Circle<T>& other)
+    {
+        return detail::roundSweep<T>(circle.center, circle.center, vel, (double)circle.radius + other.radius,
+                                     detail::RoundPoint{ other.center }, SweptCirclexShape);
+    }
+
+    template <typename T>
+    Intersection<T> sweep(const Circle<T>& circle, const Vec2<T>& vel, const Capsule<T>& other)
+    {
+        return detail::roundSweep<T>(circle.center, circle.center, vel, (double)circle.radius + other.radius,
+                                     detail::RoundSegment{ other.a, other.b }, SweptCirclexShape);
+    }
+
+    template <typename T>
+    Intersection<T> sweep(const Circle<T>& circle, const Vec2<T>& vel, const AABB<T>& box)
+    {
+        return detail::roundSweep<T>(circle.center, circle.center, vel, circle.radius,
+                                     detail::roundBox(box), SweptCirclexShape);
+    }
+
+    template <typename T>
+    Intersection<T> sweep(const Circle<T>& circle, const Vec2<T>& vel, const Line2<T>& line)
+    {
+        return detail::roundSweep<T>(circle.center, circle.center, vel, circle.radius,
+                                     detail::roundClipLine(line, circle.center, circle.center, vel, circle.radius),
+                                     SweptCirclexShape);
+    }
+
+    template <typename T>
+    Intersection<T> sweep(const Circle<T>& circle, const Vec2<T>& vel, const AbstractPolygon<T>& pol)
+    {
+        if (pol.size() == 0 || !sweep(circle.getBBox(), vel, pol.getBBox())
+                || detail::roundReject(circle.center, circle.center, vel, circle.radius, pol))
+            return Intersection<T>();
+        return detail::roundSweep<T>(circle.center, circle.center, vel, circle.radius,
+                                     detail::RoundPolygon<T>{ pol }, SweptCirclexShape);
+    }
+
+
+    template <typename T>
+    Intersection<T> sweep(const Capsule<T>& capsule, const Vec2<T>& vel, const Circle<T>& other)
+    {
+        return detail::roundSweep<T>(capsule.a, capsule.b, vel, (double)capsule.radius + other.radius,
+                                     detail::RoundPoint{ other.center }, SweptCapsulexShape);
+    }
+
+    template <typename T>
+    Intersection<T> sweep(const Capsule<T>& capsule, const Vec2<T>& vel, const Capsule<T>& other)
+    {
+        return detail::roundSweep<T>(capsule.a, capsule.b, vel, (double)capsule.radius + other.radius,
+                                     detail::RoundSegment{ other.a, other.b }, SweptCapsulexShape);
+    }
+
+    template <typename T>
+    Intersection<T> sweep(const Capsule<T>& capsule, const Vec2<T>& vel, const AABB<T>& box)
+    {
+        return detail::roundSweep<T>(capsule.a, capsule.b, vel, capsule.radius,
+                                     detail::roundBox(box), SweptCapsulexShape);
+    }
+
+    template <typename T>
+    Intersection<T> sweep(const Capsule<T>& capsule, const Vec2<T>& vel, const Line2<T>& line)
+    {
+        return detail::roundSweep<T>(capsule.a, capsule.b, vel, capsule.radius,
+                                     detail::roundClipLine(line, capsule.a, capsule.b, vel, capsule.radius),
+                                     SweptCapsulexShape);
+    }
+
+    template <typename T>
+    Intersection<T> sweep(const Capsule<T>& capsule, const Vec2<T>& vel, const AbstractPolygon<T>& pol)
+    {
+        if (pol.size() == 0 || !sweep(capsule.getBBox(), vel, pol.getBBox())
+                || detail::roundReject(capsule.a, capsule.b, vel, capsule.radius, pol))
+            return Intersection<T>();
+        return detail::roundSweep<T>(capsule.a, capsule.b, vel, capsule.radius,
+                                     detail::RoundPolygon<T>{ pol }, SweptCapsulexShape);
+    }
+
+
+    template <typename T>
+    T distance(const Circle<T>& circle, const Point2<T>& point)
+    {
+        return std::max((T)((point - circle.center).abs() - circle.radius), (T)0);
+    }
+
+    template <typename T>
+    T distance(const Circle<T>& circle, const Circle<T>& other)
+    {
+        return std::max((T)((other.center - circle.center).abs() - circle.radius - other.radius), (T)0);
+    }
+
+    template <typename T>
+    T distance(const Circle<T>& circle, const Capsule<T>& other)
+    {
+        return detail::roundDistance<T>(circle.center, circle.center, (double)circle.radius + other.radius,
+                                        detail::RoundSegment{ other.a, other.b });
+    }
+
+    template <typename T>
+    T distance(const Circle<T>& circle, const AABB<T>& box)
+    {
+        return detail::roundDistance<T>(circle.center, circle.center, circle.radius, detail::roundBox(box));
+    }
+
+    template <typename T>
+    T distance(const Circle<T>& circle, const Line2<T>& line)
+    {
+        return std::max((T)(line.distance(circle.center) - circle.radius), (T)0);
+    }
+
+    template <typename T>
+    T distance(const Circle<T>& circle, const AbstractPolygon<T>& pol)
+    {
+        if (pol.size() == 0)
+            return std::numeric_limits<T>::max();
+        return detail::roundDistance<T>(circle.center, circle.center, circle.radius, detail::RoundPolygon<T>{ pol });
+    }
+
+
+    template <typename T>
+    T distance(const Capsule<T>& capsule, const Point2<T>& point)
+    {
+        return detail::roundDistance<T>(capsule.a, capsule.b, capsule.radius, detail::RoundPoint{ point });
+    }
+
+    template <typename T>
+    T distance(const Capsule<T>& capsule, const Circle<T>& other)
+    {
+        return detail::roundDistance<T>(capsule.a, capsule.b, (double)capsule.radius + other.radius,
+                                        detail::RoundPoint{ other.center });
+    }
+
+    template <typename T>
+    T distance(const Capsule<T>& capsule, const Capsule<T>& other)
+    {
+        return detail::roundDistance<T>(capsule.a, capsule.b, (double)capsule.radius + other.radius,
+                                        detail::RoundSegment{ other.a, other.b });
+    }
+
+    template <typename T>
+    T distance(const Capsule<T>& capsule, const AABB<T>& box)
+    {
+        return detail::roundDistance<T>(capsule.a, capsule.b, capsule.radius, detail::roundBox(box));
+    }
+
+    template <typename T>
+    T distance(const Capsule<T>& capsule, const Line2<T>& line)
+    {
+        return detail::roundDistance<T>(capsule.a, capsule.b, capsule.radius,
+                                        detail::roundClipLine(line, capsule.a, capsule.b, Vec2d(), capsule.radius));
+    }
+
+    template <typename T>
+    T distance(const Capsule<T>& capsule, const AbstractPolygon<T>& pol)
+    {
+        if (pol.size() == 0)
+            return std::numeric_limits<T>::max();
+        return detail::roundDistance<T>(capsule.a, capsule.b, capsule.radius, detail::RoundPolygon<T>{ pol });
+    }
+
+}
+
+#endif
@@ -0,0 +1,294 @@
+#ifndef CPPMATH_GEOMETRY_SIMPLIFY_HPP
+#define CPPMATH_GEOMETRY_SIMPLIFY_HPP
+
+#include <cstddef>
+
+namespace math
+{
+    template <typename>
+    class AbstractPointSet;
+
+    // Polyline and polygon simplification.
+    // If closed is true, the point set is treated as a closed polygon and the
+    // result has at least 3 vertices, otherwise the end points are kept and
+    // the result has at least 2 vertices.
+    // Input and output parameters must _not_ be the same.
+
+    // Douglas-Peucker simplification.
+    // Removes vertices that are closer than tolerance to the simplified line.
+    template <typename T>
+    void simplifyDouglasPeucker(const AbstractPointSet<T>& points, AbstractPointSet<T>* out,
+                                double tolerance, bool closed = false);
+
+    // Visvalingam-Whyatt simplification in O(n log n).
+    // Removes vertices whose effective area (the area of the triangle formed
+    // with its neighbours) is smaller than tolerance.
+    // If maxvertices is non-zero, further vertices are removed until the
+    // result has at most maxvertices vertices.
+    template <typename T>
+    void simplifyVisvalingam(const AbstractPointSet<T>& points, AbstractPointSet<T>* out,
+                             double tolerance, size_t maxvertices = 0, bool closed = false);
+}
+
+
+#include "PointSet.hpp"
+#include <vector>
+#include <queue>
+#include <limits>
+#include <functional>
+#include <algorithm>
+#include <cassert>
+
+// Implementation
+namespace math
+{
+    namespace detail
+    {
+        template <typename T>
+        void readPoints(const AbstractPointSet<T>& points, std::vector<Point2<T>>* out)
+        {
+            out->resize(points.size());
+            for (size_t i = 0; i < points.size(); ++i)
+                (*out)[i] = points.get(i);
+        }
+
+        // Computes the effective area at which each vertex would be removed
+        // by the Visvalingam-Whyatt algorithm. Areas are made monotonic, so
+        // removing all vertices below a threshold is equivalent to running
+        // the algorithm until the smallest area exceeds that threshold.
+        // Vertices that are never removed get an infinite area.
+        // As monotonic areas can tie, rank receives the step at which each
+        // vertex is removed, or n if it is never removed.
+        template <typename T>
+        void visvalingamImportance(const std::vector<Point2<T>>& points, bool closed,
+                                   std::vector<double>* importance, std::vector<size_t>* rank)
+        {
+            const size_t n = points.size(),
+                         npos = (size_t)-1;
+            const double inf = std::numeric_limits<double>::infinity();
+
+            importance->assign(n, inf);
+            rank->assign(n, n);
+            size_t minsize = closed ? 3 : 2;
+            if (n <= minsize)
+                return;
+
+            std::vector<size_t> prev(n), next(n);
+            std::vector<double> areas(n);
+            for (size_t i = 0; i < n; ++i)
+            {
+                prev[i] = i > 0 ? i - 1 : (closed ? n - 1 : npos);
+                next[i] = i + 1 < n ? i + 1 : (closed ? 0 : npos);
+            }
+
+            auto area = [&](size_t i) {
+                if (prev[i] == npos || next[i] == npos)
+                    return inf;
+                Vec2d a = points[prev[i]] - points[i],
+                      b = points[next[i]] - points[i];
+                return std::abs(a.cross(b)) / 2;
+            };
+
+            typedef std::pair<double, size_t> Entry;
+            std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> heap;
+            for (size_t i = 0; i < n; ++i)
+            {
+                areas[i] = area(i);
+                heap.push(Entry(areas[i], i));
+            }
+
+            double last = 0;
+            size_t remaining = n;
+            while (remaining > minsize && !heap.empty())
+            {
+                Entry e = heap.top();
+                heap.pop();
+
+                size_t i = e.second;
+                if (e.first != areas[i] || (*importance)[i] != inf || e.first == inf)
+                    continue;   // Outdated or already removed
+
+                last = std::max(last, e.first);
+                (*importance)[i] = last;
+                (*rank)[i] = n - remaining;
+                --remaining;
+
+                size_t p = prev[i], nx = next[i];
+                if (p != npos)
+                    next[p] = nx;
+                if (nx != npos)
+                    prev[nx] = p;
+
+                if (p != npos)
+                {
+                    areas[p] = area(p);
+                    heap.push(Entry(areas[p], p));
+                }
+                if (nx != npos)
+                {
+                    areas[nx] = area(nx);
+                    heap.push(Entry(areas[nx], nx));
+                }
+            }
+        }
+
+        // Writes all points with an importance >= threshold to out.
+        // If maxvertices is non-zero, only the maxvertices most important
+        // points, i.e. the ones removed last, are kept. Points with infinite
+        // importance, e.g. the end points of open polylines, are always kept.
+        template <typename T>
+        void filterByImportance(const std::vector<Point2<T>>& points, const std::vector<double>& importance,
+                                const std::vector<size_t>& rank, double threshold, size_t maxvertices,
+                                AbstractPointSet<T>* out)
+        {
+            const double inf = std::numeric_limits<double>::infinity();
+            std::vector<bool> keep(points.size(), false);
+            std::vector<size_t> candidates;
+            size_t fixed = 0;
+            for (size_t i = 0; i < points.size(); ++i)
+            {
+                if (importance[i] == inf)
+                {
+                    keep[i] = true;
+                    ++fixed;
+                }
+                else if (importance[i] >= threshold)
+                    candidates.push_back(i);
+            }
+
+            if (maxvertices > 0)
+            {
+                const size_t room = maxvertices > fixed ? maxvertices - fixed : 0;
+                if (candidates.size() > room)
+                {
+                    std::nth_element(candidates.begin(), candidates.begin() + room, candidates.end(),
+                            [&rank](size_t a, size_t b) { return rank[a] > rank[b]; });
+                    candidates.resize(room);
+                }
+            }
+
+            for (size_t i : candidates)
+                keep[i] = true;
+
+            out->clear();
+            for (size_t i = 0; i < points.size(); ++i)
+                if (keep[i])
+                    out->add(points[i]);
+        }
+    }
+
+
+    template <typename T>
+    void simplifyDouglasPeucker(const AbstractPointSet<T>& points, AbstractPointSet<T>* out,
+                                double tolerance, bool closed)
+    {
+        assert(out && "out is null");
+        assert((void*)&points != (void*)out && "Input and output must not be the same");
+
+        std::vector<Point2<T>> p;
+        detail::readPoints(points, &p);
+        const size_t n = p.size();
+
+        if (n <= (closed ? 3u : 2u))
+        {
+            out->clear();
+            for (auto& i : p)
+                out->add(i);
+            return;
+        }
+
+        std::vector<bool> keep(n, false);
+        std::vector<std::pair<size_t, size_t>> stack;
+        const double tolsqr = tolerance * tolerance;
+
+        // Closed polygons are split at the first vertex and the vertex
+        // farthest away from it. Indices >= n wrap around.
+        if (closed)
+        {
+            size_t far = 0;
+            double maxdist = -1;
+            for (size_t i = 1; i < n; ++i)
+            {
+                double d = (p[i] - p[0]).abs_sqr();
+                if (d > maxdist)
+                {
+                    maxdist = d;
+                    far = i;
+                }
+            }
+            keep[0] = keep[far] = true;
+            stack.push_back(std::make_pair((size_t)0, far));
+            stack.push_back(std::make_pair(far, n));
+        }
+        else
+        {
+            keep[0] = keep[n - 1] = true;
+            stack.push_back(std::make_pair((size_t)0, n - 1));
+        }
+
+        while (!stack.empty())
+        {
+            size_t first = stack.back().first,
+                   last = stack.back().second;
+            stack.pop_back();
+
+            const Point2<T>& a = p[first];
+            const Vec2d ab = p[last % n] - a;
+            const double len = ab.abs_sqr();
+
+            size_t index = 0;
+            double maxdist = -1;
+            for (size_t i = first + 1; i < last; ++i)
+            {
+                Vec2d ap = p[i] - a;
+                double d;
+                if (len == 0)
+                    d = ap.abs_sqr();
+                else
+                {
+                    double t = math::clamp(ap.dot(ab) / len, 0.0, 1.0);
+                    d = (ap - ab * t).abs_sqr();
+                }
+
+                if (d > maxdist)
+                {
+                    maxdist = d;
+                    index = i;
+                }
+            }
+
+            if (maxdist > tolsqr)
+            {
+                keep[index] = true;
+                stack.push_back(std::make_pair(first, index));
+                stack.push_back(std::make_pair(index, last));
+            }
+        }
+
+        out->clear();
+        for (size_t i = 0; i < n; ++i)
+            if (keep[i])
+                out->add(p[i]);
+    }
+
+    template <typename T>
+    void simplifyVisvalingam(const AbstractPointSet<T>& points, AbstractPointSet<T>* out,
+                             double tolerance, size_t maxvertices, bool closed)
+    {
+        assert(out && "out is null");
+        assert((void*)&points != (void*)out && "Input and output must not be the same");
+
+        std::vector<Point2<T>> p;
+        std::vector<double> importance;
+        std::vector<size_t> rank;
+        detail::readPoints(points, &p);
+        detail::visvalingamImportance(p, closed, &importance, &rank);
+
+        if (maxvertices > 0)
+            maxvertices = std::max(maxvertices, std::min(p.size(), closed ? (size_t)3 : (size_t)2));
+
+        detail::filterByImportance(p, importance, rank, tolerance, maxvertices, out);
+    }
+}
+
+#endif
@@ -0,0 +1,196 @@
+#ifndef CPPMATH_GEOMETRY_TILE_COLLISION_HPP
+#define CPPMATH_GEOMETRY_TILE_COLLISION_HPP
+
+#include "Intersection.hpp"
+#include "AABB.hpp"
+#include "Grid.hpp"
+#include "gridtraversal.hpp"
+
+namespace math
+{
+    // Sweeps an AABB through a tile map and returns the earliest collision.
+    // Tiles are visited along the path of the box's center, expanded by the
+    // box's extent, and no memory is allocated, so the cost depends only on
+    // the distance travelled and the box's size.
+    // Faces shared by two solid tiles are ignored, which makes adjacent
+    // tiles behave like a single merged box and prevents movers from
+    // snagging on internal edges when sliding along a surface.
+    // Touching a tile without moving into it is not a collision.
+    // If the box already overlaps a tile by more than rounding errors, it is
+    // reported at time 0 with the normal pointing the shortest way out of
+    // the merged tiles, regardless of the velocity.
+    // The tile map is anchored at (0, 0), tile (x, y) covers the area
+    // [x, x + 1] * cellsize, [y, y + 1] * cellsize. Non-zero tiles are solid,
+    // out-of-bounds tiles are empty.
+    // The result has the same format as sweep(AABB, Vec2, AABB).
+    template <typename T, typename U>
+    Intersection<T> sweep(const AABB<T>& aabb, const Vec2<T>& vel, const Grid<U>& tiles,
+                          const Vec2<T>& cellsize, Point2i* tile = nullptr);
+}
+
+
+#include <limits>
+
+// Implementation
+namespace math
+{
+    template <typename T, typename U>
+    Intersection<T> sweep(const AABB<T>& aabb, const Vec2<T>& vel, const Grid<U>& tiles,
+                          const Vec2<T>& cellsize, Point2i* tile)
+    {
+        const double inf = std::numeric_limits<double>::infinity();
+        const Vec2d half = Vec2d(aabb.size) / 2.0,
+                    center(aabb.getCenter().asVector()),
+                    v(vel);
+
+        auto solid = [&](int x, int y) {
+            return tiles.get(x, y) != U();
+        };
+
+        const double slop = 1e-5 * std::max(cellsize.x, cellsize.y);
+        double best = inf, bestexit = 0;
+        Vec2i bestnormal;
+        Point2i besttile;
+
+        auto test = [&](int x, int y) {
+            if (!solid(x, y))
+                return;
+
+            // Ray from the mover's center against the tile extended by
+            // the mover's size
+            Vec2d bmin = Vec2d(x * (double)cellsize.x, y * (double)cellsize.y) - half,
+                  bmax = bmin + Vec2d(cellsize) + half * 2.0;
+
+            // Already embedded: push out along the shallowest face that is
+            // not shared with another solid tile
+            if (center.x > bmin.x && center.x < bmax.x && center.y > bmin.y && center.y < bmax.y)
+            {
+                const double depths[] = { center.x - bmin.x, bmax.x - center.x,
+                                          center.y - bmin.y, bmax.y - center.y };
+                const Vec2i dirs[] = { Vec2i(-1, 0), Vec2i(1, 0), Vec2i(0, -1), Vec2i(0, 1) };
+                double depth = inf;
+                Vec2i normal;
+                for (int i = 0; i < 4; ++i)
+                {
+                    if (depths[i] < depth && !solid(x + dirs[i].x, y + dirs[i].y))
+                    {
+                        depth = depths[i];
+                        normal = dirs[i];
+                    }
+                }
+
+                if (depth > slop && depth != inf)
+                {
+                    if (best > 0 || bestexit != inf)
+                    {
+                        best = 0;
+                        bestexit = inf;
+                        bestnormal = normal;
+                        besttile.set(x, y);
+                    }
+                    return;
+                }
+            }
+
+            Vec2d entry, exit;
+            for (int i = 0; i < 2; ++i)
+            {
+                if (v[i] == 0)
+                {
+                    if (center[i] <= bmin[i] || center[i] >= bmax[i])
+                        return;
+                    entry[i] = -inf;
+                    exit[i] = inf;
+                }
+                else
+                {
+                    double ta = (bmin[i] - center[i]) / v[i],
+                           tb = (bmax[i] - center[i]) / v[i];
+                    entry[i] = std::min(ta, tb);
+                    exit[i] = std::max(ta, tb);
+                }
+            }
+
+            double tentry = std::max(entry.x, entry.y),
+                   texit = std::min(exit.x, exit.y);
+
+            if (tentry >= texit || tentry > 1 || tentry > best)
+                return;
+
+            // Pick the face that was entered. At exact corners prefer
+            // the face that is not shared with another solid tile.
+            int axis = entry.x > entry.y ? 0 : 1;
+
+            // Tolerate tiny penetrations caused by rounding errors,
+            // e.g. when resting on the ground. Deeper ones are handled
+            // above.
+            if (tentry < 0)
+            {
+                if (-tentry * std::abs(v[axis]) > slop)
+                    return;
+                tentry = 0;
+            }
+            Vec2i normal;
+            normal[axis] = -sign(v[axis]);
+
+            if (solid(x + normal.x, y + normal.y))
+            {
+                if (entry.x != entry.y)
+                    return;
+
+                axis = 1 - axis;
+                normal.fill(0);
+                normal[axis] = -sign(v[axis]);
+                if (solid(x + normal.x, y + normal.y))
+                    return;
+            }
+
+            if (tentry < best || (tentry == best && texit > bestexit))
+            {
+                best = tentry;
+                bestexit = texit;
+                bestnormal = normal;
+                besttile.set(x, y);
+            }
+        };
+
+        // Walk the center's path. The box overlaps at most ext tiles on
+        // each side of the center's tile. Only tiles that were not covered
+        // by the previous step are tested.
+        const Vec2i ext((int)std::floor(half.x / cellsize.x) + 1, (int)std::floor(half.y / cellsize.y) + 1);
+        const int w = tiles.getWidth(), h = tiles.getHeight();
+        Point2i prevmin(1, 1), prevmax(0, 0);
+        traverseGrid(Line2d(center.asPoint(), v, Segment), Vec2d(cellsize),
+                [&](const Point2i& c, const Intersection<double>& isec) {
+                    // Tiles hit later than the best one are all further away
+                    if (isec.near > best)
+                        return true;
+
+                    const Point2i min(std::max(0, c.x - ext.x), std::max(0, c.y - ext.y)),
+                                  max(std::min(w - 1, c.x + ext.x), std::min(h - 1, c.y + ext.y));
+                    for (int y = min.y; y <= max.y; ++y)
+                        for (int x = min.x; x <= max.x; ++x)
+                            if (x < prevmin.x || x > prevmax.x || y < prevmin.y || y > prevmax.y)
+                                test(x, y);
+                    prevmin = min;
+                    prevmax = max;
+                    return false;
+                });
+
+        if (best == inf)
+            return Intersection<T>();
+
+        if (tile)
+            *tile = besttile;
+
+        bestexit = std::max(best, std::min(bestexit, 1.0));
+        Intersection<T> isec(Point2<T>((center + v * best).asPoint()),
+                             Point2<T>((center + v * bestexit).asPoint()),
+                             Vec2<T>(best, bestexit),
+                             Vec2<T>(bestnormal));
+        isec.type = SweptAABBxAABB;
+        return isec;
+    }
+}
+
+#endif
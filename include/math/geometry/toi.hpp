@@ -0,0 +1,172 @@
+#ifndef CPPMATH_GEOMETRY_TOI_HPP
+#define CPPMATH_GEOMETRY_TOI_HPP
+
+#include "Point2.hpp"
+
+/*
+ * Time of impact of convex polygons with linear and angular motion, using
+ * conservative advancement.
+ * At the current time, GJK gives the distance d and direction n between
+ * both polygons. No point of a polygon moves faster than its linear
+ * velocity plus its angular velocity times its bounding radius around
+ * the rotation center. Hence, the polygons can't approach each other
+ * along n faster than
+ *     mu = (vel_a - vel_b) * n + |angvel_a| * r_a + |angvel_b| * r_b,
+ * and time can safely advance by d / mu without skipping the impact.
+ * This is repeated until the distance is below the tolerance or the time
+ * exceeds the step. As the time never passes the actual impact, thin or
+ * fast rotating objects don't tunnel.
+ */
+
+namespace math
+{
+    template <typename>
+    class AbstractPointSet;
+
+    // Motion of a rigid body over a time step: a rotation around center
+    // followed by a translation.
+    template <class T>
+    class RigidMotion
+    {
+        public:
+            RigidMotion() : angvel(0) {}
+            RigidMotion(const Vec2<T>& vel_, T angvel_ = 0, const Point2<T>& center_ = Point2<T>()) :
+                center(center_), vel(vel_), angvel(angvel_) {}
+
+            // Returns where a point at time 0 is at the given time.
+            Point2<T> transform(const Point2<T>& p, T time) const;
+
+        public:
+            Point2<T> center;   // Rotation center at time 0
+            Vec2<T> vel;        // Translation over the whole step
+            T angvel;           // Rotation over the whole step in radians,
+                                // counter-clockwise in a y-up system
+    };
+
+    // Finds the first time in [0, 1] at which two filled convex polygons
+    // come closer than tolerance. The polygons' current vertices are their
+    // positions at time 0.
+    // If tolerance is 0, 1/1000 of the sum of the polygons' bounding box
+    // diagonals is used.
+    // Returns false if there is no impact within the step, or if maxiter
+    // iterations are not enough to reach the tolerance. In the latter case,
+    // time holds the time reached so far, which is still before a possible
+    // impact.
+    template <typename T>
+    bool timeOfImpact(const AbstractPointSet<T>& a, const RigidMotion<T>& ma,
+                      const AbstractPointSet<T>& b, const RigidMotion<T>& mb,
+                      T* time, T tolerance = 0, size_t maxiter = 64);
+}
+
+
+#include "gjk.hpp"
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <cassert>
+
+// Implementation
+namespace math
+{
+    namespace detail
+    {
+        // Transforms points to the given time and returns their bounding
+        // radius around the rotation center.
+        template <typename T>
+        double toiTransform(const AbstractPointSet<T>& pol, const RigidMotion<T>& motion,
+                            double time, std::vector<Point2d>* out)
+        {
+            const double angle = motion.angvel * time,
+                         c = std::cos(angle),
+                         s = std::sin(angle);
+            const Point2d center = motion.center;
+            const Vec2d offset = Vec2d(motion.vel) * time;
+
+            double radius = 0;
+            out->resize(pol.size());
+            for (size_t i = 0; i < pol.size(); ++i)
+            {
+                const Vec2d r = Point2d(pol.get(i)) - center;
+                (*out)[i] = center + Vec2d(r.x * c - r.y * s, r.x * s + r.y * c) + offset;
+                radius = std::max(radius, r.abs_sqr());
+            }
+            return std::sqrt(radius);
+        }
+
+        // Returns the bounding box diagonal of the given points.
+        inline double toiExtent(const std::vector<Point2d>& points)
+        {
+            if (points.empty())
+                return 0;
+
+            Point2d min = points[0], max = points[0];
+            for (auto& p : points)
+            {
+                min.x = std::min(min.x, p.x);
+                min.y = std::min(min.y, p.y);
+                max.x = std::max(max.x, p.x);
+                max.y = std::max(max.y, p.y);
+            }
+            return (max - min).abs();
+        }
+    }
+
+
+    template <class T>
+    Point2<T> RigidMotion<T>::transform(const Point2<T>& p, T time) const
+    {
+        const double angle = angvel * time,
+                     c = std::cos(angle),
+                     s = std::sin(angle);
+        const Vec2d r = Point2d(p) - Point2d(center);
+        return Point2<T>(Point2d(center) + Vec2d(r.x * c - r.y * s, r.x * s + r.y * c) + Vec2d(vel) * (double)time);
+    }
+
+    template <typename T>
+    bool timeOfImpact(const AbstractPointSet<T>& a, const RigidMotion<T>& ma,
+                      const AbstractPointSet<T>& b, const RigidMotion<T>& mb,
+                      T* time, T tolerance, size_t maxiter)
+    {
+        assert(time && "time is null");
+
+        std::vector<Point2d> va, vb;
+        const double ra = detail::toiTransform(a, ma, 0, &va),
+                     rb = detail::toiTransform(b, mb, 0, &vb);
+        const double tol = tolerance > 0 ? tolerance
+                                         : 1e-3 * (detail::toiExtent(va) + detail::toiExtent(vb));
+        const double spin = std::abs((double)ma.angvel) * ra + std::abs((double)mb.angvel) * rb;
+        const Vec2d relvel = Vec2d(ma.vel) - Vec2d(mb.vel);
+
+        double t = 0;
+        for (size_t iter = 0; iter < maxiter; ++iter)
+        {
+            if (iter > 0)
+            {
+                detail::toiTransform(a, ma, t, &va);
+                detail::toiTransform(b, mb, t, &vb);
+            }
+
+            Point2d pa, pb;
+            const double d = detail::gjkDistance(va, vb, &pa, &pb);
+            if (d <= tol)
+            {
+                *time = t;
+                return true;
+            }
+
+            // Upper bound of the approach speed along the separating direction
+            const double mu = relvel.dot((pb - pa) / d) + spin;
+            if (mu <= 0)
+                return false;
+
+            t += d / mu;
+            if (t > 1)
+                return false;
+        }
+
+        *time = t;
+        return false;
+    }
+}
+
+#endif
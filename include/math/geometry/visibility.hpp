@@ -0,0 +1,400 @@
+#ifndef CPPMATH_GEOMETRY_VISIBILITY_HPP
+#define CPPMATH_GEOMETRY_VISIBILITY_HPP
+
+#include <vector>
+#include "Line2.hpp"
+
+namespace math
+{
+    template <typename>
+    class AbstractPointSet;
+
+    template <typename>
+    class AbstractPolygon;
+
+    // Computes the visibility polygon of a viewpoint among line segments
+    // using an angular sweep in O(n log n).
+    // If radius > 0, the result is clipped to a regular polygon with
+    // vertices on the circle of the given radius around the viewpoint.
+    // Otherwise, it is bounded by the segments' combined bounding box.
+    // Crossing segments are split at their intersections.
+    // The resulting polygon is wound counter-clockwise in a y-up system.
+    // Existing content of out will be removed.
+    template <typename T>
+    void visibilityPolygon(const Point2<T>& viewpoint, const std::vector<Line2<T>>& segments,
+                           AbstractPointSet<T>* out, T radius = 0);
+
+    // Same as above, but uses all segments of the given polygons.
+    // If radius > 0, polygons whose bounding box is out of range are skipped.
+    template <typename T>
+    void visibilityPolygon(const Point2<T>& viewpoint, const std::vector<const AbstractPolygon<T>*>& polygons,
+                           AbstractPointSet<T>* out, T radius = 0);
+}
+
+
+#include "Polygon.hpp"
+#include <set>
+#include <algorithm>
+#include <cassert>
+
+// Implementation
+namespace math
+{
+    namespace detail
+    {
+        struct VisibilitySegment
+        {
+            Point2d a, b;   // a comes first in counter-clockwise order
+        };
+
+        // Orders segments by their distance to the viewpoint along any ray
+        // hitting both of them. Only valid for non-crossing segments.
+        struct VisibilityCompare
+        {
+            const std::vector<VisibilitySegment>* segs;
+            Point2d view;
+
+            static int side(const Point2d& p, const VisibilitySegment& s)
+            {
+                Vec2d d = s.b - s.a;
+                double c = d.cross(p - s.a);
+                return std::abs(c) <= 1e-9 * d.abs_sqr() ? 0 : sign(c);
+            }
+
+            bool operator()(size_t i, size_t j) const
+            {
+                if (i == j)
+                    return false;
+
+                const VisibilitySegment& a = (*segs)[i];
+                const VisibilitySegment& b = (*segs)[j];
+
+                // Is b completely on one side of a?
+                int s1 = side(b.a, a), s2 = side(b.b, a);
+                if (s1 != -s2 || s1 == 0)
+                {
+                    int s = s1 != 0 ? s1 : s2;
+                    if (s != 0)
+                        return s != side(view, a);
+                }
+
+                // Otherwise a must be completely on one side of b
+                s1 = side(a.a, b);
+                s2 = side(a.b, b);
+                int s = s1 != 0 ? s1 : s2;
+                if (s != 0 && s1 != -s2)
+                    return s == side(view, b);
+
+                // Collinear segments
+                double da = ((a.a + (a.b - a.a) / 2.0) - view).abs_sqr(),
+                       db = ((b.a + (b.b - b.a) / 2.0) - view).abs_sqr();
+                return da != db ? da < db : i < j;
+            }
+        };
+
+        // Number of vertices of the polygon approximating the radius cutoff.
+        // Points between the circle and the polygon's edges are lost, which
+        // is less than 0.5% of the radius.
+        static const int visibilityCircleVertices = 32;
+
+        // Clips a segment to a convex, counter-clockwise boundary.
+        // Returns false if nothing is left.
+        inline bool visibilityClip(VisibilitySegment* s, const std::vector<VisibilitySegment>& boundary)
+        {
+            const Vec2d d = s->b - s->a;
+            double t0 = 0, t1 = 1;
+            for (auto& edge : boundary)
+            {
+                // Inside is e.cross(s.a + d * t - edge.a) >= 0
+                const Vec2d e = edge.b - edge.a;
+                const double c = e.cross(s->a - edge.a), dc = e.cross(d);
+                if (dc == 0)
+                {
+                    if (c < 0)
+                        return false;
+                }
+                else if (dc > 0)
+                    t0 = std::max(t0, -c / dc);
+                else
+                    t1 = std::min(t1, -c / dc);
+            }
+
+            if (t0 >= t1)
+                return false;
+
+            const Point2d a = s->a;
+            s->a = a + d * t0;
+            s->b = a + d * t1;
+            return true;
+        }
+
+        // Splits segments where they cross each other, so the ordering
+        // above stays valid. Segments are sorted along x first, so only
+        // segments with overlapping x ranges are tested against each other.
+        inline void visibilitySplit(std::vector<VisibilitySegment>* segs)
+        {
+            const std::vector<VisibilitySegment>& in = *segs;
+            std::vector<size_t> order(in.size());
+            for (size_t i = 0; i < order.size(); ++i)
+                order[i] = i;
+            std::sort(order.begin(), order.end(), [&](size_t i, size_t j) {
+                return std::min(in[i].a.x, in[i].b.x) < std::min(in[j].a.x, in[j].b.x);
+            });
+
+            // (segment, parameter) of every crossing
+            std::vector<std::pair<size_t, double>> cuts;
+            for (size_t k = 0; k < order.size(); ++k)
+            {
+                const VisibilitySegment& a = in[order[k]];
+                const double maxx = std::max(a.a.x, a.b.x);
+                for (size_t l = k + 1; l < order.size(); ++l)
+                {
+                    const VisibilitySegment& b = in[order[l]];
+                    if (std::min(b.a.x, b.b.x) > maxx)
+                        break;
+
+                    // Only proper crossings, touching is fine
+                    int s1 = VisibilityCompare::side(b.a, a), s2 = VisibilityCompare::side(b.b, a);
+                    if (s1 == 0 || s1 != -s2)
+                        continue;
+                    s1 = VisibilityCompare::side(a.a, b);
+                    s2 = VisibilityCompare::side(a.b, b);
+                    if (s1 == 0 || s1 != -s2)
+                        continue;
+
+                    const Vec2d da = a.b - a.a, db = b.b - b.a, ab = b.a - a.a;
+                    const double denom = da.cross(db);
+                    cuts.push_back(std::make_pair(order[k], ab.cross(db) / denom));
+                    cuts.push_back(std::make_pair(order[l], ab.cross(da) / denom));
+                }
+            }
+
+            if (cuts.empty())
+                return;
+
+            std::sort(cuts.begin(), cuts.end());
+            std::vector<VisibilitySegment> out;
+            out.reserve(in.size() + cuts.size());
+            for (size_t i = 0, c = 0; i < in.size(); ++i)
+            {
+                VisibilitySegment piece = in[i];
+                const Vec2d d = in[i].b - in[i].a;
+                for (; c < cuts.size() && cuts[c].first == i; ++c)
+                {
+                    piece.b = in[i].a + d * cuts[c].second;
+                    out.push_back(piece);
+                    piece.a = piece.b;
+                }
+                piece.b = in[i].b;
+                out.push_back(piece);
+            }
+            segs->swap(out);
+        }
+
+        // Intersects the ray view + dir * t with the line through a segment.
+        inline Point2d visibilityRayHit(const Point2d& view, const Vec2d& dir, const VisibilitySegment& s)
+        {
+            Vec2d d = s.b - s.a;
+            double denom = dir.cross(d);
+            if (denom == 0)
+                return (s.a - view).abs_sqr() < (s.b - view).abs_sqr() ? s.a : s.b;
+            return view + dir * ((s.a - view).cross(d) / denom);
+        }
+    }
+
+
+    template <typename T>
+    void visibilityPolygon(const Point2<T>& viewpoint, const std::vector<Line2<T>>& segments,
+                           AbstractPointSet<T>* out, T radius)
+    {
+        assert(out && "out is null");
+        out->clear();
+
+        typedef detail::VisibilitySegment VSegment;
+        const Point2d view = viewpoint;
+
+        auto angle = [&](const Point2d& p) {
+            return std::atan2(p.y - view.y, p.x - view.x);
+        };
+
+        // Boundary, counter-clockwise around the viewpoint
+        std::vector<VSegment> boundary;
+        std::vector<Point2d> corners;
+        if (radius > 0)
+        {
+            const int n = detail::visibilityCircleVertices;
+            for (int i = 0; i < n; ++i)
+            {
+                const double a = 2 * pi * i / n;
+                corners.push_back(view + Vec2d(std::cos(a), std::sin(a)) * (double)radius);
+            }
+        }
+        else
+        {
+            Vec2d min = view.asVector(),
+                  max = view.asVector();
+            for (auto& s : segments)
+            {
+                Vec2d a(s.p.asVector()), b(s.p.asVector() + s.d);
+                min = mins(min, mins(a, b));
+                max = maxs(max, maxs(a, b));
+            }
+            const AABB<double> box(min.asPoint() - Vec2d(1, 1), max - min + Vec2d(2, 2));
+            corners.push_back(box.pos.asPoint());
+            corners.push_back(box.pos.asPoint() + Vec2d(box.w, 0));
+            corners.push_back(box.pos.asPoint() + box.size);
+            corners.push_back(box.pos.asPoint() + Vec2d(0, box.h));
+        }
+
+        for (size_t i = 0; i < corners.size(); ++i)
+        {
+            VSegment s;
+            s.a = corners[i];
+            s.b = corners[(i + 1) % corners.size()];
+            boundary.push_back(s);
+        }
+
+        std::vector<VSegment> obstacles;
+        obstacles.reserve(segments.size());
+        for (auto& line : segments)
+        {
+            VSegment s;
+            s.a = Point2d(line.p);
+            s.b = s.a + Vec2d(line.d);
+            if (detail::visibilityClip(&s, boundary))
+                obstacles.push_back(s);
+        }
+        detail::visibilitySplit(&obstacles);
+
+        std::vector<VSegment> segs = boundary;
+        segs.reserve(boundary.size() + obstacles.size());
+        for (auto s : obstacles)
+        {
+            // Segments collinear with the viewpoint can't occlude anything
+            Vec2d va = s.a - view, vb = s.b - view;
+            double c = va.cross(vb);
+            if (std::abs(c) <= 1e-12 * va.abs() * vb.abs())
+                continue;
+
+            if (c < 0)
+                std::swap(s.a, s.b);
+            segs.push_back(s);
+        }
+
+        struct Event
+        {
+            double angle;
+            size_t seg;
+            bool begin;
+
+            bool operator<(const Event& e) const
+            {
+                return angle < e.angle;
+            }
+        };
+
+        std::vector<Event> events;
+        events.reserve(segs.size() * 2);
+        for (size_t i = 0; i < segs.size(); ++i)
+        {
+            Event e;
+            e.seg = i;
+            e.begin = true;
+            e.angle = angle(segs[i].a);
+            events.push_back(e);
+            e.begin = false;
+            e.angle = angle(segs[i].b);
+            events.push_back(e);
+        }
+        std::sort(events.begin(), events.end());
+
+        detail::VisibilityCompare cmp;
+        cmp.segs = &segs;
+        cmp.view = view;
+        typedef std::set<size_t, detail::VisibilityCompare> State;
+        State state(cmp);
+        std::vector<typename State::iterator> iters(segs.size(), state.end());
+
+        // Segments wrapping around the start angle are active initially
+        for (size_t i = 0; i < segs.size(); ++i)
+            if (angle(segs[i].a) > angle(segs[i].b))
+                iters[i] = state.insert(i).first;
+
+        std::vector<Point2d> points;
+        auto emit = [&](const Point2d& p) {
+            if (points.empty() || !(p - points.back()).almostEquals(Vec2d()))
+                points.push_back(p);
+        };
+
+        for (size_t i = 0; i < events.size();)
+        {
+            size_t j = i;
+            while (j < events.size() && events[j].angle - events[i].angle <= 1e-12)
+                ++j;
+
+            long before = state.empty() ? -1 : *state.begin();
+
+            for (size_t k = i; k < j; ++k)
+            {
+                const Event& e = events[k];
+                if (!e.begin && iters[e.seg] != state.end())
+                {
+                    state.erase(iters[e.seg]);
+                    iters[e.seg] = state.end();
+                }
+            }
+
+            for (size_t k = i; k < j; ++k)
+            {
+                const Event& e = events[k];
+                if (e.begin && iters[e.seg] == state.end())
+                    iters[e.seg] = state.insert(e.seg).first;
+            }
+
+            long after = state.empty() ? -1 : *state.begin();
+
+            if (before != after)
+            {
+                const Event& e = events[i];
+                const VSegment& s = segs[e.seg];
+                Vec2d dir = (e.begin ? s.a : s.b) - view;
+
+                if (before >= 0)
+                    emit(detail::visibilityRayHit(view, dir, segs[before]));
+                if (after >= 0)
+                    emit(detail::visibilityRayHit(view, dir, segs[after]));
+            }
+
+            i = j;
+        }
+
+        if (points.size() > 1 && (points.front() - points.back()).almostEquals(Vec2d()))
+            points.pop_back();
+
+        for (auto& p : points)
+            out->add(Point2<T>(p));
+    }
+
+    template <typename T>
+    void visibilityPolygon(const Point2<T>& viewpoint, const std::vector<const AbstractPolygon<T>*>& polygons,
+                           AbstractPointSet<T>* out, T radius)
+    {
+        std::vector<Line2<T>> segments;
+        AABB<T> range(viewpoint - Vec2<T>(radius, radius), Vec2<T>(radius * 2, radius * 2));
+
+        for (auto pol : polygons)
+        {
+            if (radius > 0 && !intersect(range, pol->getBBox()))
+                continue;
+
+            pol->foreachSegment([&](const Line2<T>& seg) {
+                segments.push_back(seg);
+                return false;
+            });
+        }
+
+        visibilityPolygon(viewpoint, segments, out, radius);
+    }
+}
+
+#endif
@@ -4,6 +4,8 @@
 #define _USE_MATH_DEFINES
 #include <math.h>
 #include <algorithm>
+#include <limits>
+#include <atomic>
 #include "compat.hpp"
 
 namespace math
@@ -79,6 +81,24 @@ namespace math
         return inrange(val, base - rad, base + rad);
     }
 
+    namespace detail
+    {
+        // Slack to add to cached bounds around values of the given
+        // magnitude, so rounding never rejects points on their border.
+        template <typename T>
+        constexpr T boundsSlack(T magnitude)
+        {
+            return std::numeric_limits<T>::is_integer ? 1 : magnitude * std::numeric_limits<T>::epsilon() * 16;
+        }
+
+        // Returns a new, globally unique revision number for point sets.
+        inline size_t nextRevision()
+        {
+            static std::atomic<size_t> counter(0);
+            return ++counter;
+        }
+    }
+
     template <typename T>
     constexpr bool inrange(const T& val, const T& a, const T& b, bool incl = false)
     {
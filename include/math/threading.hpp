@@ -0,0 +1,72 @@
+#ifndef CPPMATH_THREADING_HPP
+#define CPPMATH_THREADING_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace math
+{
+    // Returns the number of threads to use for a given request.
+    // 0 means "auto" and resolves to the number of hardware threads.
+    inline size_t getThreadCount(size_t numthreads = 0);
+
+    // Splits [begin, end) into contiguous chunks of at least minchunk
+    // elements and processes them on up to numthreads threads.
+    // The calling thread processes the first chunk itself.
+    // Callback signature: void (size_t begin, size_t end)
+    template <typename F>
+    void parallelFor(size_t begin, size_t end, F f, size_t numthreads = 0, size_t minchunk = 1);
+}
+
+
+// Implementation
+namespace math
+{
+    inline size_t getThreadCount(size_t numthreads)
+    {
+        if (numthreads > 0)
+            return numthreads;
+        size_t hw = std::thread::hardware_concurrency();
+        return hw > 0 ? hw : 1;
+    }
+
+    template <typename F>
+    void parallelFor(size_t begin, size_t end, F f, size_t numthreads, size_t minchunk)
+    {
+        if (end <= begin)
+            return;
+
+        size_t n = end - begin;
+        size_t chunks = std::min(getThreadCount(numthreads), (n + minchunk - 1) / std::max<size_t>(minchunk, 1));
+
+        if (chunks <= 1)
+        {
+            f(begin, end);
+            return;
+        }
+
+        std::vector<std::thread> threads;
+        threads.reserve(chunks - 1);
+
+        size_t chunksize = n / chunks,
+               rest = n % chunks,
+               first = begin + chunksize + (rest > 0 ? 1 : 0),
+               start = first;
+
+        for (size_t i = 1; i < chunks; ++i)
+        {
+            size_t stop = start + chunksize + (i < rest ? 1 : 0);
+            threads.push_back(std::thread(f, start, stop));
+            start = stop;
+        }
+
+        f(begin, first);
+
+        for (auto& t : threads)
+            t.join();
+    }
+}
+
+#endif
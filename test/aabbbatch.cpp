@@ -0,0 +1,119 @@
+#include "math/geometry/AABBBatch.hpp"
+#include "math/geometry/intersect.hpp"
+#include "testutil.hpp"
+#include <cassert>
+#include <cstdlib>
+#include <cmath>
+#include <iostream>
+
+using namespace math;
+using namespace std;
+
+int main()
+{
+    // Two movers
+    {
+        // Head-on: gap of 8, closing at 20 per step
+        const AABBf a(0, 0, 2, 2), b(10, 0, 2, 2);
+        auto isec = sweep(a, Vec2f(10, 0), b, Vec2f(-10, 0));
+        assert(isec);
+        assert(fabs(isec.near - 0.4f) < 1e-6);
+        assert(isec.normal == Vec2f(-1, 0));
+        assert(fabs(isec.seg.p.x - 5) < 1e-5);      // a's center at entry
+
+        // Same direction and speed never meet
+        assert(!sweep(a, Vec2f(10, 0), b, Vec2f(10, 0)));
+
+        // Moving away
+        assert(!sweep(a, Vec2f(-10, 0), b, Vec2f(10, 0)));
+
+        // A static other is the same as the 3 argument version
+        auto stat = sweep(a, Vec2f(20, 0), b);
+        auto mov = sweep(a, Vec2f(20, 0), b, Vec2f());
+        assert(stat.near == mov.near && stat.far == mov.far && stat.normal == mov.normal);
+    }
+
+    // Batches match the single sweeps
+    {
+        srand(5);
+        const size_t n = 1000;
+        AABBBatch<float> as(n), bs(n);
+        for (size_t i = 0; i < n; ++i)
+        {
+            as.add(AABBf(frand(0, 50), frand(0, 50), frand(1, 5), frand(1, 5)), Vec2f(frand(-20, 20), frand(-20, 20)));
+            bs.add(AABBf(frand(0, 50), frand(0, 50), frand(1, 5), frand(1, 5)), Vec2f(frand(-20, 20), frand(-20, 20)));
+        }
+        // Some axis-aligned movers
+        as.set(0, as.get(0), Vec2f(10, 0));
+        bs.set(0, bs.get(0), Vec2f());
+        as.set(1, AABBf(0, 0, 1, 1), Vec2f(0, 10));
+        bs.set(1, AABBf(0.5, 5, 1, 1), Vec2f());
+
+        vector<float> near, far;
+        sweep(as, bs, &near, &far);
+        assert(near.size() == n && far.size() == n);
+
+        size_t hits = 0;
+        for (size_t i = 0; i < n; ++i)
+        {
+            auto isec = sweep(as.get(i), as.getVelocity(i), bs.get(i), bs.getVelocity(i));
+            if (isec)
+            {
+                assert(fabs(near[i] - isec.near) < 1e-4);
+                assert(fabs(far[i] - isec.far) < 1e-4);
+                ++hits;
+            }
+            else
+                assert(std::isinf(near[i]));
+        }
+        assert(hits > 10);
+        assert(!std::isinf(near[1]) && fabs(near[1] - 0.4f) < 1e-6);
+
+        // One against many
+        const AABBf bullet(25, 25, 0.5, 0.5);
+        const Vec2f vel(30, -15);
+        sweep(bullet, vel, bs, &near);
+        for (size_t i = 0; i < n; ++i)
+        {
+            auto isec = sweep(bullet, vel, bs.get(i), bs.getVelocity(i));
+            assert(isec ? fabs(near[i] - isec.near) < 1e-4 : std::isinf(near[i]));
+        }
+    }
+
+    // Integer coordinates hit borders and equal velocities exactly
+    {
+        srand(7);
+        const size_t n = 20000;
+        AABBBatch<float> as(n), bs(n);
+        as.add(AABBf(4, 4, 6, 5), Vec2f(3, -5));
+        bs.add(AABBf(0, -1, 4, 2), Vec2f(3, 1));
+        for (size_t i = 1; i < n; ++i)
+        {
+            as.add(AABBf(rand() % 10, rand() % 10, 1 + rand() % 6, 1 + rand() % 6),
+                   Vec2f(rand() % 11 - 5, rand() % 11 - 5));
+            bs.add(AABBf(rand() % 10, rand() % 10, 1 + rand() % 6, 1 + rand() % 6),
+                   Vec2f(rand() % 11 - 5, rand() % 11 - 5));
+        }
+
+        vector<float> near, far;
+        sweep(as, bs, &near, &far);
+        assert(std::isinf(near[0]));
+
+        size_t hits = 0;
+        for (size_t i = 0; i < n; ++i)
+        {
+            auto isec = sweep(as.get(i), as.getVelocity(i), bs.get(i), bs.getVelocity(i));
+            assert((bool)isec == !std::isinf(near[i]));
+            if (isec)
+            {
+                assert(fabs(near[i] - isec.near) < 1e-5);
+                assert(fabs(far[i] - isec.far) < 1e-5);
+                ++hits;
+            }
+        }
+        assert(hits > 100);
+    }
+
+    cout << "OK" << endl;
+    return 0;
+}
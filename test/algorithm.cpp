@@ -1,5 +1,6 @@
 #include "math/geometry/algorithm.hpp"
 #include <iostream>
+#include <cmath>
 
 using namespace math;
 using namespace std;
@@ -44,5 +45,75 @@ int main(int argc, char *argv[])
             assert(secondtrianglestrip.get(i) == trianglestrip.get(i));
     }
 
+    // Funnel algorithm
+    {
+        math::PointSet<float> strip, path(16);
+
+        // Straight corridor
+        Point2f straight[] = {
+            Point2f(0, 0), Point2f(0, 10), Point2f(10, 0),
+            Point2f(10, 10), Point2f(20, 0), Point2f(20, 10),
+        };
+        for (auto& p : straight)
+            strip.add(p);
+        funnelPath(strip, Point2f(1, 5), Point2f(19, 5), &path);
+        assert(path.size() == 2);
+        assert(path.get(0) == Point2f(1, 5) && path.get(1) == Point2f(19, 5));
+
+        // Bend around (10, 10) into the square above
+        Point2f bend[] = {
+            Point2f(0, 0), Point2f(0, 10), Point2f(10, 0), Point2f(10, 10),
+            Point2f(20, 10), Point2f(10, 20), Point2f(20, 20),
+        };
+        strip.clear();
+        for (auto& p : bend)
+            strip.add(p);
+        funnelPath(strip, Point2f(1, 1), Point2f(12, 19), &path);
+        assert(path.size() == 3);
+        assert(path.get(1) == Point2f(10, 10));
+
+        // Reversed direction passes the same corner
+        math::PointSet<float> reversed;
+        for (size_t i = strip.size(); i-- > 0;)
+            reversed.add(strip.get(i));
+        funnelPath(reversed, Point2f(12, 19), Point2f(1, 1), &path);
+        assert(path.size() == 3);
+        assert(path.get(1) == Point2f(10, 10));
+
+        // Two squares overlapping at x = 10, 10 <= y <= 20
+        Point2f steps[] = {
+            Point2f(0, 0), Point2f(10, 0), Point2f(10, 10), Point2f(20, 10),
+            Point2f(20, 30), Point2f(10, 30), Point2f(10, 20), Point2f(0, 20),
+        };
+        polygon.clear();
+        for (auto& p : steps)
+            polygon.add(p);
+        polygonToTriangleStrip(polygon, &strip);
+
+        funnelPath(strip, Point2f(1, 1), Point2f(19, 29), &path);
+        assert(path.size() == 2);
+
+        funnelPath(strip, Point2f(1, 1), Point2f(11, 29), &path);
+        assert(path.size() == 3);
+        assert(path.get(1) == Point2f(10, 20));
+
+        double length = 0;
+        for (size_t i = 1; i < path.size(); ++i)
+            length += (path.get(i) - path.get(i - 1)).abs();
+        assert(std::fabs(length - (std::sqrt(81.0 + 361.0) + std::sqrt(1.0 + 81.0))) < 1e-4);
+
+        reversed.clear();
+        for (size_t i = strip.size(); i-- > 0;)
+            reversed.add(strip.get(i));
+        funnelPath(reversed, Point2f(19, 29), Point2f(9, 1), &path);
+        assert(path.size() == 3);
+        assert(path.get(1) == Point2f(10, 10));
+
+        // Too few points
+        strip.clear();
+        funnelPath(strip, Point2f(1, 1), Point2f(2, 2), &path);
+        assert(path.size() == 2);
+    }
+
     return 0;
 }
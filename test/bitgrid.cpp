@@ -0,0 +1,73 @@
+#include "math/geometry/BitGrid.hpp"
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+
+using namespace math;
+using namespace std;
+
+int main(int argc, char *argv[])
+{
+    srand(42);
+
+    // Large enough for three levels
+    const int w = 150, h = 90;
+    Grid<bool> cells(w, h);
+    BitGrid grid(w, h);
+    assert(grid.getLevelCount() == 3);
+    assert(!grid.any(AABBi(0, 0, w, h)));
+
+    for (int i = 0; i < 300; ++i)
+    {
+        int x = rand() % w, y = rand() % h;
+        cells.at(x, y) = true;
+        grid.set(x, y);
+    }
+
+    // Clearing cells must update the summaries
+    for (int i = 0; i < 100; ++i)
+    {
+        int x = rand() % w, y = rand() % h;
+        cells.at(x, y) = false;
+        grid.set(x, y, false);
+    }
+
+    BitGrid assigned;
+    assigned.assign(cells);
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        AABBi rect(rand() % (w + 20) - 10, rand() % (h + 20) - 10, rand() % 40, rand() % 40);
+        size_t n = 0;
+        for (int y = rect.y; y < rect.y + rect.h; ++y)
+            for (int x = rect.x; x < rect.x + rect.w; ++x)
+                n += cells.get(x, y);
+
+        assert(grid.count(rect) == n);
+        assert(assigned.count(rect) == n);
+        assert(intersect(grid, rect) == (n > 0));
+    }
+    assert(grid.count() == assigned.count());
+
+    // Raycasts must match the dense grid
+    const Vec2f cs(4, 4);
+    for (int i = 0; i < 1000; ++i)
+    {
+        // Avoid end points on cell borders
+        Line2f seg(Point2f(rand() % (w * 4) + 0.3, rand() % (h * 4) + 0.6),
+                   Point2f(rand() % (w * 4) + 0.7, rand() % (h * 4) + 0.2), Segment);
+        Point2i c1, c2;
+        auto a = raycast(grid, cs, seg, &c1);
+        auto b = raycast(cells, cs, seg, &c2);
+
+        assert((bool)a == (bool)b);
+        if (a)
+        {
+            assert(c1 == c2);
+            assert(std::abs(a.time - b.time) < 1e-4);
+            assert(a.normal == b.normal);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,197 @@
+#include "math/geometry/OffsetPolygon.hpp"
+#include "math/geometry/round_intersect.hpp"
+#include "testutil.hpp"
+#include <cassert>
+#include <cstdlib>
+#include <cmath>
+#include <iostream>
+
+using namespace math;
+using namespace std;
+
+static bool contains(const Circled& c, const PointSet<double>& points, double eps = 1e-9)
+{
+    for (size_t i = 0; i < points.size(); ++i)
+        if ((points.get(i) - c.center).abs() > c.radius + eps)
+            return false;
+    return true;
+}
+
+// Point set that only implements the pure virtual functions
+class ArrayPointSet : public AbstractPointSet<double>
+{
+    public:
+        void add(const Point2d& point) override { points.push_back(point); }
+        void edit(size_t i, const Point2d& p) override { points[i] = p; }
+        void insert(size_t i, const Point2d& p) override { points.insert(points.begin() + i, p); }
+        void remove(size_t i) override { points.erase(points.begin() + i); }
+        void clear() override { points.clear(); }
+        size_t size() const override { return points.size(); }
+        Point2d get(size_t i) const override { return points[i]; }
+        AABB<double> getBBox() const override { return _calculateBBox(); }
+
+    public:
+        vector<Point2d> points;
+};
+
+int main()
+{
+    // Minimal circles compared to brute force over all pairs and triples
+    {
+        srand(5);
+        for (int i = 0; i < 100; ++i)
+        {
+            PointSet<double> points;
+            const size_t n = 1 + rand() % 15;
+            for (size_t k = 0; k < n; ++k)
+                points.add(Point2d(frand(-10, 10), frand(-5, 5)));
+
+            const Circled circle = Circled::fromPoints(points);
+            assert(contains(circle, points, 0));
+
+            double best = n == 1 ? 0 : 1e30;
+            for (size_t a = 0; a < n; ++a)
+                for (size_t b = a + 1; b < n; ++b)
+                {
+                    const Point2d pa = points.get(a), pb = points.get(b);
+                    Circled c(pa + (pb - pa) / 2, (pb - pa).abs() / 2);
+                    if (c.radius < best && contains(c, points))
+                        best = c.radius;
+
+                    for (size_t k = b + 1; k < n; ++k)
+                    {
+                        Point2d center;
+                        detail::circleFrom3(pa, pb, points.get(k), &center, &c.radius);
+                        c.center = center;
+                        if (c.radius < best && contains(c, points))
+                            best = c.radius;
+                    }
+                }
+            assert(fabs(circle.radius - best) < 1e-7);
+        }
+
+        // Collinear and duplicate points
+        PointSet<double> line;
+        line.add(Point2d(0, 0));
+        line.add(Point2d(4, 0));
+        line.add(Point2d(1, 0));
+        line.add(Point2d(4, 0));
+        const Circled c = Circled::fromPoints(line);
+        assert(fabs(c.radius - 2) < 1e-12 && fabs(c.center.x - 2) < 1e-12);
+
+        PointSet<float> single;
+        single.add(Point2f(3, 4));
+        assert(Circlef::fromPoints(single).radius == 0);
+        assert(Circlef::fromPoints(PointSet<float>()).radius == 0);
+    }
+
+    // Integer circles round the radius up
+    {
+        PointSet<int> points;
+        points.add(Point2i(0, 0));
+        points.add(Point2i(5, 0));
+        points.add(Point2i(0, 5));
+        const Circle<int> circle = Circle<int>::fromPoints(points);
+        for (size_t i = 0; i < points.size(); ++i)
+            assert((points.get(i) - circle.center).abs() <= circle.radius);
+    }
+
+    // Only cached circles are returned
+    {
+        ArrayPointSet points;
+        points.add(Point2d(-2, 1));
+        points.add(Point2d(4, 1));
+        points.add(Point2d(1, 2));
+        assert(!points.getBoundingCircle());
+        assert(!PointSet<double>().getBoundingCircle());
+        const Circled circle = Circled::fromPoints(points);
+        assert((circle.center - Point2d(1, 1)).abs() < 1e-9);
+        assert(fabs(circle.radius - 3) < 1e-9);
+    }
+
+    // Caching in polygons
+    {
+        OffsetPolygon<double> line;
+        line.add(Point2d(-1, 0));
+        line.add(Point2d(1, 0));
+        const Circled* circle = line.getBoundingCircle();
+        assert(circle && fabs(circle->radius - 1) < 1e-12);
+        line.add(Point2d(0, 0.5));     // Inside, stays valid
+        assert(fabs(line.getBoundingCircle()->radius - 1) < 1e-12);
+        line.add(Point2d(5, 0));
+        assert(fabs(line.getBoundingCircle()->radius - 3) < 1e-12);
+        line.remove(3);
+        assert(fabs(line.getBoundingCircle()->radius - 1) < 1e-12);
+
+        OffsetPolygon<double> pol;
+        pol.add(Point2d(0, 0));
+        pol.add(Point2d(4, 0));
+        pol.add(Point2d(4, 4));
+        pol.add(Point2d(0, 4));
+        circle = pol.getBoundingCircle();
+        assert(fabs(circle->radius - sqrt(8.0)) < 1e-12);
+        pol.move(Vec2d(10, 0));
+        circle = pol.getBoundingCircle();
+        assert(fabs(circle->center.x - 12) < 1e-12 && fabs(circle->center.y - 2) < 1e-12);
+        pol.edit(2, Point2d(20, 2));
+        circle = pol.getBoundingCircle();
+        assert(circle->radius > 5);
+        assert((Point2d(20, 2) - circle->center).abs() <= circle->radius);
+    }
+
+    // Used as an additional reject in polygon queries
+    {
+        OffsetPolygon<double> diamond;
+        diamond.add(Point2d(0, -5));
+        diamond.add(Point2d(5, 0));
+        diamond.add(Point2d(0, 5));
+        diamond.add(Point2d(-5, 0));
+
+        // Passes through the AABB's corner, but misses the circle
+        const Line2d corner(Point2d(3, 6), Point2d(6, 3));
+        assert(intersect(corner, diamond.getBBox()));
+        assert(corner.distance(Point2d(0, 0)) > diamond.getBoundingCircle()->radius);
+        assert(!intersect(corner, diamond));
+        assert(intersect(Line2d(Point2d(-6, 0.5), Point2d(6, 0.5)), diamond));
+
+        OffsetPolygon<float> diamondf;
+        for (size_t i = 0; i < diamond.size(); ++i)
+            diamondf.add(diamond.get(i));
+        assert(!sweep(AABBf(3.5, 6, 1, 1), Vec2f(3, -3), diamondf));
+        assert(sweep(AABBf(-10, -0.5, 1, 1), Vec2f(20, 0), diamondf));
+
+        assert(!intersect(Circled(4.5, 4.5, 1), diamond));
+        assert(intersect(Circled(3, 3, 1), diamond));
+        assert(!sweep(Circled(3.5, 6, 0.5), Vec2d(3, -3), diamond));
+        assert(sweep(Circled(-10, 0, 0.5), Vec2d(20, 0), diamond));
+        assert(sweep(Capsuled(Point2d(-10, 8), Point2d(10, 8), 0.5), Vec2d(0, -4), diamond));
+        assert(!sweep(Capsuled(Point2d(8, 3), Point2d(3, 8), 0.5), Vec2d(1, 1), diamond));
+    }
+
+    // The circle reject must not drop float lines touching it at a vertex
+    {
+        srand(9);
+        for (int i = 0; i < 500; ++i)
+        {
+            const Point2d center(frand(-1000, 1000), frand(-1000, 1000));
+            const double r = frand(0.5, 50), start = frand(0, 6.283);
+            OffsetPolygon<float> tri;
+            for (int k = 0; k < 3; ++k)
+                tri.add(Point2f(center + Vec2d(r * cos(start + 2.094 * k), r * sin(start + 2.094 * k))));
+
+            const Circlef circle = *tri.getBoundingCircle();
+            for (size_t k = 0; k < tri.size(); ++k)
+            {
+                const Point2f v = tri.get(k);
+                Vec2f tangent = v - circle.center;
+                tangent.rotate_rad(M_PI / 2);
+                const Line2f line(v - tangent, v + tangent, Segment);
+                if (intersect(line, tri.getBBox()))
+                    assert((bool)intersect(line, tri) == (bool)findNearest(line, tri));
+            }
+        }
+    }
+
+    cout << "OK" << endl;
+    return 0;
+}
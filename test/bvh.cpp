@@ -0,0 +1,109 @@
+#include "math/geometry/BVH.hpp"
+#include <cassert>
+#include <cstdlib>
+#include <algorithm>
+
+using namespace math;
+using namespace std;
+
+int main(int argc, char *argv[])
+{
+    srand(11);
+
+    BVH<float> empty;
+    vector<size_t> result, expected;
+    empty.query(AABBf(0, 0, 10, 10), &result);
+    assert(result.empty());
+    assert(!empty.raycast(Line2f(Point2f(), Point2f(10, 10), Segment)));
+
+    // Duplicates stress the Morton code tie breaking
+    vector<AABBf> boxes;
+    for (int i = 0; i < 5000; ++i)
+    {
+        float size = rand() % 20 == 0 ? rand() % 100 + 1 : rand() % 5 + 1;
+        boxes.push_back(AABBf(rand() % 1000, rand() % 1000, size, size));
+    }
+    for (int i = 0; i < 100; ++i)
+        boxes.push_back(AABBf(500, 500, 2, 2));
+
+    BVH<float> bvh(boxes, 4), serial(boxes, 1);
+    assert(bvh.size() == boxes.size());
+    assert(bvh.getNodes().size() == boxes.size() * 2 - 1);
+
+    // The root covers everything
+    const AABBf& root = bvh.getNodes()[0].bbox;
+    for (auto& b : boxes)
+        assert(root.pos <= b.pos && b.pos + b.size <= root.pos + root.size);
+
+    for (int i = 0; i < 300; ++i)
+    {
+        AABBf range(rand() % 1000, rand() % 1000, rand() % 100, rand() % 100);
+        bvh.query(range, &result);
+        expected.clear();
+        for (size_t j = 0; j < boxes.size(); ++j)
+        {
+            auto& b = boxes[j];
+            if (b.x <= range.x + range.w && range.x <= b.x + b.w && b.y <= range.y + range.h && range.y <= b.y + b.h)
+                expected.push_back(j);
+        }
+        sort(result.begin(), result.end());
+        assert(result == expected);
+
+        serial.query(range, &result);
+        sort(result.begin(), result.end());
+        assert(result == expected);
+
+        Point2f p(rand() % 1000 + 0.5f, rand() % 1000 + 0.5f);
+        bvh.query(p, &result);
+        expected.clear();
+        for (size_t j = 0; j < boxes.size(); ++j)
+            if (intersect(boxes[j], p))
+                expected.push_back(j);
+        sort(result.begin(), result.end());
+        assert(result == expected);
+
+        // Ray and sweep against brute force
+        Line2f ray(Point2f(rand() % 1200 - 100, rand() % 1200 - 100),
+                   Point2f(rand() % 1200 - 100, rand() % 1200 - 100), Segment);
+        AABBf mover(ray.p.x, ray.p.y, 3, 7);
+        Intersection<float> nearestray, nearestsweep;
+        for (auto& b : boxes)
+        {
+            auto isec = intersect(ray, b);
+            if (isec && (!nearestray || isec.time < nearestray.time))
+                nearestray = isec;
+            isec = sweep(mover, ray.d, b);
+            if (isec && (!nearestsweep || isec.time < nearestsweep.time))
+                nearestsweep = isec;
+        }
+
+        size_t index;
+        auto isec = bvh.raycast(ray, &index);
+        assert((bool)isec == (bool)nearestray);
+        if (isec)
+            assert(isec.time == nearestray.time && intersect(ray, boxes[index]).time == isec.time);
+
+        isec = bvh.sweep(mover, ray.d, &index);
+        assert((bool)isec == (bool)nearestsweep);
+        if (isec)
+            assert(isec.time == nearestsweep.time && sweep(mover, ray.d, boxes[index]).time == isec.time);
+    }
+
+    // Exponentially spaced boxes give the deepest trees
+    vector<AABBf> chain;
+    for (int i = 0; i < 2000; ++i)
+        chain.push_back(AABBf(std::ldexp(1.f, i % 120 - 60), 0, std::ldexp(1.f, i % 120 - 60), 1));
+    BVH<float> deep(chain);
+    for (size_t i = 0; i < chain.size(); i += 97)
+    {
+        deep.query(Point2f(chain[i].x * 1.5f, 0.5f), &result);
+        assert(std::find(result.begin(), result.end(), i) != result.end());
+    }
+
+    // Single box
+    BVH<float> single(vector<AABBf>(1, AABBf(0, 0, 1, 1)));
+    single.query(Point2f(0.5, 0.5), &result);
+    assert(result.size() == 1 && result[0] == 0);
+
+    return 0;
+}
@@ -0,0 +1,128 @@
+#include "math/geometry/contact.hpp"
+#include "math/geometry/intersect.hpp"
+#include "math/geometry/OffsetPolygon.hpp"
+#include <cassert>
+#include <cmath>
+#include <iostream>
+
+using namespace math;
+using namespace std;
+
+typedef OffsetPolygon<float> PolygonT;
+
+static bool near(const Point2f& a, const Point2f& b)
+{
+    return (a - b).abs() < 1e-4;
+}
+
+int main()
+{
+    // AABB vs AABB
+    {
+        const AABBf a(0, 0, 10, 10),
+                    b(8, 2, 10, 4);
+        auto m = collide(a, b);
+        assert(m.count == 2);
+        assert(m.normal == intersect(a, b).normal);
+        assert(m.normal == Vec2f(-1, 0));
+        for (size_t i = 0; i < 2; ++i)
+        {
+            assert(fabs(m.points[i].depth - 2) < 1e-5);
+            assert(m.points[i].p.x == 8);
+        }
+        assert(m.points[0].id != m.points[1].id);
+
+        // Ids stay the same while the same features touch
+        auto m2 = collide(a, AABBf(8.5, 2.5, 10, 4));
+        assert(m2.count == 2);
+        assert(m2.points[0].id == m.points[0].id && m2.points[1].id == m.points[1].id);
+
+        // Clipped to the reference edge
+        auto m3 = collide(a, AABBf(8, 8, 10, 4));
+        assert(m3.count == 2);
+        assert(m3.normal == Vec2f(-1, 0) || m3.normal == Vec2f(0, -1));
+
+        // Swapped arguments flip the normal
+        auto m4 = collide(b, a);
+        assert(m4.count == 2);
+        assert(m4.normal == Vec2f(1, 0));
+
+        // Touching and separated
+        auto touch = collide(a, AABBf(10, 0, 5, 5));
+        assert(touch.count == 2);
+        assert(touch.points[0].depth == 0 && touch.points[1].depth == 0);
+        assert(!collide(a, AABBf(11, 0, 5, 5)));
+    }
+
+    // Box resting on a box, polygon vs AABB and back
+    {
+        PolygonT box;
+        box.add(Point2f(0, 0));
+        box.add(Point2f(0, 4));
+        box.add(Point2f(4, 4));
+        box.add(Point2f(4, 0));     // Clockwise in y-up
+        box.setOffset(Vec2f(3, 9.5));
+
+        const AABBf ground(0, 0, 10, 10);
+        auto m = collide(box, ground);
+        assert(m.count == 2);
+        assert(m.normal == Vec2f(0, 1));
+        assert(near(m.points[0].p, Point2f(7, 10)) || near(m.points[0].p, Point2f(3, 10)));
+        assert(fabs(m.points[0].depth - 0.5) < 1e-5 && fabs(m.points[1].depth - 0.5) < 1e-5);
+
+        auto m2 = collide(ground, box);
+        assert(m2.count == 2);
+        assert(m2.normal == Vec2f(0, -1));
+    }
+
+    // Diamond corner poking into a box
+    {
+        PolygonT diamond;
+        diamond.add(Point2f(0, -2));
+        diamond.add(Point2f(2, 0));
+        diamond.add(Point2f(0, 2));
+        diamond.add(Point2f(-2, 0));
+        diamond.setOffset(Vec2f(5, 11.5));
+
+        PolygonT box;
+        box.add(Point2f(0, 0));
+        box.add(Point2f(10, 0));
+        box.add(Point2f(10, 10));
+        box.add(Point2f(0, 10));
+
+        auto m = collide(diamond, box);
+        assert(m.count == 1);
+        assert(m.normal == Vec2f(0, 1));
+        assert(near(m.points[0].p, Point2f(5, 9.5)));
+        assert(fabs(m.points[0].depth - 0.5) < 1e-5);
+
+        // Resolving the contact separates the shapes
+        diamond.setOffset(diamond.getOffset() + m.normal * (m.points[0].depth + 0.01f));
+        assert(!collide(diamond, box));
+    }
+
+    // Polygons with more vertices than the inline storage
+    {
+        const float r = 2, pi = 3.14159265f;
+        const float cy = 9.9f + r * cos(pi / 16);
+        PolygonT gon;
+        for (int i = 15; i >= 0; --i)     // Clockwise in y-up
+        {
+            const float angle = -pi / 2 + pi / 16 + i * pi / 8;
+            gon.add(Point2f(5 + r * cos(angle), cy + r * sin(angle)));
+        }
+
+        AABB<float> box(0, 0, 10, 10);
+        auto m = collide(gon, box);
+        assert(m.count == 2);
+        assert(near(m.normal.asPoint(), Point2f(0, 1)));
+        for (size_t i = 0; i < m.count; ++i)
+            assert(fabs(m.points[i].depth - 0.1) < 1e-4);
+
+        m = collide(box, gon);
+        assert(m.count == 2 && near(m.normal.asPoint(), Point2f(0, -1)));
+    }
+
+    cout << "OK" << endl;
+    return 0;
+}
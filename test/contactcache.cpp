@@ -0,0 +1,151 @@
+#include "math/geometry/ContactCache.hpp"
+#include "math/geometry/OffsetPolygon.hpp"
+#include "testutil.hpp"
+#include <cassert>
+#include <cstdlib>
+#include <cmath>
+#include <iostream>
+
+using namespace math;
+using namespace std;
+
+typedef OffsetPolygon<float> PolygonT;
+
+// The cache works in local coordinates, so positions may differ by rounding
+static bool equal(const Manifold<float>& a, const Manifold<float>& b)
+{
+    if (a.count != b.count || (a.count > 0 && (a.normal - b.normal).abs() > 1e-5))
+        return false;
+    for (size_t i = 0; i < a.count; ++i)
+        if ((a.points[i].p - b.points[i].p).abs() > 1e-4 || std::abs(a.points[i].depth - b.points[i].depth) > 1e-4
+                || a.points[i].id != b.points[i].id)
+            return false;
+    return true;
+}
+
+int main()
+{
+    // Revisions
+    {
+        PointSet<float> set;
+        const size_t rev = set.getRevision();
+        assert(rev != 0);
+        set.add(Point2f(1, 2));
+        assert(set.getRevision() != rev);
+
+        PolygonT pol;
+        pol.add(Point2f(0, 0));
+        const size_t polrev = pol.getRevision();
+        pol.setOffset(Vec2f(1, 1));
+        assert(pol.getRevision() != polrev);
+    }
+
+    // Same results as collide() on moving shapes
+    {
+        srand(3);
+        vector<PolygonT> shapes(12);
+        for (auto& pol : shapes)
+        {
+            // Random convex polygon with 3 to 8 vertices
+            const size_t n = 3 + rand() % 6;
+            const float r = frand(1, 3),
+                        start = frand(0, 6.283f);
+            for (size_t i = 0; i < n; ++i)
+            {
+                const float angle = start + 6.283f * i / n;
+                pol.add(Point2f(r * cos(angle), r * sin(angle)));
+            }
+            pol.setOffset(Vec2f(frand(0, 20), frand(0, 20)));
+        }
+
+        ContactCache<float> cache;
+        size_t contacts = 0;
+        for (int frame = 0; frame < 200; ++frame)
+        {
+            for (size_t i = 0; i < shapes.size(); ++i)
+            {
+                // Keep some shapes still to test cached vertices
+                if (i % 3 != 0)
+                    shapes[i].move(Vec2f(frand(-0.3f, 0.3f), frand(-0.3f, 0.3f)));
+                for (size_t j = 0; j < i; ++j)
+                {
+                    // Alternate the argument order
+                    const bool swap = (frame + i + j) % 2 == 0;
+                    const PolygonT& a = swap ? shapes[j] : shapes[i];
+                    const PolygonT& b = swap ? shapes[i] : shapes[j];
+                    auto m = cache.collide(swap ? j : i, a, swap ? i : j, b);
+                    assert(equal(m, collide<float>(a, b)));
+                    contacts += m.count;
+                }
+            }
+        }
+        assert(contacts > 0);
+        assert(cache.getShapeCount() == shapes.size());
+        assert(cache.getPairCount() == shapes.size() * (shapes.size() - 1) / 2);
+
+        cache.remove(0);
+        assert(cache.getShapeCount() == shapes.size() - 1);
+        assert(cache.getPairCount() == (shapes.size() - 1) * (shapes.size() - 2) / 2);
+
+        cache.clear();
+        assert(cache.getShapeCount() == 0 && cache.getPairCount() == 0);
+    }
+
+    // Overlapping pairs with collinear vertices keep matching while moving
+    {
+        PolygonT ground, box;
+        makeBox(&ground, 0, 0, 20, 2);
+        box.add(Point2f(0, 0));
+        box.add(Point2f(1, 0));
+        box.add(Point2f(2, 0));
+        box.add(Point2f(2, 2));
+        box.add(Point2f(0, 2));
+        box.setOffset(Vec2f(1, 1.5f));
+
+        ContactCache<float> cache;
+        for (int frame = 0; frame < 100; ++frame)
+        {
+            box.move(Vec2f(0.17f, frame % 2 == 0 ? 0.01f : -0.01f));
+            auto m = cache.collide(0, ground, 1, box);
+            assert(m.count == 2);
+            assert(equal(m, collide<float>(ground, box)));
+        }
+    }
+
+    // Vertex edits are picked up
+    {
+        PolygonT a, b;
+        a.add(Point2f(0, 0));
+        a.add(Point2f(4, 0));
+        a.add(Point2f(4, 4));
+        a.add(Point2f(0, 4));
+        b.add(Point2f(5, 0));
+        b.add(Point2f(9, 0));
+        b.add(Point2f(9, 4));
+        b.add(Point2f(5, 4));
+
+        ContactCache<float> cache;
+        assert(!cache.collide(0, a, 1, b));
+        b.edit(0, Point2f(3, 0));
+        b.edit(3, Point2f(3, 4));
+        auto m = cache.collide(0, a, 1, b);
+        assert(m.count == 2);
+        assert(equal(m, collide<float>(a, b)));
+
+        // Assigning a polygon with the same edit count must not keep
+        // the cached vertices
+        PolygonT c;
+        c.add(Point2f(10, 0));
+        c.add(Point2f(14, 0));
+        c.add(Point2f(14, 4));
+        c.add(Point2f(10, 4));
+        c.edit(0, Point2f(10, 0));
+        c.edit(3, Point2f(10, 4));
+        b = c;
+        assert(!cache.collide(0, a, 1, b));
+        assert(equal(cache.collide(0, a, 1, b), collide<float>(a, b)));
+    }
+
+    cout << "OK" << endl;
+    return 0;
+}
@@ -0,0 +1,88 @@
+#include "math/geometry/contour.hpp"
+#include "testutil.hpp"
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+
+using namespace math;
+using namespace std;
+
+int main(int argc, char *argv[])
+{
+    // 6x6 block with a 2x2 hole, and a separate single tile
+    Grid<bool> grid(12, 10);
+    for (int y = 1; y < 7; ++y)
+        for (int x = 1; x < 7; ++x)
+            grid.at(x, y) = !(x >= 3 && x < 5 && y >= 3 && y < 5);
+    grid.at(9, 8) = true;
+
+    vector<Contour<float>> contours;
+    extractContours(grid, &contours, Vec2f(2, 2));
+    assert(contours.size() == 3 && "Wrong number of contours");
+
+    size_t holes = 0;
+    for (size_t i = 0; i < contours.size(); ++i)
+    {
+        auto& c = contours[i];
+        cout<<"contour "<<i<<": "<<c.outline.size()<<" vertices, area "<<area(c.outline)<<", hole "<<c.hole<<endl;
+        assert(c.outline.size() == 4 && "Collinear vertices should be merged");
+
+        if (c.hole)
+        {
+            ++holes;
+            assert(std::abs(area(c.outline) - 16) < 1e-4);
+            assert(!contours[c.parent].hole);
+            assert(std::abs(area(contours[c.parent].outline) + 144) < 1e-4 && "Wrong parent");
+        }
+        else
+            assert(c.parent == i);
+    }
+    assert(holes == 1);
+
+    // Diagonal neighbours must not be connected
+    Grid<int> diag(2, 2);
+    diag.at(0, 0) = diag.at(1, 1) = 1;
+    extractContours(diag, &contours);
+    assert(contours.size() == 2 && "Diagonal cells should be separate");
+
+    // Threaded and serial results must be identical
+    Grid<bool> noise(97, 61);
+    srand(1);
+    for (size_t y = 0; y < noise.getHeight(); ++y)
+        for (size_t x = 0; x < noise.getWidth(); ++x)
+            noise.at(x, y) = rand() % 3 == 0;
+
+    vector<Contour<float>> serial, threaded;
+    extractContours(noise, &serial, Vec2f(1), Point2f(), 1);
+    extractContours(noise, &threaded, Vec2f(1), Point2f(), 4);
+    assert(serial.size() == threaded.size());
+    for (size_t i = 0; i < serial.size(); ++i)
+    {
+        assert(serial[i].outline.size() == threaded[i].outline.size());
+        for (size_t k = 0; k < serial[i].outline.size(); ++k)
+            assert(serial[i].outline.get(k) == threaded[i].outline.get(k));
+    }
+
+    // Circle iso line
+    Grid<float> field(41, 41);
+    for (int y = 0; y < 41; ++y)
+        for (int x = 0; x < 41; ++x)
+            field.at(x, y) = -Vec2f(x - 20, y - 20).abs();
+
+    extractIsoContours(field, -10.f, &contours, Vec2f(1), Point2f(), 4);
+    assert(contours.size() == 1 && !contours[0].hole);
+    for (size_t i = 0; i < contours[0].outline.size(); ++i)
+    {
+        double r = (contours[0].outline.get(i) - Point2f(20, 20)).abs();
+        assert(std::abs(r - 10) < 0.1 && "Vertex not on the iso line");
+    }
+    cout<<"iso contour: "<<contours[0].outline.size()<<" vertices, area "<<area(contours[0].outline)<<endl;
+    assert(std::abs(-area(contours[0].outline) - M_PI * 100) < 2);
+
+    // Fields touching the border are closed along the border
+    Grid<float> full(5, 5, 1.f);
+    extractIsoContours(full, 0.5f, &contours);
+    assert(contours.size() == 1 && contours[0].outline.size() == 4);
+
+    return 0;
+}
@@ -0,0 +1,152 @@
+#include "math/geometry/Delaunay.hpp"
+#include "math/geometry/OffsetPolygon.hpp"
+#include "math/geometry/mesh_intersect.hpp"
+#include <cassert>
+#include <cstdlib>
+#include <cmath>
+
+using namespace math;
+using namespace std;
+
+static double orient(const Point2f& a, const Point2f& b, const Point2f& c)
+{
+    return (double)(b.x - a.x) * (c.y - a.y) - (double)(b.y - a.y) * (c.x - a.x);
+}
+
+// Checks mesh consistency and the (constrained) Delaunay property
+static void check(const Delaunay<float>& d)
+{
+    auto& tris = d.getTriangles();
+    auto& he = d.getHalfedges();
+    auto& pts = d.getPoints();
+
+    for (size_t e = 0; e < tris.size(); ++e)
+    {
+        size_t next = e % 3 == 2 ? e - 2 : e + 1,
+               prev = e % 3 == 0 ? e + 2 : e - 1;
+
+        // Clockwise in a y-up system
+        if (e % 3 == 0)
+            assert(orient(pts[tris[e]], pts[tris[e + 1]], pts[tris[e + 2]]) < 0);
+
+        if (he[e] == Delaunay<float>::npos)
+            continue;
+
+        size_t o = he[e],
+               onext = o % 3 == 2 ? o - 2 : o + 1,
+               oprev = o % 3 == 0 ? o + 2 : o - 1;
+        assert(he[o] == e);
+        assert(tris[o] == tris[next] && tris[onext] == tris[e]);
+        assert(d.isConstrained(e) == d.isConstrained(o));
+
+        if (d.isConstrained(e))
+            continue;
+
+        // The opposite point must not be inside the circumcircle
+        Point2d a = pts[tris[e]], b = pts[tris[next]], c = pts[tris[prev]], p = pts[tris[oprev]];
+        Point2d center;
+        double r = detail::delaunayCircumradius(a, b, c, &center);
+        assert((p - center).abs_sqr() >= r * (1 - 1e-9));
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    srand(99);
+
+    // Random points with duplicates
+    PointSet<float> points;
+    for (int i = 0; i < 500; ++i)
+        points.add(Point2f(rand() % 1000, rand() % 1000));
+    points.add(points.get(10));
+
+    Delaunay<float> d(points);
+    check(d);
+
+    // Euler: 2n - h - 2 triangles for n unique points and h hull points
+    size_t hull = 0;
+    for (size_t h : d.getHalfedges())
+        hull += h == Delaunay<float>::npos;
+    assert(d.size() == 2 * 500 - hull - 2);
+
+    // Compatible with mesh_intersect
+    PointSet<float> mesh;
+    d.toTriangles(&mesh);
+    assert(mesh.size() == d.size() * 3);
+    Vec2f centroid = (mesh.get(0).asVector() + mesh.get(1).asVector() + mesh.get(2).asVector()) / 3.f;
+    assert(intersectTriangles(centroid.asPoint(), mesh));
+    assert(!intersectTriangles(Point2f(-10, -10), mesh));
+
+    // Collinear points only
+    PointSet<float> line;
+    for (int i = 0; i < 10; ++i)
+        line.add(Point2f(i, i * 2));
+    Delaunay<float> degenerate(line);
+    assert(degenerate.size() == 0);
+
+    // Regular grid (cocircular points) with constraints running through
+    // grid points, which must be split.
+    PointSet<float> grid;
+    for (int y = 0; y < 10; ++y)
+        for (int x = 0; x < 10; ++x)
+            grid.add(Point2f(x, y));
+    Delaunay<float> g(grid);
+    check(g);
+    assert(g.size() == 2 * 9 * 9);
+    assert(g.addConstraint(0, 99));     // Diagonal through 8 points
+    assert(!g.addConstraint(9, 90));    // Crosses the diagonal between grid points
+    assert(g.addConstraint(2, 20));     // Touches the diagonal at a grid point
+    check(g);
+    for (int i = 0; i < 9; ++i)
+    {
+        size_t e = g.findEdge(i * 11, i * 11 + 11);
+        assert(e != Delaunay<float>::npos && g.isConstrained(e));
+    }
+    assert(!g.addConstraint(1, 10) || g.isConstrained(g.findEdge(1, 10)));
+
+    // Polygon outlines as constraints
+    OffsetPolygon<float> star, box;
+    for (int i = 0; i < 20; ++i)
+    {
+        float r = i % 2 ? 20 : 50;
+        float a = i * 2 * M_PI / 20;
+        star.add(Point2f(100 + std::cos(a) * r, 100 + std::sin(a) * r));
+    }
+    box.add(Point2f(0, 0));
+    box.add(Point2f(200, 0));
+    box.add(Point2f(200, 200));
+    box.add(Point2f(0, 200));
+
+    vector<const AbstractPolygon<float>*> polygons;
+    polygons.push_back(&star);
+    polygons.push_back(&box);
+    Delaunay<float> cdt;
+    cdt.triangulate(polygons);
+    check(cdt);
+    for (int i = 0; i < 20; ++i)
+    {
+        size_t e = cdt.findEdge(i, (i + 1) % 20);
+        assert(e != Delaunay<float>::npos && cdt.isConstrained(e));
+    }
+
+    // Random constraints on a larger set
+    PointSet<float> many;
+    for (int i = 0; i < 2000; ++i)
+        many.add(Point2f(rand() % 10000 / 10.f, rand() % 10000 / 10.f));
+    Delaunay<float> big(many);
+    size_t inserted = 0;
+    for (int i = 0; i < 50; ++i)
+    {
+        size_t a = rand() % 2000, b = rand() % 2000;
+        if (big.addConstraint(a, b) && a != b)
+        {
+            ++inserted;
+            size_t e = big.findEdge(a, b);
+            assert(e == Delaunay<float>::npos || big.isConstrained(e));
+        }
+    }
+    assert(inserted > 0);
+    check(big);
+
+    return 0;
+}
@@ -0,0 +1,132 @@
+#include "math/geometry/gridtraversal.hpp"
+#include <cassert>
+#include <cstdlib>
+#include <cmath>
+#include <iostream>
+
+using namespace math;
+using namespace std;
+
+int main(int argc, char *argv[])
+{
+    srand(42);
+    const Vec2f cs(2, 2);
+
+    // Traversal order
+    {
+        vector<Point2i> cells;
+        vector<Vec2f> normals;
+        float last = 0;
+        traverseGrid(Line2f(Point2f(1, 1), Point2f(6, 4), Segment), cs,
+                [&](const Point2i& c, const Intersection<float>& isec) {
+                    assert(isec.near >= last && isec.far >= isec.near);
+                    last = isec.far;
+                    cells.push_back(c);
+                    normals.push_back(isec.normal);
+                    return false;
+                });
+        const Point2i expected[] = { Point2i(0, 0), Point2i(1, 0), Point2i(1, 1), Point2i(2, 1) };
+        assert(cells.size() == 4);
+        for (size_t i = 0; i < cells.size(); ++i)
+            assert(cells[i] == expected[i]);
+        assert(normals[0] == Vec2f());
+        assert(normals[1] == Vec2f(-1, 0));
+        assert(normals[2] == Vec2f(0, -1));
+        assert(normals[3] == Vec2f(-1, 0));
+        assert(last == 1);
+
+        // maxcells bounds rays
+        size_t n = 0;
+        traverseGrid(Line2f(Point2f(1, 1), Vec2f(1, 0.3), Ray), cs,
+                [&](const Point2i&, const Intersection<float>&) { ++n; return false; }, 10);
+        assert(n == 10);
+    }
+
+    Grid<int> grid(10, 8);
+    grid.at(5, 3) = 1;
+
+    // Single raycast
+    {
+        Point2i cell;
+        auto hit = raycast(grid, cs, Line2f(Point2f(1, 7), Point2f(19, 7), Segment), &cell);
+        assert(hit && cell == Point2i(5, 3));
+        assert(hit.normal == Vec2f(-1, 0));
+        assert(std::abs(hit.near - 9.f / 18) < 1e-5);
+
+        // Segment miss
+        assert(!raycast(grid, cs, Line2f(Point2f(1, 1), Point2f(19, 1), Segment)));
+        assert(!raycast(grid, cs, Line2f(Point2f(1, 7), Point2f(9, 7), Segment)));
+
+        // Rays and lines that miss end at the grid's border
+        assert(!raycast(grid, cs, Line2f(Point2f(1, 1), Vec2f(1, 0), Ray)));
+        assert(!raycast(grid, cs, Line2f(Point2f(1, 1), Vec2f(1, 0.01), Line)));
+        assert(!raycast(grid, cs, Line2f(Point2f(-100, -100), Vec2f(-1, 0.5), Ray)));
+        assert(!raycast(grid, cs, Line2f(Point2f(11, 1), Vec2f(-1, 0), Ray)));
+
+        // Rays starting outside the grid enter through its border
+        hit = raycast(grid, cs, Line2f(Point2f(-1000, 7), Vec2f(1, 0), Ray), &cell);
+        assert(hit && cell == Point2i(5, 3));
+        assert(hit.normal == Vec2f(-1, 0));
+        assert(std::abs(hit.near - 1010) < 1e-2);
+
+        grid.at(0, 3) = 1;
+        hit = raycast(grid, cs, Line2f(Point2f(-1000, 7), Vec2f(1, 0), Ray), &cell);
+        assert(hit && cell == Point2i(0, 3));
+        assert(hit.normal == Vec2f(-1, 0));
+        assert(std::abs(hit.near - 1000) < 1e-2);
+
+        // Lines extend backwards
+        hit = raycast(grid, cs, Line2f(Point2f(30, 7), Vec2f(1, 0), Line), &cell);
+        assert(hit && cell == Point2i(0, 3));
+        assert(hit.near < 0);
+        grid.at(0, 3) = 0;
+    }
+
+    // Batch raycast matches the single raycast
+    for (int i = 0; i < 100; ++i)
+        grid.at(rand() % 10, rand() % 8) = 1;
+
+    // Avoid end points on cell borders
+    vector<Line2f> segs;
+    for (int i = 0; i < 500; ++i)
+        segs.push_back(Line2f(Point2f(rand() % 240 / 10.f - 1.95f, rand() % 200 / 10.f - 1.95f),
+                              Point2f(rand() % 240 / 10.f - 1.95f, rand() % 200 / 10.f - 1.95f), Segment));
+
+    vector<float> times;
+    raycast(grid, cs, segs, &times);
+    assert(times.size() == segs.size());
+    size_t hits = 0;
+    for (size_t i = 0; i < segs.size(); ++i)
+    {
+        auto hit = raycast(grid, cs, segs[i]);
+        assert((bool)hit == (times[i] <= 1));
+        if (hit)
+        {
+            assert(std::abs(hit.near - times[i]) < 1e-4);
+            ++hits;
+        }
+    }
+    assert(hits > 0 && hits < segs.size());
+
+    // Batch raycast with integer segments leaving the grid
+    {
+        Grid<int> igrid(8, 8);
+        const Vec2i ics(1, 1);
+        vector<Line2i> isegs;
+        isegs.push_back(Line2i(Point2i(4, 4), Vec2i(20, 0), Segment));
+        isegs.push_back(Line2i(Point2i(-10, 2), Vec2i(20, 0), Segment));
+        isegs.push_back(Line2i(Point2i(-10, -10), Vec2i(-5, 3), Segment));
+        vector<int> itimes;
+        raycast(igrid, ics, isegs, &itimes);
+        assert(itimes[0] > 1 && itimes[1] > 1 && itimes[2] > 1);
+
+        igrid.at(6, 2) = 1;
+        raycast(igrid, ics, isegs, &itimes);
+        assert(itimes[0] > 1 && itimes[1] <= 1 && itimes[2] > 1);
+        for (size_t i = 0; i < isegs.size(); ++i)
+            assert((bool)raycast(igrid, ics, isegs[i]) == (itimes[i] <= 1));
+    }
+
+    cout << "OK" << endl;
+    return 0;
+}
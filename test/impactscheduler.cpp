@@ -0,0 +1,124 @@
+#include "math/geometry/ImpactScheduler.hpp"
+#include "testutil.hpp"
+#include <cassert>
+#include <cstdlib>
+#include <cmath>
+#include <iostream>
+
+using namespace math;
+using namespace std;
+
+typedef ImpactScheduler<double> Scheduler;
+
+// Penetration depth of two AABBs, <= 0 if they don't overlap
+static double overlap(const AABB<double>& a, const AABB<double>& b)
+{
+    const double x = std::min(a.x + a.w, b.x + b.w) - std::max(a.x, b.x),
+                 y = std::min(a.y + a.h, b.y + b.h) - std::max(a.y, b.y);
+    return std::min(x, y);
+}
+
+int main()
+{
+    const AABB<double> bounds(0, 0, 100, 100);
+
+    // Fast bullet against a thin wall, bouncing back
+    {
+        Scheduler scheduler(bounds);
+        auto bullet = scheduler.add(AABB<double>(0, 0, 1, 1), Vec2d(100, 0));
+        auto wall = scheduler.add(AABB<double>(50, -10, 0.1, 20));
+
+        size_t impacts = 0;
+        const double end = scheduler.step([&](Scheduler::Handle a, Scheduler::Handle b, double time, const Vec2d& normal) {
+            assert((a == bullet && b == wall) || (a == wall && b == bullet));
+            assert(fabs(time - 0.49) < 1e-9);
+            assert(normal.x != 0 && normal.y == 0);
+            scheduler.setVelocity(bullet, -scheduler.getVelocity(bullet));
+            ++impacts;
+        });
+        assert(end == 1);
+        assert(impacts == 1);
+        assert(fabs(scheduler.get(bullet).x - (49 - 51)) < 1e-9);
+        assert(scheduler.getVelocity(bullet) == Vec2d(-100, 0));
+    }
+
+    // Unresolved impacts stop both objects
+    {
+        Scheduler scheduler(bounds);
+        auto a = scheduler.add(AABB<double>(0, 0, 1, 1), Vec2d(10, 0));
+        auto b = scheduler.add(AABB<double>(5, 0, 1, 1), Vec2d(-2, 0));
+        scheduler.step([](Scheduler::Handle, Scheduler::Handle, double, const Vec2d&) { });
+        assert(fabs(scheduler.get(a).x + 1 - scheduler.get(b).x) < 1e-9);
+        assert(scheduler.getVelocity(a) == Vec2d() && scheduler.getVelocity(b) == Vec2d());
+    }
+
+    // Elastic collisions in time order, passing the momentum along
+    auto bounce = [](Scheduler* scheduler, size_t* count) {
+        return [scheduler, count](Scheduler::Handle a, Scheduler::Handle b, double, const Vec2d& normal) {
+            const Vec2d va = scheduler->getVelocity(a),
+                        vb = scheduler->getVelocity(b),
+                        n = normal;
+            scheduler->setVelocity(a, va - n * va.dot(n) + n * vb.dot(n));
+            scheduler->setVelocity(b, vb - n * vb.dot(n) + n * va.dot(n));
+            ++*count;
+        };
+    };
+
+    {
+        Scheduler scheduler(bounds);
+        auto first = scheduler.add(AABB<double>(0, 0, 1, 1), Vec2d(20, 0));
+        auto second = scheduler.add(AABB<double>(5, 0, 1, 1));
+        auto third = scheduler.add(AABB<double>(10, 0, 1, 1));
+
+        size_t count = 0;
+        scheduler.step(bounce(&scheduler, &count));
+        assert(count == 2);
+        assert(scheduler.getVelocity(first) == Vec2d());
+        assert(scheduler.getVelocity(second) == Vec2d());
+        assert(scheduler.getVelocity(third) == Vec2d(20, 0));
+        assert(fabs(scheduler.get(third).x - (10 + 20 * (1 - 0.4))) < 1e-9);
+    }
+
+    // Event budget: stop at the next impact
+    {
+        Scheduler scheduler(bounds);
+        scheduler.add(AABB<double>(0, 0, 1, 10));
+        scheduler.add(AABB<double>(3, 0, 1, 10));
+        auto ball = scheduler.add(AABB<double>(1.5, 5, 0.5, 0.5), Vec2d(100, 0));
+        (void)ball;
+
+        size_t count = 0;
+        const double end = scheduler.step([&](Scheduler::Handle a, Scheduler::Handle b, double, const Vec2d&) {
+            const Scheduler::Handle h = a == ball ? a : b;
+            scheduler.setVelocity(h, -scheduler.getVelocity(h));
+            ++count;
+        }, 5);
+        assert(count == 5);
+        assert(end < 1);
+        assert(scheduler.get(ball).x >= 1 - 1e-9 && scheduler.get(ball).x + 0.5 <= 3 + 1e-9);
+    }
+
+    // Random scene, nothing may overlap after any step
+    {
+        srand(7);
+        Scheduler scheduler(bounds);
+        vector<Scheduler::Handle> handles;
+        for (int y = 0; y < 10; ++y)
+            for (int x = 0; x < 10; ++x)
+                handles.push_back(scheduler.add(AABB<double>(x * 10 + frand(0, 5), y * 10 + frand(0, 5), frand(1, 4), frand(1, 4)),
+                                                Vec2d(frand(-30, 30), frand(-30, 30))));
+
+        size_t count = 0;
+        for (int frame = 0; frame < 50; ++frame)
+        {
+            scheduler.step(bounce(&scheduler, &count));
+            for (size_t i = 0; i < handles.size(); ++i)
+                for (size_t j = 0; j < i; ++j)
+                    assert(overlap(scheduler.get(handles[i]), scheduler.get(handles[j])) < 1e-6);
+        }
+        assert(count > 0);
+    }
+
+    cout << "OK" << endl;
+    return 0;
+}
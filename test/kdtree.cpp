@@ -0,0 +1,87 @@
+#include "math/geometry/KDTree.hpp"
+#include <cassert>
+#include <cstdlib>
+#include <algorithm>
+#include <iostream>
+
+using namespace math;
+using namespace std;
+
+int main(int argc, char *argv[])
+{
+    srand(1337);
+
+    PointSet<float> points;
+    for (int i = 0; i < 20000; ++i)
+        points.add(Point2f(rand() % 10000 / 10.f, rand() % 10000 / 10.f));
+
+    KDTree<float> empty;
+    assert(empty.findNearest(Point2f()) == (size_t)-1);
+
+    // Serial and parallel builds must give the same results
+    KDTree<float> tree(points, 1), ptree(points, 4);
+    assert(tree.size() == points.size());
+
+    const size_t k = 5;
+    size_t indices[k], pindices[k];
+    float dists[k], pdists[k];
+    vector<size_t> result, expected;
+
+    for (int i = 0; i < 200; ++i)
+    {
+        Point2f p(rand() % 1200 - 100, rand() % 1200 - 100);
+
+        // Brute force
+        vector<float> all(points.size());
+        for (size_t j = 0; j < points.size(); ++j)
+            all[j] = (points.get(j) - p).abs_sqr();
+        vector<float> sorted = all;
+        sort(sorted.begin(), sorted.end());
+
+        assert(tree.findNearest(p, k, indices, dists) == k);
+        assert(ptree.findNearest(p, k, pindices, pdists) == k);
+        for (size_t j = 0; j < k; ++j)
+        {
+            assert(dists[j] == sorted[j]);
+            assert(all[indices[j]] == dists[j]);
+            assert(pdists[j] == dists[j]);
+        }
+
+        float d;
+        size_t nearest = tree.findNearest(p, &d);
+        assert(d == sorted[0] && all[nearest] == d);
+
+        // Radius
+        float r = rand() % 50;
+        tree.findInRadius(p, r, &result);
+        expected.clear();
+        for (size_t j = 0; j < points.size(); ++j)
+            if (all[j] <= r * r)
+                expected.push_back(j);
+        sort(result.begin(), result.end());
+        assert(result == expected);
+
+        // Range
+        AABBf range(p.x, p.y, rand() % 100, rand() % 100);
+        ptree.findInRange(range, &result);
+        expected.clear();
+        for (size_t j = 0; j < points.size(); ++j)
+        {
+            auto q = points.get(j);
+            if (q.x >= range.x && q.y >= range.y && q.x < range.x + range.w && q.y < range.y + range.h)
+                expected.push_back(j);
+        }
+        sort(result.begin(), result.end());
+        assert(result == expected);
+    }
+
+    // Less points than requested
+    PointSet<float> few;
+    few.add(Point2f(1, 1));
+    few.add(Point2f(3, 3));
+    KDTree<float> small(few);
+    assert(small.findNearest(Point2f(), k, indices, dists) == 2);
+    assert(indices[0] == 0 && indices[1] == 1);
+
+    return 0;
+}
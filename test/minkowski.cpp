@@ -0,0 +1,164 @@
+#include "math/geometry/minkowski.hpp"
+#include "math/geometry/OffsetPolygon.hpp"
+#include "testutil.hpp"
+#include <cassert>
+#include <cstdlib>
+#include <cmath>
+#include <iostream>
+
+using namespace math;
+using namespace std;
+
+typedef OffsetPolygon<float> PolygonT;
+
+// Inside or on the border of a convex polygon of any winding
+static bool contains(const AbstractPointSet<float>& pol, const Point2f& p)
+{
+    const double s = area(pol) < 0 ? -1 : 1;
+    for (size_t i = 0; i < pol.size(); ++i)
+    {
+        Point2f a = pol.get(i), b = pol.get((i + 1) % pol.size());
+        if ((b - a).cross(p - a) * s < -1e-3)
+            return false;
+    }
+    return true;
+}
+
+static void randomConvex(PolygonT* pol, const Point2f& center, float radius, int n, bool cw)
+{
+    pol->clear();
+    pol->setFillType(Filled);
+    for (int i = 0; i < n; ++i)
+    {
+        float angle = (cw ? -1 : 1) * (i + rand() % 100 / 200.f) * 2 * M_PI / n;
+        pol->add(center + Vec2f(std::cos(angle), std::sin(angle)) * radius);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    srand(1337);
+
+    PolygonT square, tri;
+    square.add(Point2f(0, 0));
+    square.add(Point2f(2, 0));
+    square.add(Point2f(2, 2));
+    square.add(Point2f(0, 2));
+    tri.add(Point2f(0, 0));
+    tri.add(Point2f(1, 0));
+    tri.add(Point2f(0, 1));
+
+    PointSet<float> sum;
+    minkowskiSum(square, tri, &sum);
+    assert(sum.size() == 5);
+    assert(std::abs(area(sum) - 4 - 0.5 - 2 - 2) < 1e-5);
+    assert(sum.getBBox() == AABBf(0, 0, 3, 3));
+
+    minkowskiSum(square, AABBf(-1, -1, 2, 2), &sum);
+    assert(sum.size() == 4 && sum.getBBox() == AABBf(-1, -1, 4, 4));
+
+    minkowskiDifference(square, tri, &sum);
+    assert(sum.getBBox() == AABBf(-1, -1, 3, 3));
+
+    // Random convex polygons of both windings against the convex hull of
+    // all pairwise sums.
+    for (int i = 0; i < 100; ++i)
+    {
+        PolygonT a, b;
+        randomConvex(&a, Point2f(rand() % 100, rand() % 100), 1 + rand() % 20, 3 + rand() % 10, rand() % 2);
+        randomConvex(&b, Point2f(rand() % 100, rand() % 100), 1 + rand() % 20, 3 + rand() % 10, rand() % 2);
+
+        minkowskiSum(a, b, &sum);
+        assert(sum.size() <= a.size() + b.size());
+        assert((area(sum) > 0) == (area(a) > 0));
+        for (size_t j = 0; j < a.size(); ++j)
+            for (size_t k = 0; k < b.size(); ++k)
+                assert(contains(sum, a.get(j) + b.get(k).asVector()));
+
+        // The difference contains the origin iff the polygons overlap
+        PolygonT moved;
+        moved.setFillType(Filled);
+        for (size_t j = 0; j < b.size(); ++j)
+            moved.add(b.get(j) - b.getBBox().getCenter().asVector() + a.getBBox().getCenter().asVector());
+        minkowskiDifference(a, moved, &sum);
+        assert(contains(sum, Point2f()));
+    }
+
+    // Sweeping against a box polygon matches the AABB sweep
+    PolygonT box;
+    box.setFillType(Filled);
+    box.add(Point2f(10, 10));
+    box.add(Point2f(30, 10));
+    box.add(Point2f(30, 20));
+    box.add(Point2f(10, 20));
+
+    MinkowskiCache<float> cache;
+    for (int i = 0; i < 500; ++i)
+    {
+        AABBf mover(rand() % 400 / 10.f, rand() % 400 / 10.f, 1 + rand() % 5, 1 + rand() % 5);
+        Vec2f vel(rand() % 400 / 10.f - 20, rand() % 400 / 10.f - 20);
+
+        auto expected = sweep(mover, vel, AABBf(10, 10, 20, 10));
+        auto isec = sweepConvex(mover, vel, box);
+        auto cached = cache.sweep(mover, vel, box);
+
+        assert((bool)isec == (bool)expected && (bool)cached == (bool)expected);
+        if (expected)
+        {
+            assert(isec.type == SweptAABBxConvex);
+            assert(std::abs(isec.time - expected.time) < 1e-4);
+            assert(std::abs(cached.time - expected.time) < 1e-4);
+            if (expected.time > 0)
+                assert(isec.normal == expected.normal);
+        }
+    }
+    assert(cache.size() == 25);
+
+    // Cached polygons are reused and stored relative to the first vertex
+    Vec2f offset;
+    const PointSet<float>* p = &cache.get(box, Vec2f(2, 2), &offset);
+    assert(p == &cache.get(box, Vec2f(2, 2)));
+    assert(offset == Vec2f(10, 10));
+    assert(p->getBBox() == AABBf(-1, -1, 22, 12));
+
+    // Moving keeps the entries, edits and assignments rebuild them
+    box.move(Vec2f(5, -3));
+    assert(cache.size() == 25);
+    assert(p == &cache.get(box, Vec2f(2, 2), &offset));
+    assert(offset == Vec2f(15, 7));
+    auto moved = cache.sweep(AABBf(0, 10, 2, 2), Vec2f(30, 0), box);
+    assert(moved && std::abs(moved.seg.p.x - 14) < 1e-4 && moved.normal == Vec2f(-1, 0));
+
+    box.edit(1, Point2f(50, 10));
+    assert(cache.get(box, Vec2f(2, 2)).getBBox() == AABBf(-1, -1, 37, 12));
+    assert(cache.size() == 1);
+
+    PolygonT other;
+    other.add(Point2f(0, 0));
+    other.add(Point2f(4, 0));
+    other.add(Point2f(4, 4));
+    box = other;
+    assert(cache.get(box, Vec2f(2, 2)).getBBox() == AABBf(-1, -1, 6, 6));
+    assert(cache.size() == 1);
+
+    cache.invalidate(box);
+    assert(cache.size() == 0);
+
+    // Rays against a rotated polygon
+    PolygonT diamond;
+    diamond.add(Point2f(0, -1));
+    diamond.add(Point2f(1, 0));
+    diamond.add(Point2f(0, 1));
+    diamond.add(Point2f(-1, 0));
+    auto isec = intersectConvex(Line2f(Point2f(-5, 0), Vec2f(1, 0), Ray), diamond);
+    assert(isec && std::abs(isec.near - 4) < 1e-5 && std::abs(isec.far - 6) < 1e-5);
+    assert(std::abs(isec.normal.x + std::sqrt(0.5f)) < 1e-5 && std::abs(isec.normal.y) > 0.7f);
+    assert(!intersectConvex(Line2f(Point2f(-5, 2), Vec2f(1, 0), Ray), diamond));
+    assert(!intersectConvex(Line2f(Point2f(-5, 0), Vec2f(1, 0), Segment), diamond));
+
+    isec = intersectConvex(Line2f(Point2f(0, 0), Vec2f(2, 0), Segment), diamond);
+    assert(isec && isec.near == 0 && std::abs(isec.far - 0.5) < 1e-5);
+
+    cout << "OK" << endl;
+    return 0;
+}
@@ -0,0 +1,81 @@
+#include "math/geometry/morton.hpp"
+#include "math/geometry/OffsetPolygon.hpp"
+#include <cassert>
+#include <cstdlib>
+#include <algorithm>
+#include <numeric>
+
+using namespace math;
+using namespace std;
+
+int main(int argc, char *argv[])
+{
+    srand(3);
+
+    // Encoding
+    assert(mortonEncode(0, 0) == 0);
+    assert(mortonEncode(1, 0) == 1);
+    assert(mortonEncode(0, 1) == 2);
+    assert(mortonEncode(3, 3) == 15);
+    assert(mortonEncode(0xffff, 0xffff) == 0xffffffff);
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        uint32_t x = rand() & 0xffff, y = rand() & 0xffff, dx, dy;
+        mortonDecode(mortonEncode(x, y), &dx, &dy);
+        assert(x == dx && y == dy);
+    }
+
+    AABBf bounds(0, 0, 100, 100);
+    assert(mortonCode(Point2f(0, 0), bounds) == 0);
+    assert(mortonCode(Point2f(100, 100), bounds) == 0xffffffff);
+    assert(mortonCode(Point2f(-50, 200), bounds) == mortonEncode(0, 0xffff));
+    assert(mortonCode(AABBf(0, 0, 200, 200), bounds) == 0xffffffff);
+
+    // Radix sort must be stable and equal to a serial sort
+    vector<uint32_t> keys(100000);
+    for (auto& k : keys)
+        k = rand() % 5000 * 100003u;
+    vector<size_t> order, expected(keys.size());
+    iota(expected.begin(), expected.end(), 0);
+    stable_sort(expected.begin(), expected.end(), [&](size_t a, size_t b) { return keys[a] < keys[b]; });
+
+    radixSort(keys, &order, 4);
+    assert(order == expected);
+    radixSort(keys, &order, 1);
+    assert(order == expected);
+
+    // Point sets
+    PointSet<float> points;
+    for (int i = 0; i < 1000; ++i)
+        points.add(Point2f(rand() % 1000, rand() % 1000));
+    auto bbox = points.getBBox();
+
+    mortonSort(&points, 2);
+    assert(points.size() == 1000);
+    for (size_t i = 1; i < points.size(); ++i)
+        assert(mortonCode(points.get(i - 1), bbox) <= mortonCode(points.get(i), bbox));
+
+    // Polygon arrays
+    vector<OffsetPolygon<float>> polygons(4);
+    polygons[0].add(Point2f(90, 90));
+    polygons[0].add(Point2f(95, 95));
+    polygons[1].add(Point2f(10, 10));
+    polygons[1].add(Point2f(15, 15));
+    polygons[2].add(Point2f(10, 90));
+    polygons[2].add(Point2f(15, 95));
+    polygons[3].add(Point2f(90, 10));
+    polygons[3].add(Point2f(95, 15));
+
+    vector<const AbstractPolygon<float>*> ptrs;
+    for (auto& pol : polygons)
+        ptrs.push_back(&pol);
+    mortonOrder(ptrs, &order);
+    reorder(&polygons, order);
+    assert(polygons[0].get(0) == Point2f(10, 10));
+    assert(polygons[1].get(0) == Point2f(90, 10));
+    assert(polygons[2].get(0) == Point2f(10, 90));
+    assert(polygons[3].get(0) == Point2f(90, 90));
+
+    return 0;
+}
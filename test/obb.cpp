@@ -0,0 +1,230 @@
+#include "math/geometry/OBB.hpp"
+#include "math/geometry/OffsetPolygon.hpp"
+#include "testutil.hpp"
+#include <cassert>
+#include <cstdlib>
+#include <cmath>
+#include <iostream>
+
+using namespace math;
+using namespace std;
+
+static bool near(double a, double b, double eps = 1e-9)
+{
+    return fabs(a - b) < eps;
+}
+
+int main()
+{
+    // Fitting a rotated rectangle gives the rectangle back
+    {
+        PointSet<double> points;
+        const Vec2d u(cos(0.3), sin(0.3)), v = u.right();
+        const Point2d c(5, 2);
+        points.add(c + u * 4 + v * 1);
+        points.add(c - u * 4 + v * 1);
+        points.add(c - u * 4 - v * 1);
+        points.add(c + u * 4 - v * 1);
+        points.add(c + u * 1);      // Inside
+
+        const auto obb = OBBd::fromPoints(points);
+        assert(near(obb.getArea(), 16));
+        assert(near((obb.center - c).abs(), 0));
+        assert(near(fabs(obb.axis.dot(u)), 1) || near(fabs(obb.axis.dot(v)), 1));
+        assert(obb.getArea() < points.getBBox().w * points.getBBox().h);
+
+        // Degenerate input
+        PointSet<double> line;
+        line.add(Point2d(0, 0));
+        line.add(Point2d(2, 2));
+        line.add(Point2d(1, 1));
+        const auto lobb = OBBd::fromPoints(line);
+        assert(near(lobb.halfsize.x, sqrt(2.0)) && lobb.halfsize.y == 0);
+        assert(near(lobb.center.x, 1) && near(lobb.center.y, 1));
+    }
+
+    // Random point sets: the box contains all points and is not larger
+    // than any box aligned with a hull edge.
+    {
+        srand(3);
+        for (int i = 0; i < 100; ++i)
+        {
+            PointSet<double> points;
+            const size_t n = 3 + rand() % 40;
+            const double angle = frand(0, 3.14);
+            for (size_t k = 0; k < n; ++k)
+            {
+                Vec2d p(frand(-10, 10), frand(-2, 2));
+                p.rotate_rad(angle);
+                points.add(p.asPoint());
+            }
+
+            const auto obb = OBBd::fromPoints(points);
+            OBBd grown = obb;
+            grown.halfsize += Vec2d(1e-9, 1e-9);
+            for (size_t k = 0; k < n; ++k)
+                assert(intersect(grown, points.get(k)));
+
+            // Brute force over all point pairs as edge directions
+            double best = 1e30;
+            for (size_t a = 0; a < n; ++a)
+                for (size_t b = a + 1; b < n; ++b)
+                {
+                    const Vec2d u = (points.get(b) - points.get(a)).normalized(),
+                                v = u.right();
+                    double minu = 1e30, maxu = -1e30, minv = 1e30, maxv = -1e30;
+                    for (size_t k = 0; k < n; ++k)
+                    {
+                        const Vec2d p = points.get(k).asVector();
+                        minu = min(minu, u.dot(p));
+                        maxu = max(maxu, u.dot(p));
+                        minv = min(minv, v.dot(p));
+                        maxv = max(maxv, v.dot(p));
+                    }
+                    best = min(best, (maxu - minu) * (maxv - minv));
+                }
+            assert(near(obb.getArea(), best, 1e-7));
+        }
+    }
+
+    // Separating axis test
+    {
+        const OBBd a(Point2d(0, 0), Vec2d(2, 1));
+        const Vec2d diag = Vec2d(1, 1).normalized();
+
+        auto isec = intersect(a, OBBd(Point2d(3, 0), Vec2d(1.5, 0.5)));
+        assert(isec && isec.type == OBBxOBB);
+        assert(near(isec.normal.x, -1) && near(isec.delta.x, 0.5));
+
+        // The AABBs overlap, the boxes don't
+        const Vec2d across = diag.right();
+        const OBBd b(Point2d(2, 1) + diag * 0.3, Vec2d(1, 0.1), across);
+        assert(intersect(a.getBBox(), b.getBBox()));
+        assert(!intersect(a, b));
+        assert(intersect(a, OBBd(Point2d(2, 1) + diag * 0.05, Vec2d(1, 0.1), across)));
+
+        isec = intersect(OBBd(Point2d(0, 0), Vec2d(1, 1), diag), AABB<double>(1, -1, 2, 2));
+        assert(isec && near(isec.normal.x, -1) && near(isec.delta.abs(), sqrt(2.0) - 1));
+        assert(!intersect(OBBd(Point2d(0, 0), Vec2d(1, 1), diag), AABB<double>(1.5, -1, 2, 2)));
+    }
+
+    // Ray queries
+    {
+        const OBBd box(Point2d(0, 0), Vec2d(2, 1), Vec2d(0, 1));     // Standing box
+        auto isec = intersect(Line2d(Point2d(-5, 0), Vec2d(10, 0), Segment), box);
+        assert(isec && isec.type == LinexOBB);
+        assert(near(isec.near, 0.4) && near(isec.far, 0.6));
+        assert(near(isec.normal.x, -1) && near(isec.normal.y, 0));
+
+        isec = intersect(Line2d(Point2d(0, 5), Vec2d(0, -1), Ray), box);
+        assert(isec && near(isec.near, 3) && near(isec.normal.y, 1));
+        assert(!intersect(Line2d(Point2d(-5, 2.5), Vec2d(1, 0), Ray), box));
+        assert(!intersect(Line2d(Point2d(-5, 0), Vec2d(1, 0), Segment), box));
+
+        isec = intersect(Line2d(Point2d(0, 0), Vec2d(1, 0), Ray), box);
+        assert(isec && isec.near == 0 && near(isec.far, 1));
+    }
+
+    // Polygons can cache their OBB as second reject stage
+    {
+        OffsetPolygon<double> pol;
+        const double angle = 0.6;
+        const Vec2d u(cos(angle), sin(angle)), v = u.right();
+        pol.add((u * 5 + v * 0.5).asPoint());
+        pol.add((-u * 5 + v * 0.5).asPoint());
+        pol.add((-u * 5 - v * 0.5).asPoint());
+        pol.add((u * 5 - v * 0.5).asPoint());
+
+        assert(pol.getOBB() == nullptr);
+        pol.setOBBEnabled(true);
+        const OBBd* obb = pol.getOBB();
+        assert(obb && near(obb->getArea(), 10, 1e-6));
+
+        // Inside the AABB, outside the polygon
+        const Point2d outside = (v * 2).asPoint();
+        assert(intersect(pol.getBBox(), outside) && !intersect(*obb, outside));
+        assert(!intersect(outside, pol));
+        assert(intersect(Point2d(0, 0), pol));
+        assert(!intersect(Line2d(outside, u * 3, Segment), pol));
+        assert(intersect(Line2d(Point2d(0, 0), u * 10, Segment), pol));
+
+        pol.move(Vec2d(10, 0));
+        assert(near(pol.getOBB()->center.x, 10));
+        assert(intersect(Point2d(10, 0), pol));
+
+        pol.edit(0, pol.get(0) + v * 1.5);
+        assert(pol.getOBB()->getArea() > 10.5);
+    }
+
+    // Float polygons far from the origin: queries on the outline give the
+    // same results with and without the OBB
+    {
+        srand(9);
+        for (int i = 0; i < 500; ++i)
+        {
+            OffsetPolygon<float> pol, plain;
+            const float angle = frand(0, 6.283);
+            const Vec2f u(cos(angle), sin(angle)), v = u.right();
+            const Vec2f center(frand(-1000, 1000), frand(-1000, 1000));
+            const float w = frand(0.1, 50), h = frand(0.1, 50);
+            const Point2f corners[] = {
+                (center + u * w + v * h).asPoint(), (center - u * w + v * h).asPoint(),
+                (center - u * w - v * h).asPoint(), (center + u * w - v * h).asPoint()
+            };
+            for (auto& p : corners)
+            {
+                pol.add(p);
+                plain.add(p);
+            }
+            pol.setOBBEnabled(true);
+
+            for (size_t k = 0; k < 4; ++k)
+            {
+                const Point2f p = pol.get(k);
+                assert(intersect(*pol.getOBB(), p));
+                const Line2f seg(p + Vec2f(frand(-20, 20), frand(-20, 20)), p);
+                assert(bool(intersect(seg, pol)) == bool(intersect(seg, plain)));
+                assert(intersect(p, pol) == intersect(p, plain));
+
+                const Point2f mid = p + (pol.get((k + 1) % 4) - p) / 2;
+                assert(intersect(mid, pol) == intersect(mid, plain));
+            }
+        }
+    }
+
+    // Polygons fitted near the origin keep a matching margin after moving
+    // far away
+    {
+        srand(11);
+        for (int i = 0; i < 200; ++i)
+        {
+            OffsetPolygon<float> pol;
+            const float angle = frand(0, 6.283);
+            const Vec2f u(cos(angle), sin(angle)), v = u.right();
+            const float w = frand(0.1, 50), h = frand(0.1, 50);
+            pol.add((u * w + v * h).asPoint());
+            pol.add((-u * w + v * h).asPoint());
+            pol.add((-u * w - v * h).asPoint());
+            pol.add((u * w - v * h).asPoint());
+            pol.setOBBEnabled(true);
+            assert(pol.getOBB());
+
+            pol.setOffset(Vec2f(frand(-1e5, 1e5), frand(-1e5, 1e5)));
+            for (size_t k = 0; k < 4; ++k)
+                assert(intersect(*pol.getOBB(), pol.get(k)));
+        }
+    }
+
+    // Integer polygons never cache an OBB
+    {
+        OffsetPolygon<int> pol;
+        pol.add(Point2i(0, 0));
+        pol.add(Point2i(4, 0));
+        pol.add(Point2i(4, 2));
+        pol.setOBBEnabled(true);
+        assert(pol.getOBB() == nullptr);
+    }
+
+    cout << "OK" << endl;
+    return 0;
+}
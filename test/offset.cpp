@@ -0,0 +1,212 @@
+#include "math/geometry/offset.hpp"
+#include "math/geometry/OffsetPolygon.hpp"
+#include "testutil.hpp"
+#include <cassert>
+#include <cstdlib>
+#include <cmath>
+#include <iostream>
+
+using namespace math;
+using namespace std;
+
+typedef OffsetPolygon<double> PolygonT;
+
+static double totalArea(const vector<PointSet<double>>& pols)
+{
+    double a = 0;
+    for (auto& pol : pols)
+        a += area(pol);
+    return a;
+}
+
+static int winding(const AbstractPointSet<double>& pol, const Point2d& p)
+{
+    int w = 0;
+    for (size_t i = 0; i < pol.size(); ++i)
+    {
+        Point2d a = pol.get(i), b = pol.get((i + 1) % pol.size());
+        double c = (b - a).cross(p - a);
+        if (a.y <= p.y && b.y > p.y && c > 0)
+            ++w;
+        else if (a.y > p.y && b.y <= p.y && c < 0)
+            --w;
+    }
+    return w;
+}
+
+static int winding(const vector<PointSet<double>>& pols, const Point2d& p)
+{
+    int w = 0;
+    for (auto& pol : pols)
+        w += winding(pol, p);
+    return w;
+}
+
+static double distance(const AbstractPointSet<double>& pol, const Point2d& p)
+{
+    double best = 1e300;
+    for (size_t i = 0; i < pol.size(); ++i)
+    {
+        Point2d a = pol.get(i), b = pol.get((i + 1) % pol.size());
+        Vec2d d = b - a;
+        double t = std::max(0.0, std::min(1.0, (p - a).dot(d) / d.abs_sqr()));
+        best = std::min(best, (a + d * t - p).abs());
+    }
+    return best;
+}
+
+int main(int argc, char *argv[])
+{
+    srand(1337);
+    vector<PointSet<double>> out;
+
+    // Square, counter-clockwise in y-up
+    PolygonT square;
+    square.setFillType(Filled);
+    square.add(Point2d(0, 0));
+    square.add(Point2d(10, 0));
+    square.add(Point2d(10, 10));
+    square.add(Point2d(0, 10));
+
+    offsetPolygon(square, 1.0, &out, JoinMiter);
+    assert(out.size() == 1 && out[0].size() == 4);
+    assert(std::abs(area(out[0]) - 144) < 1e-9);
+
+    offsetPolygon(square, 1.0, &out, JoinSquare);
+    assert(out.size() == 1 && out[0].size() == 8);
+    assert(std::abs(area(out[0]) - (144 - 4 * (M_SQRT2 - 1) * (M_SQRT2 - 1))) < 1e-6);
+
+    offsetPolygon(square, 1.0, &out, JoinRound, 2, 0.001);
+    assert(out.size() == 1);
+    assert(std::abs(area(out[0]) - (100 + 40 + M_PI)) < 0.01);
+
+    offsetPolygon(square, -2.0, &out, JoinRound);
+    assert(out.size() == 1 && out[0].size() == 4);
+    assert(std::abs(area(out[0]) - 36) < 1e-9);
+
+    offsetPolygon(square, -5.0, &out);
+    assert(out.empty());
+
+    // Clockwise input keeps its winding
+    PolygonT cw;
+    for (size_t i = square.size(); i > 0; --i)
+        cw.add(square.get(i - 1));
+    offsetPolygon(cw, 1.0, &out);
+    assert(out.size() == 1 && std::abs(area(out[0]) + 144) < 1e-9);
+
+    // Dumbbell falls apart when shrunk
+    PolygonT dumbbell;
+    dumbbell.add(Point2d(0, 0));
+    dumbbell.add(Point2d(10, 0));
+    dumbbell.add(Point2d(10, 4));
+    dumbbell.add(Point2d(20, 4));
+    dumbbell.add(Point2d(20, 0));
+    dumbbell.add(Point2d(30, 0));
+    dumbbell.add(Point2d(30, 10));
+    dumbbell.add(Point2d(20, 10));
+    dumbbell.add(Point2d(20, 6));
+    dumbbell.add(Point2d(10, 6));
+    dumbbell.add(Point2d(10, 10));
+    dumbbell.add(Point2d(0, 10));
+    offsetPolygon(dumbbell, -1.5, &out);
+    assert(out.size() == 2);
+    assert(std::abs(totalArea(out) - 2 * 49) < 1e-9);
+
+    // A C-shape with a narrow gap closes and leaves a hole
+    PolygonT cshape;
+    cshape.add(Point2d(0, 0));
+    cshape.add(Point2d(20, 0));
+    cshape.add(Point2d(20, 9));
+    cshape.add(Point2d(18, 9));
+    cshape.add(Point2d(18, 2));
+    cshape.add(Point2d(2, 2));
+    cshape.add(Point2d(2, 18));
+    cshape.add(Point2d(18, 18));
+    cshape.add(Point2d(18, 11));
+    cshape.add(Point2d(20, 11));
+    cshape.add(Point2d(20, 20));
+    cshape.add(Point2d(0, 20));
+    offsetPolygon(cshape, 1.5, &out);
+    assert(out.size() == 2);
+    assert((area(out[0]) > 0) != (area(out[1]) > 0));
+    assert(winding(out, Point2d(10, 10)) == 0);
+    assert(winding(out, Point2d(19, 10)) == 1);
+
+    // A U-shape whose arms' collinear top edges overlap when inflated
+    PolygonT ushape;
+    ushape.add(Point2d(0, 0));
+    ushape.add(Point2d(30, 0));
+    ushape.add(Point2d(30, 20));
+    ushape.add(Point2d(20, 20));
+    ushape.add(Point2d(20, 5));
+    ushape.add(Point2d(10, 5));
+    ushape.add(Point2d(10, 20));
+    ushape.add(Point2d(0, 20));
+    offsetPolygon(ushape, 5.0, &out, JoinMiter);
+    assert(out.size() == 1 && out[0].size() == 4);
+    assert(std::abs(area(out[0]) - 40 * 30) < 1e-9);
+    offsetPolygon(ushape, 6.0, &out, JoinMiter);
+    assert(out.size() == 1 && out[0].size() == 4);
+    assert(std::abs(area(out[0]) - 42 * 32) < 1e-9);
+    assert(out[0].getBBox() == AABB<double>(-6, -6, 42, 32));
+
+    // Random concave star: every vertex of a round offset lies at distance
+    // delta from the input and inside tests match the distance.
+    PolygonT star;
+    for (int i = 0; i < 40; ++i)
+    {
+        double angle = i * 2 * M_PI / 40,
+               r = i % 2 ? 10 + rand() % 100 / 10.0 : 30 + rand() % 200 / 10.0;
+        star.add(Point2d(50 + std::cos(angle) * r, 50 + std::sin(angle) * r));
+    }
+
+    for (double delta : { 4.0, -2.0, -6.0 })
+    {
+        const double tol = 0.01;
+        offsetPolygon(star, delta, &out, JoinRound, 2, tol);
+        assert(!out.empty());
+
+        for (auto& pol : out)
+            for (size_t i = 0; i < pol.size(); ++i)
+            {
+                // Intersections of arc chords may lie closer by up to tol
+                double d = distance(star, pol.get(i));
+                assert(d > std::abs(delta) - tol && d < std::abs(delta) + 1e-6);
+            }
+
+        for (int i = 0; i < 2000; ++i)
+        {
+            Point2d p(rand() % 10000 / 100.0, rand() % 10000 / 100.0);
+            double dist = distance(star, p) * (winding(star, p) ? -1 : 1);
+            if (std::abs(dist - delta) < 2 * tol)
+                continue;
+            assert((winding(out, p) == 1) == (dist < delta));
+            assert(winding(out, p) == 0 || winding(out, p) == 1);
+        }
+    }
+
+    // Open polylines are offset on both sides with caps
+    PolygonT line;
+    line.setFillType(Open);
+    line.add(Point2d(0, 0));
+    line.add(Point2d(10, 0));
+    line.add(Point2d(10, 10));
+
+    offsetPolygon(line, 1.0, &out, JoinRound, 2, 0.001);
+    assert(out.size() == 1);
+    assert(std::abs(area(out[0]) - (40 + M_PI + M_PI / 4 - 1)) < 0.01);
+    assert(winding(out, Point2d(-0.5, 0)) == 1);
+    assert(winding(out, Point2d(5, 5)) == 0);
+
+    offsetPolygon(line, -1.0, &out, JoinMiter);
+    assert(out.size() == 1);
+    assert(std::abs(area(out[0]) - (12 * 2 + 12 * 2 - 4)) < 1e-9);
+
+    // Output to polygons
+    vector<PolygonT> pols;
+    offsetPolygon(square, 1.0, &pols);
+    assert(pols.size() == 1 && pols[0].getBBox() == AABB<double>(-1, -1, 12, 12));
+
+    cout << "OK" << endl;
+    return 0;
+}
@@ -0,0 +1,130 @@
+#include "math/geometry/LooseQuadtree.hpp"
+#include <cassert>
+#include <cstdlib>
+#include <algorithm>
+#include <iostream>
+
+using namespace math;
+using namespace std;
+
+typedef LooseQuadtree<float>::Handle Handle;
+
+static AABBf randomBox()
+{
+    // Mix of tiny and huge objects, some outside the bounds
+    float size = rand() % 10 == 0 ? rand() % 400 : rand() % 10 + 0.5f;
+    return AABBf(rand() % 1200 - 100, rand() % 1200 - 100, size, size * (rand() % 3 + 1) / 2.f);
+}
+
+static bool overlaps(const AABBf& a, const AABBf& b)
+{
+    return a.x <= b.x + b.w && b.x <= a.x + a.w && a.y <= b.y + b.h && b.y <= a.y + a.h;
+}
+
+int main(int argc, char *argv[])
+{
+    srand(7);
+
+    LooseQuadtree<float> tree(AABBf(0, 0, 1000, 1000), 6);
+    vector<AABBf> boxes;
+    vector<bool> alive;
+    vector<Handle> result, expected;
+
+    for (int i = 0; i < 2000; ++i)
+    {
+        boxes.push_back(randomBox());
+        alive.push_back(true);
+        assert(tree.insert(boxes.back()) == (Handle)i);
+    }
+
+    for (int round = 0; round < 200; ++round)
+    {
+        // Move, resize and replace objects
+        for (int i = 0; i < 50; ++i)
+        {
+            size_t h = rand() % boxes.size();
+            if (!alive[h])
+                continue;
+
+            switch (rand() % 3)
+            {
+                case 0:
+                    tree.move(h, Vec2f(rand() % 21 - 10, rand() % 21 - 10));
+                    boxes[h] = tree.get(h);
+                    break;
+                case 1:
+                    boxes[h] = randomBox();
+                    tree.update(h, boxes[h]);
+                    break;
+                case 2:
+                    tree.remove(h);
+                    alive[h] = false;
+                    break;
+            }
+        }
+
+        // Freed handles are reused
+        Handle h = tree.insert(randomBox());
+        if (h < boxes.size())
+        {
+            assert(!alive[h]);
+            alive[h] = true;
+            boxes[h] = tree.get(h);
+        }
+        else
+        {
+            boxes.push_back(tree.get(h));
+            alive.push_back(true);
+        }
+
+        // Range query
+        AABBf range(rand() % 1000, rand() % 1000, rand() % 200, rand() % 200);
+        tree.query(range, &result);
+        expected.clear();
+        for (size_t j = 0; j < boxes.size(); ++j)
+            if (alive[j] && overlaps(boxes[j], range))
+                expected.push_back(j);
+        sort(result.begin(), result.end());
+        assert(result == expected);
+
+        // Point query
+        Point2f p(rand() % 1000 + 0.5f, rand() % 1000 + 0.5f);
+        tree.query(p, &result);
+        expected.clear();
+        for (size_t j = 0; j < boxes.size(); ++j)
+            if (alive[j] && intersect(boxes[j], p))
+                expected.push_back(j);
+        sort(result.begin(), result.end());
+        assert(result == expected);
+
+        // Raycast
+        Line2f ray(p, Point2f(rand() % 1000 + 0.5f, rand() % 1000 + 0.5f), Segment);
+        Handle hit;
+        auto isec = tree.raycast(ray, &hit);
+        Intersection<float> nearest;
+        for (size_t j = 0; j < boxes.size(); ++j)
+        {
+            if (!alive[j])
+                continue;
+            auto other = intersect(ray, boxes[j]);
+            if (other && (!nearest || other.time < nearest.time))
+                nearest = other;
+        }
+        assert((bool)isec == (bool)nearest);
+        if (isec)
+        {
+            assert(isec.time == nearest.time);
+            assert(intersect(ray, boxes[hit]).time == isec.time);
+        }
+    }
+
+    size_t n = count(alive.begin(), alive.end(), true);
+    assert(tree.size() == n);
+
+    tree.clear();
+    assert(tree.size() == 0);
+    tree.query(AABBf(-1000, -1000, 3000, 3000), &result);
+    assert(result.empty());
+
+    return 0;
+}
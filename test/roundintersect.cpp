@@ -0,0 +1,226 @@
+#include "math/geometry/round_intersect.hpp"
+#include "math/geometry/OffsetPolygon.hpp"
+#include "testutil.hpp"
+#include <cassert>
+#include <cstdlib>
+#include <cmath>
+#include <iostream>
+
+using namespace math;
+using namespace std;
+
+typedef OffsetPolygon<double> PolygonT;
+
+static bool near(double a, double b, double eps = 1e-9)
+{
+    return fabs(a - b) < eps;
+}
+
+static bool near(const Vec2d& a, const Vec2d& b, double eps = 1e-9)
+{
+    return (a - b).abs() < eps;
+}
+
+int main()
+{
+    // Static tests
+    {
+        const Circled a(0, 0, 1), b(1.5, 0, 1);
+        auto isec = intersect(a, b);
+        assert(isec && isec.type == CirclexShape);
+        assert(near(isec.normal, Vec2d(-1, 0)));
+        assert(near(isec.delta, Vec2d(0.5, 0)));
+        assert(!intersect(a, Circled(2.5, 0, 1)));
+        assert(near(distance(a, Circled(3, 0, 1)), 1));
+        assert(intersect(a, Point2d(0.6, 0.6)) && !intersect(a, Point2d(0.8, 0.8)));
+
+        // Circle vs AABB, near a corner and with the center inside
+        const AABB<double> box(1, 1, 2, 2);
+        assert(!intersect(Circled(0, 0, 1), box));
+        isec = intersect(Circled(0.5, 0.5, 1), box);
+        assert(isec && near(isec.normal, Vec2d(-1, -1).normalized()));
+        assert(near(isec.delta.abs(), 1 - sqrt(0.5)));
+        isec = intersect(Circled(1.2, 2, 0.5), box);
+        assert(isec && near(isec.normal, Vec2d(-1, 0)) && near(isec.delta, Vec2d(0.7, 0)));
+        assert(near(distance(Circled(0, 0, 1), box), sqrt(2.0) - 1));
+
+        // Same with the box as polygon
+        PolygonT pol;
+        makeBox(&pol, box);
+        isec = intersect(Circled(1.2, 2, 0.5), pol);
+        assert(isec && near(isec.normal, Vec2d(-1, 0)) && near(isec.delta, Vec2d(0.7, 0)));
+        assert(near(distance(Circled(0, 0, 1), pol), sqrt(2.0) - 1));
+
+        // Crossing capsules
+        const Capsuled h(Point2d(-5, 0), Point2d(5, 0), 0.5),
+                       v(Point2d(1, -5), Point2d(1, 5), 0.5);
+        isec = intersect(h, v);
+        assert(isec && isec.type == CapsulexShape);
+        assert(near(isec.delta.abs(), 4 + 1));   // Pushed out of the end
+        assert(near(distance(h, Capsuled(Point2d(-5, 3), Point2d(5, 3), 1)), 1.5));
+        assert(intersect(h, Point2d(5.3, 0.3)) && !intersect(h, Point2d(5.4, 0.4)));
+        assert(near(distance(h, Point2d(0, 2)), 1.5));
+
+        // Capsule lying across a box without any vertex inside
+        assert(intersect(Capsuled(Point2d(0, 2), Point2d(4, 2), 0.1), box));
+        assert(intersect(Capsuled(Point2d(0, 2), Point2d(4, 2), 0.1), pol));
+        assert(!intersect(Capsuled(Point2d(0, 3.2), Point2d(4, 3.2), 0.1), pol));
+
+        // Capsule vs segment
+        isec = intersect(h, Line2d(Point2d(0, 0.3), Point2d(0, 4)));
+        assert(isec && near(isec.normal, Vec2d(0, -1)) && near(isec.delta.abs(), 0.2));
+    }
+
+    // Ray casts
+    {
+        auto isec = intersect(Line2d(Point2d(-10, 0), Vec2d(20, 0), Segment), Circled(0, 0, 2));
+        assert(isec && isec.type == LinexCircle);
+        assert(near(isec.near, 0.4) && near(isec.far, 0.6));
+        assert(near(isec.normal, Vec2d(-1, 0)));
+        assert(!intersect(Line2d(Point2d(-10, 0), Vec2d(5, 0), Segment), Circled(0, 0, 2)));
+        assert(!intersect(Line2d(Point2d(-10, 3), Vec2d(1, 0), Ray), Circled(0, 0, 2)));
+
+        isec = intersect(Line2d(Point2d(0, 0), Vec2d(1, 0), Ray), Circled(0, 0, 2));
+        assert(isec && isec.near == 0 && near(isec.far, 2));
+
+        const Capsuled cap(Point2d(0, 0), Point2d(10, 0), 1);
+        isec = intersect(Line2d(Point2d(5, 10), Vec2d(0, -20), Segment), cap);
+        assert(isec && isec.type == LinexCapsule);
+        assert(near(isec.near, 9.0 / 20) && near(isec.far, 11.0 / 20));
+        assert(near(isec.normal, Vec2d(0, 1)));
+
+        isec = intersect(Line2d(Point2d(20, 0.5), Vec2d(-1, 0), Ray), cap);
+        assert(isec && near(isec.seg.p.x, 10 + sqrt(0.75)));
+        assert(near(isec.near, 10 - sqrt(0.75)) && near(isec.far, 20 + sqrt(0.75)));
+    }
+
+    // Sweeps
+    {
+        const Circled c(0, 0, 1);
+        auto isec = sweep(c, Vec2d(10, 0), AABB<double>(5, -0.5, 1, 1));
+        assert(isec && isec.type == SweptCirclexShape);
+        assert(near(isec.near, 0.4) && near(isec.normal, Vec2d(-1, 0)));
+        assert(near(isec.seg.p.x, 4));
+
+        // Hitting a corner
+        isec = sweep(c, Vec2d(10, 0), AABB<double>(5, 0.6, 1, 3));
+        assert(isec && near(isec.near, 0.42) && near(isec.normal, Vec2d(-0.8, -0.6)));
+        assert(!sweep(c, Vec2d(10, 0), AABB<double>(5, 1.1, 1, 3)));
+        assert(!sweep(c, Vec2d(-10, 0), AABB<double>(5, -0.5, 1, 1)));
+
+        PolygonT pol;
+        makeBox(&pol, AABB<double>(5, 0.6, 1, 3));
+        isec = sweep(c, Vec2d(10, 0), pol);
+        assert(isec && near(isec.near, 0.42) && near(isec.normal, Vec2d(-0.8, -0.6)));
+
+        isec = sweep(c, Vec2d(10, 0), Circled(6, 0, 1));
+        assert(isec && near(isec.near, 0.4) && near(isec.far, 0.8));
+
+        isec = sweep(c, Vec2d(0, 10), Line2d(Point2d(-5, 5), Point2d(5, 5)));
+        assert(isec && near(isec.near, 0.4) && near(isec.normal, Vec2d(0, -1)));
+
+        // Starting inside
+        isec = sweep(c, Vec2d(10, 0), Circled(0.5, 0, 1));
+        assert(isec && isec.near == 0);
+
+        // A standing capsule hits a box with its side
+        const Capsuled cap(Point2d(0, -2), Point2d(0, 2), 0.5);
+        isec = sweep(cap, Vec2d(10, 0), AABB<double>(5, -1, 1, 2));
+        assert(isec && isec.type == SweptCapsulexShape);
+        assert(near(isec.near, 0.45) && near(isec.normal, Vec2d(-1, 0)));
+        assert(near(isec.seg.p.x, 4.5) && near(isec.seg.p.y, 0));
+
+        isec = sweep(cap, Vec2d(10, 0), Capsuled(Point2d(5, -1), Point2d(5, 1), 0.5));
+        assert(isec && near(isec.near, 0.4));
+
+        isec = sweep(cap, Vec2d(0, 10), Circled(0, 6, 1));
+        assert(isec && near(isec.near, 0.25) && near(isec.normal, Vec2d(0, -1)));
+
+        // Lying across a box from the start
+        isec = sweep(Capsuled(Point2d(4, 5), Point2d(4, -5), 0.1), Vec2d(1, 0), AABB<double>(3, -1, 2, 2));
+        assert(isec && isec.near == 0);
+    }
+
+    // Rays and lines as shapes
+    {
+        const Line2d line(Point2d(0, 0), Vec2d(1, 0), Line),
+                     ray(Point2d(0, 0), Vec2d(1, 0), Ray),
+                     seg(Point2d(0, 0), Vec2d(1, 0), Segment);
+
+        auto isec = intersect(Circled(100, 0.5, 1), line);
+        assert(isec && near(isec.normal, Vec2d(0, 1)) && near(isec.delta.abs(), 0.5));
+        assert(intersect(Circled(100, 0.5, 1), ray));
+        assert(!intersect(Circled(100, 0.5, 1), seg));
+        assert(!intersect(Circled(-5, 0, 1), ray));
+        isec = intersect(Circled(-0.5, 0.5, 1), ray);
+        assert(isec && near(isec.normal, Vec2d(-1, 1).normalized()));
+
+        // Crossing at a small angle is resolved along the line's normal
+        const Capsuled cross(Point2d(40, -1), Point2d(60, 1), 0.1);
+        isec = intersect(cross, line);
+        assert(isec && near(fabs(isec.normal.y), 1) && near(isec.delta.abs(), 1.1));
+        assert(!intersect(cross, seg));
+
+        const Capsuled cap(Point2d(5, 5), Point2d(5, 7), 1);
+        assert(near(distance(cap, ray), 4));
+        assert(near(distance(cap, Line2d(Point2d(0, 0), Vec2d(-1, 0), Ray)), sqrt(50.0) - 1));
+        assert(near(distance(cap, seg), Vec2d(4, 5).abs() - 1));
+
+        isec = sweep(Circled(100, 5, 1), Vec2d(0, -10), line);
+        assert(isec && near(isec.near, 0.4) && near(isec.normal, Vec2d(0, 1)));
+        assert(!sweep(Circled(100, 5, 1), Vec2d(0, -10), seg));
+
+        const Capsuled left(Point2d(-5, 3), Point2d(-3, 3), 0.5);
+        assert(!sweep(left, Vec2d(0, -10), ray));
+        isec = sweep(left, Vec2d(0, -10), Line2d(Point2d(0, 0), Vec2d(-1, 0), Ray));
+        assert(isec && near(isec.near, 0.25) && near(isec.normal, Vec2d(0, 1)));
+    }
+
+    // Random sweeps against convex polygons touch them exactly at the
+    // entry time and not before.
+    {
+        srand(7);
+        int hits = 0;
+        for (int i = 0; i < 500; ++i)
+        {
+            PolygonT pol;
+            const Point2d center(frand(-5, 5), frand(-5, 5));
+            const double r = frand(0.5, 3), start = frand(0, 6.283);
+            const size_t n = 3 + rand() % 6;
+            for (size_t k = 0; k < n; ++k)
+                pol.add(center + Vec2d(r * cos(start + 6.283185307 * k / n), r * sin(start + 6.283185307 * k / n)));
+
+            const Capsuled cap(Point2d(frand(-15, -8), frand(-5, 5)), Point2d(frand(-15, -8), frand(-5, 5)), frand(0.1, 1));
+            const Circled circle(cap.a, cap.radius);
+            const Vec2d vel(frand(10, 30), frand(-10, 10));
+
+            auto isec = sweep(cap, vel, pol);
+            if (isec && isec.near > 0)
+            {
+                ++hits;
+                const Vec2d at = vel * isec.near;
+                assert(distance(Capsuled(cap.a + at, cap.b + at, cap.radius), pol) < 1e-7);
+                const Vec2d before = vel * (isec.near - 1e-6);
+                assert(distance(Capsuled(cap.a + before, cap.b + before, cap.radius), pol) > 0);
+            }
+            else if (!isec)
+                for (int k = 0; k <= 20; ++k)
+                {
+                    const Vec2d at = vel * (k / 20.0);
+                    assert(distance(Capsuled(cap.a + at, cap.b + at, cap.radius), pol) > 0);
+                }
+
+            isec = sweep(circle, vel, pol);
+            if (isec && isec.near > 0)
+            {
+                const Circled moved(circle.center + vel * isec.near, circle.radius);
+                assert(distance(moved, pol) < 1e-7);
+                assert(!intersect(Circled(circle.center + vel * (isec.near - 1e-6), circle.radius), pol));
+            }
+        }
+        assert(hits > 50);
+    }
+
+    cout << "OK" << endl;
+    return 0;
+}
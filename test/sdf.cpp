@@ -0,0 +1,93 @@
+#include "math/geometry/SignedDistanceField.hpp"
+#include "math/geometry/OffsetPolygon.hpp"
+#include <cassert>
+#include <iostream>
+
+using namespace math;
+using namespace std;
+
+// Exact distance to the square [20, 60]^2
+static double squareDistance(const Point2d& p)
+{
+    double dx = std::max(20 - p.x, p.x - 60),
+           dy = std::max(20 - p.y, p.y - 60);
+    if (dx <= 0 && dy <= 0)
+        return std::max(dx, dy);
+    return Vec2d(std::max(dx, 0.0), std::max(dy, 0.0)).abs();
+}
+
+int main(int argc, char *argv[])
+{
+    OffsetPolygon<float> square;
+    square.add(Point2f(20, 20));
+    square.add(Point2f(60, 20));
+    square.add(Point2f(60, 60));
+    square.add(Point2f(20, 60));
+
+    OffsetPolygon<float> wall;
+    wall.setFillType(Open);
+    wall.add(Point2f(80, 10));
+    wall.add(Point2f(80, 90));
+
+    SignedDistanceField<float> sdf(AABBf(0, 0, 100, 100), 1);
+    sdf.bake({ &square }, 4);
+
+    double maxerr = 0;
+    for (int y = 0; y < 100; y += 3)
+        for (int x = 0; x < 100; x += 3)
+        {
+            Point2f p(x + 0.5f, y + 0.5f);
+            double err = std::abs(sdf.sample(p) - squareDistance(p));
+            maxerr = std::max(maxerr, err);
+        }
+    cout<<"max error: "<<maxerr<<endl;
+    assert(maxerr < 1.0);
+
+    // Near the surface, distances are exact
+    assert(std::abs(sdf.sample(Point2f(18.5, 40.5)) - 1.5) < 1e-4);
+    assert(std::abs(sdf.sample(Point2f(21.5, 40.5)) + 1.5) < 1e-4);
+
+    // Gradient points away from the nearest wall
+    Vec2f n = sdf.gradient(Point2f(10.5, 40.5));
+    assert(n.almostEquals(Vec2f(-1, 0)));
+    n = sdf.gradient(Point2f(40.5, 70.5));
+    assert(n.almostEquals(Vec2f(0, 1)));
+
+    Point2f cp = sdf.closestPoint(Point2f(10.5, 40.5));
+    assert(std::abs(cp.x - 20) < 1 && std::abs(cp.y - 40.5) < 1e-3);
+
+    // Open polygons are unsigned walls
+    sdf.bake({ &square, &wall });
+    assert(std::abs(sdf.sample(Point2f(81.5, 50.5)) - 1.5) < 1e-4);
+    assert(std::abs(sdf.sample(Point2f(78.5, 50.5)) - 1.5) < 1e-4);
+    assert(std::abs(sdf.sample(Point2f(40.5, 40.5)) + 19.5) < 1.0);
+
+    // Within the band, distances to a polygon with many edges, including
+    // horizontal ones and edges outside the area, are exact
+    OffsetPolygon<float> star;
+    star.setFillType(Open);
+    for (int i = 0; i < 40; ++i)
+        star.add(Point2f(50, 50) + Vec2f::fromAngle(i % 2 ? 20 : 60, i * 9));
+    star.add(Point2f(-10, 3));
+    star.add(Point2f(110, 3));
+    sdf.bake({ &star }, 3);
+    for (int y = 0; y < 100; ++y)
+        for (int x = 0; x < 100; ++x)
+        {
+            const Point2f p(x + 0.5f, y + 0.5f);
+            double d = 1e30;
+            star.foreachSegment([&](const Line2f& seg) {
+                d = std::min(d, (double)seg.distance(p));
+                return false;
+            });
+            if (d <= 2)
+                assert(std::abs(sdf.getGrid().at(x, y) - d) < 1e-3);
+        }
+
+    // Without walls, there is no gradient or closest point
+    sdf.bake({});
+    assert(sdf.gradient(Point2f(10, 10)) == Vec2f());
+    assert(sdf.closestPoint(Point2f(10, 10)) == Point2f(10, 10));
+
+    return 0;
+}
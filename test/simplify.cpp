@@ -0,0 +1,106 @@
+#include "math/geometry/simplify.hpp"
+#include "math/geometry/LODPolygon.hpp"
+#include <cassert>
+#include <iostream>
+
+using namespace math;
+using namespace std;
+
+int main(int argc, char *argv[])
+{
+    // Noisy line: all inner points should be removed
+    PointSet<float> line, out;
+    for (int i = 0; i <= 100; ++i)
+        line.add(Point2f(i, (i % 2) * 0.1f));
+
+    simplifyDouglasPeucker(line, &out, 0.5);
+    assert(out.size() == 2 && out.get(0) == line.get(0) && out.get(1) == line.get(100));
+
+    simplifyVisvalingam(line, &out, 10.0);
+    assert(out.size() == 2 && out.get(0) == line.get(0) && out.get(1) == line.get(100));
+
+    // Densely sampled square
+    PointSet<float> square;
+    Point2f corners[] = { Point2f(0, 0), Point2f(10, 0), Point2f(10, 10), Point2f(0, 10) };
+    for (int c = 0; c < 4; ++c)
+        for (int i = 0; i < 10; ++i)
+            square.add(corners[c] + (corners[(c + 1) % 4] - corners[c]) * (i / 10.f));
+
+    simplifyDouglasPeucker(square, &out, 0.01, true);
+    cout<<"douglas-peucker square: "<<out.size()<<endl;
+    assert(out.size() == 4);
+
+    simplifyVisvalingam(square, &out, 0.01, 0, true);
+    cout<<"visvalingam square: "<<out.size()<<endl;
+    assert(out.size() == 4);
+
+    // Vertex budget
+    PointSet<float> circle;
+    for (int i = 0; i < 360; ++i)
+        circle.add(Point2f(0, 0) + Vec2f::fromAngle(10, i));
+
+    simplifyVisvalingam(circle, &out, 0.0, 16, true);
+    assert(out.size() == 16);
+    simplifyVisvalingam(circle, &out, 0.0, 1, true);
+    assert(out.size() == 3 && "Closed polygons keep at least 3 vertices");
+
+    // Vertex budget keeps the end points of open polylines and the inner
+    // points removed last
+    {
+        PointSet<float> line, res;
+        const Point2f pts[] = { Point2f(0, 0), Point2f(1, 0), Point2f(2, 0), Point2f(3, 0), Point2f(4, 1), Point2f(5, 0) };
+        for (auto& p : pts)
+            line.add(p);
+
+        simplifyVisvalingam(line, &res, 0.0, 3);
+        assert(res.size() == 3);
+        assert(res.get(0) == Point2f(0, 0));
+        assert(res.get(1) == Point2f(3, 0));
+        assert(res.get(2) == Point2f(5, 0));
+
+        simplifyVisvalingam(line, &res, 0.0, 1);
+        assert(res.size() == 2 && "Open polylines keep their end points");
+        assert(res.get(0) == Point2f(0, 0) && res.get(1) == Point2f(5, 0));
+    }
+
+    // LOD levels
+    LODPolygon<float> lod({ 0.01, 1.0, 100.0 });
+    for (size_t i = 0; i < circle.size(); ++i)
+        lod.add(circle.get(i));
+
+    assert(lod.getLevelCount() == 4);
+    size_t prev = lod.size();
+    for (size_t i = 1; i < lod.getLevelCount(); ++i)
+    {
+        assert(lod.getLevel(i).size() <= prev);
+        prev = lod.getLevel(i).size();
+    }
+    assert(prev >= 3);
+
+    assert(&lod.getLevel(10) == &lod.getLevel(3));
+    LODPolygon<float> nolevels;
+    nolevels.add(Point2f(0, 0));
+    assert(nolevels.getLevelCount() == 1);
+    assert(&nolevels.getLevel(1) == &nolevels);
+
+    // Moving keeps levels in sync
+    lod.move(Vec2f(5, 5));
+    const AbstractPolygon<float>& level = lod.getLevel(1);
+    assert(intersect(Point2f(5, 5), level));
+    assert(!intersect(Point2f(-6, 5), level));
+    for (size_t i = 0; i < level.size(); ++i)
+        assert(std::abs((level.get(i) - Point2f(5, 5)).abs() - 10) < 1e-3);
+
+    lod.setFillType(Open);
+    assert(lod.getLevel(2).getFillType() == Open);
+    lod.setFillType(Filled);
+
+    // Editing invalidates the levels
+    lod.clear();
+    lod.add(Point2f(0, 0));
+    lod.add(Point2f(1, 0));
+    lod.add(Point2f(0, 1));
+    assert(lod.getLevel(3).size() == 3);
+
+    return 0;
+}
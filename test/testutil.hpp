@@ -0,0 +1,46 @@
+#ifndef CPPMATH_TEST_UTIL_HPP
+#define CPPMATH_TEST_UTIL_HPP
+
+#include <cstdlib>
+#include "math/geometry/PointSet.hpp"
+
+// Helpers shared by the tests
+
+// Returns a random number in [min, max].
+inline double frand(double min, double max)
+{
+    return min + (max - min) * (std::rand() / (double)RAND_MAX);
+}
+
+// Adds the corners of a box, counter-clockwise in a y-up system.
+template <typename T>
+void makeBox(math::AbstractPointSet<T>* pol, double x, double y, double w, double h)
+{
+    pol->add(math::Point2<T>(x, y));
+    pol->add(math::Point2<T>(x + w, y));
+    pol->add(math::Point2<T>(x + w, y + h));
+    pol->add(math::Point2<T>(x, y + h));
+}
+
+template <typename T>
+void makeBox(math::AbstractPointSet<T>* pol, const math::AABB<T>& box)
+{
+    makeBox(pol, box.x, box.y, box.w, box.h);
+}
+
+// Returns the signed area, positive for counter-clockwise polygons in a
+// y-up system.
+template <typename T>
+double area(const math::AbstractPointSet<T>& pol)
+{
+    double a = 0;
+    for (size_t i = 0; i < pol.size(); ++i)
+    {
+        const math::Point2d p = pol.get(i),
+                            q = pol.get((i + 1) % pol.size());
+        a += p.x * q.y - q.x * p.y;
+    }
+    return a / 2;
+}
+
+#endif
@@ -0,0 +1,74 @@
+#include "math/geometry/tilecollision.hpp"
+#include <cassert>
+#include <iostream>
+
+using namespace math;
+using namespace std;
+
+int main(int argc, char *argv[])
+{
+    // Floor at row 8 and a wall at column 12
+    Grid<bool> tiles(16, 10);
+    for (int x = 0; x < 16; ++x)
+        tiles.at(x, 8) = tiles.at(x, 9) = true;
+    for (int y = 0; y < 8; ++y)
+        tiles.at(12, y) = true;
+
+    const Vec2f cs(16, 16);
+    Point2i tile;
+
+    // Falling onto the floor
+    AABBf box(20, 80, 10, 20);
+    auto isec = sweep(box, Vec2f(0, 100), tiles, cs, &tile);
+    assert(isec && isec.type == SweptAABBxAABB);
+    assert(isec.normal == Vec2f(0, -1));
+    assert(std::abs(box.y + 100 * isec.time + box.h - 128) < 1e-3);
+    assert(tile.y == 8);
+
+    // Sliding along the floor must not snag on internal tile edges
+    box = AABBf(20, 108, 10, 20);
+    isec = sweep(box, Vec2f(100, 0), tiles, cs);
+    assert(!isec && "Snagged on an internal edge");
+
+    // Sliding with gravity only collides with the floor at t = 0
+    isec = sweep(box, Vec2f(100, 1), tiles, cs);
+    assert(isec && isec.time == 0 && isec.normal == Vec2f(0, -1));
+
+    // Running into the wall
+    box = AABBf(150, 100, 10, 20);
+    isec = sweep(box, Vec2f(100, 0), tiles, cs, &tile);
+    assert(isec && isec.normal == Vec2f(-1, 0));
+    assert(std::abs(box.x + 100 * isec.time + box.w - 192) < 1e-3);
+    assert(tile.x == 12);
+
+    // Moving away or standing still doesn't collide
+    assert(!sweep(box, Vec2f(-100, 0), tiles, cs));
+    assert(!sweep(box, Vec2f(0, 0), tiles, cs));
+
+    // Embedded movers are pushed out the shortest way, even when moving
+    // deeper or standing still
+    box = AABBf(20, 112, 10, 20);
+    isec = sweep(box, Vec2f(0, 50), tiles, cs, &tile);
+    assert(isec && isec.time == 0 && isec.normal == Vec2f(0, -1));
+    assert(tile.y == 8);
+    assert(sweep(box, Vec2f(0, 0), tiles, cs).normal == Vec2f(0, -1));
+
+    box = AABBf(188, 40, 10, 20);
+    isec = sweep(box, Vec2f(100, 0), tiles, cs, &tile);
+    assert(isec && isec.time == 0 && isec.normal == Vec2f(-1, 0));
+    assert(tile.x == 12);
+
+    // Long sweeps only visit tiles along the path
+    Grid<bool> large(4096, 4096);
+    large.at(4000, 4000) = true;
+    box = AABBf(8, 8, 10, 10);
+    isec = sweep(box, Vec2f(4000 * 16, 4000 * 16), large, cs, &tile);
+    assert(isec && tile == Point2i(4000, 4000));
+    assert(!sweep(box, Vec2f(4000 * 16, 3000 * 16), large, cs));
+
+        // Out of bounds is empty
+    box = AABBf(-100, -100, 10, 10);
+    assert(!sweep(box, Vec2f(50, 50), tiles, cs));
+
+    return 0;
+}
@@ -0,0 +1,152 @@
+#include "math/geometry/toi.hpp"
+#include "math/geometry/intersect.hpp"
+#include "math/geometry/OffsetPolygon.hpp"
+#include "testutil.hpp"
+#include <cassert>
+#include <cstdlib>
+#include <cmath>
+#include <iostream>
+
+using namespace math;
+using namespace std;
+
+typedef OffsetPolygon<double> PolygonT;
+
+static void makeConvex(PolygonT* pol, const Point2d& center, double r, size_t n)
+{
+    const double start = frand(0, 6.283);
+    for (size_t i = 0; i < n; ++i)
+    {
+        const double angle = start + 6.283185307 * i / n;
+        pol->add(center + Vec2d(r * cos(angle), r * sin(angle)));
+    }
+}
+
+// Brute force distance between non-overlapping polygons
+static double bruteDistance(const PolygonT& a, const PolygonT& b)
+{
+    double d = 1e30;
+    for (size_t i = 0; i < a.size(); ++i)
+        for (size_t j = 0; j < b.size(); ++j)
+        {
+            d = std::min(d, b.getSegment(j, (j + 1) % b.size()).distance(a.get(i)));
+            d = std::min(d, a.getSegment(i, (i + 1) % a.size()).distance(b.get(j)));
+        }
+    return d;
+}
+
+int main()
+{
+    // GJK distance
+    {
+        PolygonT a, b;
+        makeBox(&a, 0, 0, 2, 2);
+        makeBox(&b, 5, 0, 2, 2);
+
+        Point2d pa, pb;
+        assert(fabs(distance(a, b, &pa, &pb) - 3) < 1e-9);
+        assert(fabs(pa.x - 2) < 1e-9 && fabs(pb.x - 5) < 1e-9);
+        assert(fabs(pa.y - pb.y) < 1e-9);
+
+        b.setOffset(Vec2d(-2, 3));      // Corner to corner
+        assert(fabs(distance(a, b, &pa, &pb) - sqrt(2.0)) < 1e-9);
+        assert((pa - Point2d(2, 2)).abs() < 1e-9 && (pb - Point2d(3, 3)).abs() < 1e-9);
+
+        b.setOffset(Vec2d(-4, 0));      // Overlapping
+        assert(distance(a, b) == 0);
+
+        b.setOffset(Vec2d(-3, 0));      // Touching
+        assert(distance(a, b) < 1e-12);
+
+        srand(11);
+        for (int i = 0; i < 200; ++i)
+        {
+            PolygonT p, q;
+            makeConvex(&p, Point2d(frand(0, 10), frand(0, 10)), frand(0.5, 2), 3 + rand() % 8);
+            makeConvex(&q, Point2d(frand(0, 10), frand(0, 10)), frand(0.5, 2), 3 + rand() % 8);
+            const double d = distance(p, q, &pa, &pb);
+            if (d > 0)
+            {
+                assert(fabs(d - bruteDistance(p, q)) < 1e-7);
+                assert(fabs((pb - pa).abs() - d) < 1e-7);
+            }
+        }
+    }
+
+    // Translation only matches the AABB sweep
+    {
+        PolygonT a, b;
+        makeBox(&a, 0, 0, 1, 1);
+        makeBox(&b, 10, 0.5, 1, 1);
+        double time;
+        assert(timeOfImpact(a, RigidMotion<double>(Vec2d(20, 0)), b, RigidMotion<double>(), &time, 1e-6));
+        const auto isec = sweep(a.getBBox(), Vec2d(20, 0), b.getBBox());
+        assert(fabs(time - isec.near) < 1e-6);
+        assert(time <= isec.near);
+
+        assert(!timeOfImpact(a, RigidMotion<double>(Vec2d(5, 0)), b, RigidMotion<double>(), &time));
+        assert(!timeOfImpact(a, RigidMotion<double>(Vec2d(-20, 0)), b, RigidMotion<double>(), &time));
+    }
+
+    // A rotating blade hits a thin wall, although it is clear of it at the
+    // start and end of the step.
+    {
+        PolygonT blade, wall;
+        makeBox(&blade, -5, -0.1, 10, 0.2);
+        makeBox(&wall, 2, 3, 0.05, 7);
+
+        const RigidMotion<double> spin(Vec2d(), M_PI, Point2d(0, 0));
+        assert(distance(blade, wall) > 0);
+
+        double time;
+        assert(timeOfImpact(blade, spin, wall, RigidMotion<double>(), &time, 1e-4));
+        assert(time > 0.25 && time < 0.32);
+
+        // Just before the impact they are still apart
+        PolygonT moved;
+        for (size_t i = 0; i < blade.size(); ++i)
+            moved.add(spin.transform(blade.get(i), time));
+        const double d = distance(moved, wall);
+        assert(d > 0 && d <= 1e-4);
+
+        moved.clear();
+        for (size_t i = 0; i < blade.size(); ++i)
+            moved.add(spin.transform(blade.get(i), 1));
+        assert(distance(moved, wall) > 0);
+    }
+
+    // Spinning and moving against each other
+    {
+        PolygonT a, b;
+        makeBox(&a, -1, -1, 2, 2);
+        makeBox(&b, 5, -1, 2, 2);
+        double time;
+        assert(timeOfImpact(a, RigidMotion<double>(Vec2d(4, 0), 1, Point2d(0, 0)),
+                            b, RigidMotion<double>(Vec2d(-4, 0), -2, Point2d(6, 0)), &time));
+        assert(time > 0 && time < 0.5);      // Earlier than without spinning
+    }
+
+    // The default tolerance doesn't depend on the distance to the origin
+    {
+        PolygonT a, b;
+        makeBox(&a, 1000, 0, 1, 1);
+        makeBox(&b, 1002.5, 0, 1, 1);
+        double time;
+        assert(!timeOfImpact(a, RigidMotion<double>(Vec2d(-1, 0)), b, RigidMotion<double>(Vec2d(1, 0)), &time));
+        assert(timeOfImpact(a, RigidMotion<double>(Vec2d(2, 0)), b, RigidMotion<double>(), &time));
+        assert(time > 0.74 && time <= 0.75);
+    }
+
+    // Running out of iterations is not an impact
+    {
+        PolygonT blade, wall;
+        makeBox(&blade, -5, -0.1, 10, 0.2);
+        makeBox(&wall, 2, 3, 0.05, 7);
+        double time;
+        assert(!timeOfImpact(blade, RigidMotion<double>(Vec2d(), M_PI), wall, RigidMotion<double>(), &time, 1e-4, 2));
+        assert(time > 0 && time < 0.28);
+    }
+
+    cout << "OK" << endl;
+    return 0;
+}
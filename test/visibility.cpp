@@ -0,0 +1,86 @@
+#include "math/geometry/visibility.hpp"
+#include "math/geometry/OffsetPolygon.hpp"
+#include <cassert>
+#include <iostream>
+
+using namespace math;
+using namespace std;
+
+int main(int argc, char *argv[])
+{
+    // Room with a pillar
+    OffsetPolygon<double> room;
+    room.setFillType(Closed);
+    room.add(Point2d(0, 0));
+    room.add(Point2d(100, 0));
+    room.add(Point2d(100, 100));
+    room.add(Point2d(0, 100));
+
+    OffsetPolygon<double> pillar;
+    pillar.add(Point2d(40, 40));
+    pillar.add(Point2d(60, 40));
+    pillar.add(Point2d(60, 60));
+    pillar.add(Point2d(40, 60));
+
+    vector<const AbstractPolygon<double>*> polygons = { &room, &pillar };
+    OffsetPolygon<double> vis;
+    visibilityPolygon(Point2d(10, 50), polygons, &vis);
+
+    for (size_t i = 0; i < vis.size(); ++i)
+        cout<<"vertex "<<i<<": "<<vis.get(i)<<endl;
+
+    assert(vis.size() == 8);
+    assert(intersect(Point2d(5, 5), vis));
+    assert(intersect(Point2d(90, 5), vis));
+    assert(intersect(Point2d(90, 95), vis));
+    assert(intersect(Point2d(30, 50), vis));
+    assert(!intersect(Point2d(50, 50), vis) && "Inside the pillar");
+    assert(!intersect(Point2d(80, 50), vis) && "Behind the pillar");
+    assert(!intersect(Point2d(99, 55), vis) && "Behind the pillar");
+
+    // Every vertex lies on the room or the pillar
+    for (size_t i = 0; i < vis.size(); ++i)
+    {
+        auto p = vis.get(i);
+        bool onroom = false, onpillar = false;
+        room.foreachSegment([&](const Line2d& seg) { return onroom = onroom || seg.distance(p) < 1e-6; });
+        pillar.foreachSegment([&](const Line2d& seg) { return onpillar = onpillar || seg.distance(p) < 1e-6; });
+        assert(onroom || onpillar);
+    }
+
+    // Radius cutoff
+    visibilityPolygon(Point2d(10, 50), polygons, &vis, 20.0);
+    assert(intersect(Point2d(22, 62), vis));
+    assert(!intersect(Point2d(25, 65), vis) && "Outside the circle");
+    assert(!intersect(Point2d(35, 50), vis) && "Out of range");
+    for (size_t i = 0; i < vis.size(); ++i)
+        assert((vis.get(i) - Point2d(10, 50)).abs() <= 20 + 1e-9);
+
+    // Plain segments, unbounded
+    vector<Line2d> segments = { Line2d(Point2d(-1, 1), Point2d(1, 1)) };
+    visibilityPolygon(Point2d(0, 0), segments, &vis);
+    assert(intersect(Point2d(0, -1), vis));
+    assert(intersect(Point2d(0, 0.5), vis));
+    assert(!intersect(Point2d(0, 1.5), vis));
+    assert(intersect(Point2d(1.8, 1.5), vis));
+
+    // Crossing segments
+    segments = {
+        Line2d(Point2d(-2, 1), Point2d(2, 3)),
+        Line2d(Point2d(-2, 3), Point2d(2, 1))
+    };
+    visibilityPolygon(Point2d(0, 0), segments, &vis);
+    assert(intersect(Point2d(0, 1.5), vis));
+    assert(intersect(Point2d(1.5, 1), vis));
+    assert(intersect(Point2d(-1.5, 1), vis));
+    assert(!intersect(Point2d(0, 2.5), vis));
+    assert(!intersect(Point2d(1.5, 2), vis));
+    assert(!intersect(Point2d(-1.5, 2), vis));
+
+    bool crossing = false;
+    for (size_t i = 0; i < vis.size(); ++i)
+        crossing = crossing || (vis.get(i) - Point2d(0, 2)).abs() < 1e-9;
+    assert(crossing);
+
+    return 0;
+}
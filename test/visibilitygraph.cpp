@@ -0,0 +1,135 @@
+#include "math/geometry/VisibilityGraph.hpp"
+#include "math/geometry/OffsetPolygon.hpp"
+#include "testutil.hpp"
+#include <cassert>
+#include <cstdlib>
+#include <cmath>
+#include <iostream>
+
+using namespace math;
+using namespace std;
+
+typedef OffsetPolygon<float> PolygonT;
+
+// Strictly inside
+static bool inside(const PolygonT& pol, const Point2f& p)
+{
+    bool in = false;
+    for (size_t i = 0, j = pol.size() - 1; i < pol.size(); j = i++)
+    {
+        const Point2f a = pol.get(j), b = pol.get(i);
+        if (fabs((b - a).cross(p - a)) < 1e-4 && (p - a).dot(b - a) >= 0 && (p - b).dot(a - b) >= 0)
+            return false;
+        if ((a.y > p.y) != (b.y > p.y) && p.x < a.x + (p.y - a.y) * (b.x - a.x) / (b.y - a.y))
+            in = !in;
+    }
+    return in;
+}
+
+static void checkPath(const vector<PolygonT>& obstacles, const VisibilityGraph<float>& graph,
+                      const vector<Point2f>& path, float length)
+{
+    double sum = 0;
+    for (size_t i = 1; i < path.size(); ++i)
+    {
+        assert(graph.isVisible(path[i - 1], path[i]));
+        sum += (path[i] - path[i - 1]).abs();
+        for (int k = 1; k < 16; ++k)
+        {
+            const Point2f p = path[i - 1] + (path[i] - path[i - 1]) * (k / 16.f);
+            for (auto& pol : obstacles)
+                assert(!inside(pol, p));
+        }
+    }
+    assert(fabs(sum - length) < 1e-2);
+}
+
+int main()
+{
+    // Single box, either way around
+    {
+        PolygonT box;
+        makeBox(&box, 0, 0, 10, 10);
+        vector<const AbstractPolygon<float>*> obstacles(1, &box);
+        VisibilityGraph<float> graph(obstacles);
+
+        assert(graph.getNodeCount() == 4);
+        assert(graph.getEdgeCount() == 4);
+        assert(graph.isVisible(Point2f(0, 0), Point2f(10, 0)));
+        assert(!graph.isVisible(Point2f(0, 0), Point2f(10, 10)));
+        assert(!graph.isVisible(Point2f(-5, 5), Point2f(15, 5)));
+        assert(graph.isVisible(Point2f(-5, 0), Point2f(15, 0)));
+        assert(!graph.isVisible(Point2f(5, 0), Point2f(5, 20)));
+        assert(graph.isBlocked(Point2f(5, 5)));
+        assert(!graph.isBlocked(Point2f(10, 5)));
+
+        vector<Point2f> path;
+        float length;
+        assert(graph.findPath(Point2f(-5, 5), Point2f(15, 5), &path, &length));
+        assert(path.size() == 4);
+        assert(fabs(length - (10 + 2 * sqrt(50.f))) < 1e-4);
+
+        assert(graph.findPath(Point2f(-5, 0), Point2f(15, 0), &path, &length));
+        assert(path.size() == 2);
+        assert(fabs(length - 20) < 1e-5);
+
+        assert(!graph.findPath(Point2f(5, 5), Point2f(15, 0), &path, &length));
+        assert(path.empty());
+    }
+
+    // Random boxes
+    {
+        srand(1);
+        vector<PolygonT> boxes(40);
+        vector<const AbstractPolygon<float>*> obstacles;
+        for (auto& box : boxes)
+        {
+            makeBox(&box, rand() % 100, rand() % 100, 2 + rand() % 10, 2 + rand() % 10);
+            obstacles.push_back(&box);
+        }
+
+        VisibilityGraph<float> serial(obstacles, 1), graph(obstacles, 4);
+        assert(serial.getNodeCount() == graph.getNodeCount());
+        assert(serial.getEdgeCount() == graph.getEdgeCount());
+
+        vector<Point2f> path;
+        float length;
+        size_t found = 0;
+        for (int i = 0; i < 50; ++i)
+        {
+            const Point2f a(rand() % 120 - 10, rand() % 120 - 10),
+                          b(rand() % 120 - 10, rand() % 120 - 10);
+            if (graph.isBlocked(a) || graph.isBlocked(b))
+                continue;
+            // The graph is connected, since the boxes can be walked around
+            assert(graph.findPath(a, b, &path, &length));
+            assert(length >= (b - a).abs() - 1e-3);
+            checkPath(boxes, graph, path, length);
+            ++found;
+        }
+        assert(found > 0);
+
+        // Move boxes and compare with a fresh build
+        for (int i = 0; i < 40; ++i)
+        {
+            const size_t j = rand() % boxes.size();
+            boxes[j].setOffset(Vec2f(rand() % 40 - 20, rand() % 40 - 20));
+            graph.update(j, 2);
+
+            VisibilityGraph<float> fresh(obstacles);
+            assert(fresh.getNodeCount() == graph.getNodeCount());
+            assert(fresh.getEdgeCount() == graph.getEdgeCount());
+
+            const Point2f a(-20, -20), b(140, 140);
+            float l1, l2;
+            vector<Point2f> path2;
+            assert(graph.findPath(a, b, &path, &l1));
+            assert(fresh.findPath(a, b, &path2, &l2));
+            assert(fabs(l1 - l2) < 1e-3);
+            checkPath(boxes, graph, path, l1);
+        }
+    }
+
+    cout << "OK" << endl;
+    return 0;
+}
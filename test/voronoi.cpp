@@ -0,0 +1,106 @@
+#include "math/geometry/Voronoi.hpp"
+#include "testutil.hpp"
+#include <cassert>
+#include <cstdlib>
+#include <cmath>
+#include <iostream>
+
+using namespace math;
+using namespace std;
+
+// Inside test for a convex cell wound counter-clockwise in a y-up system
+static bool contains(const AbstractPointSet<float>& cell, const Point2f& p, float eps)
+{
+    for (size_t i = 0; i < cell.size(); ++i)
+    {
+        Point2f a = cell.get(i), b = cell.get((i + 1) % cell.size());
+        if ((b - a).cross(p - a) < -eps * (b - a).abs())
+            return false;
+    }
+    return cell.size() > 0;
+}
+
+int main(int argc, char *argv[])
+{
+    srand(1337);
+
+    const AABBf bounds(0, 0, 1000, 1000);
+
+    PointSet<float> sites;
+    for (int i = 0; i < 2000; ++i)
+        sites.add(Point2f(rand() % 10000 / 10.f, rand() % 10000 / 10.f));
+    sites.add(sites.get(5));
+
+    Voronoi<float> vor(sites, bounds, 4);
+    assert(vor.size() == sites.size());
+
+    // Cells tile the bounding box
+    double total = 0;
+    for (size_t i = 0; i < vor.size() - 1; ++i)
+    {
+        assert(area(vor.getCell(i)) >= 0);
+        total += area(vor.getCell(i));
+    }
+    assert(std::abs(total - 1000.0 * 1000.0) < 1.0);
+
+    // Coincident sites share the same cell
+    assert(vor.getCell(vor.size() - 1).size() == vor.getCell(5).size());
+    // and map to the lowest index
+    assert(vor.findNearest(sites.get(5)) == 5);
+    assert(vor.findNearest(sites.get(vor.size() - 1) + Vec2f(0.1f, 0)) == 5);
+
+    for (int i = 0; i < 500; ++i)
+    {
+        Point2f p(rand() % 10000 / 10.f, rand() % 10000 / 10.f);
+
+        size_t best = 0;
+        float bestdist = (sites.get(0) - p).abs_sqr();
+        for (size_t j = 1; j < sites.size(); ++j)
+        {
+            float d = (sites.get(j) - p).abs_sqr();
+            if (d < bestdist)
+            {
+                best = j;
+                bestdist = d;
+            }
+        }
+
+        float dist;
+        size_t nearest = vor.findNearest(p, &dist);
+        assert(dist == bestdist);
+        assert(contains(vor.getCell(nearest), p, 1e-2f));
+        assert(contains(vor.getCell(best), p, 1e-2f));
+    }
+
+    // A single site owns the whole box
+    PointSet<float> single;
+    single.add(Point2f(10, 10));
+    vor.build(single, bounds);
+    assert(std::abs(area(vor.getCell(0)) - 1000.0 * 1000.0) < 1e-3);
+
+    // Collinear sites give parallel strips
+    PointSet<float> line;
+    for (int i = 0; i < 10; ++i)
+        line.add(Point2f(950 - i * 100, 500));
+    vor.build(line, bounds);
+    for (size_t i = 0; i < line.size(); ++i)
+    {
+        assert(std::abs(area(vor.getCell(i)) - 100.0 * 1000.0) < 1e-3);
+        assert(contains(vor.getCell(i), line.get(i), 0));
+    }
+
+    // Sites outside the box have empty cells
+    PointSet<float> outside;
+    outside.add(Point2f(500, 500));
+    outside.add(Point2f(5000, 500));
+    vor.build(outside, bounds);
+    assert(vor.getCell(1).size() == 0);
+    assert(std::abs(area(vor.getCell(0)) - 1000.0 * 1000.0) < 1e-3);
+
+    vor.clear();
+    assert(vor.size() == 0);
+    assert(vor.findNearest(Point2f()) == (size_t)-1);
+
+    cout << "OK" << endl;
+    return 0;
+}